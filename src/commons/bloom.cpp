@@ -153,3 +153,74 @@ void CBloomFilter::Clear() {
     isFull  = false;
     isEmpty = true;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// class CRollingBloomFilter
+
+CRollingBloomFilter::CRollingBloomFilter(uint32_t nElements, double nFPRate) {
+    double logFPRate = log(nFPRate);
+    // the optimal number of hash functions is log(fpRate) / log(0.5), restricted to 1-50
+    nHashFuncs = max(1, min((int32_t)round(logFPRate / log(0.5)), (int32_t)MAX_HASH_FUNCS));
+    // between 2 and 3 generations of nElements / 2 entries are kept
+    nEntriesPerGeneration = (nElements + 1) / 2;
+    uint32_t nMaxElements = nEntriesPerGeneration * 3;
+    // fpRate = pow(1 - exp(-nHashFuncs * nMaxElements / nFilterBits), nHashFuncs), solved for nFilterBits
+    uint32_t nFilterBits =
+        (uint32_t)ceil(-1.0 * nHashFuncs * nMaxElements / log(1.0 - exp(logFPRate / nHashFuncs)));
+    data.resize(((nFilterBits + 63) / 64) << 1);
+    reset();
+}
+
+uint32_t CRollingBloomFilter::Hash(uint32_t nHashNum, const uint256& hash) const {
+    return MurmurHash3(nHashNum * 0xFBA4C795 + nTweak, hash.begin(), hash.size());
+}
+
+// x % n for a uniformly distributed 32 bits x, without the division
+static inline uint32_t FastMod(uint32_t x, size_t n) { return ((uint64_t)x * (uint64_t)n) >> 32; }
+
+void CRollingBloomFilter::insert(const uint256& hash) {
+    if (nEntriesThisGeneration == nEntriesPerGeneration) {
+        nEntriesThisGeneration = 0;
+        nGeneration++;
+        if (nGeneration == 4)
+            nGeneration = 1;
+
+        // wipe the old entries of the generation number
+        uint64_t nGenerationMask1 = 0 - (uint64_t)(nGeneration & 1);
+        uint64_t nGenerationMask2 = 0 - (uint64_t)(nGeneration >> 1);
+        for (uint32_t p = 0; p < data.size(); p += 2) {
+            uint64_t p1 = data[p], p2 = data[p + 1];
+            uint64_t mask = (p1 ^ nGenerationMask1) | (p2 ^ nGenerationMask2);
+            data[p]       = p1 & mask;
+            data[p + 1]   = p2 & mask;
+        }
+    }
+    nEntriesThisGeneration++;
+
+    for (uint32_t n = 0; n < nHashFuncs; n++) {
+        uint32_t h = Hash(n, hash);
+        int32_t bit = h & 0x3F;
+        // FastMod uses the upper bits of h, the lower ones are the bit
+        uint32_t pos  = FastMod(h, data.size());
+        data[pos & ~1U] = (data[pos & ~1U] & ~(uint64_t(1) << bit)) | (uint64_t(nGeneration & 1) << bit);
+        data[pos | 1]   = (data[pos | 1] & ~(uint64_t(1) << bit)) | (uint64_t(nGeneration >> 1) << bit);
+    }
+}
+
+bool CRollingBloomFilter::contains(const uint256& hash) const {
+    for (uint32_t n = 0; n < nHashFuncs; n++) {
+        uint32_t h = Hash(n, hash);
+        int32_t bit = h & 0x3F;
+        uint32_t pos = FastMod(h, data.size());
+        if (!(((data[pos & ~1U] | data[pos | 1]) >> bit) & 1))
+            return false;
+    }
+    return true;
+}
+
+void CRollingBloomFilter::reset() {
+    nTweak                 = (uint32_t)GetRand(numeric_limits<uint32_t>::max());
+    nEntriesThisGeneration = 0;
+    nGeneration            = 1;
+    fill(data.begin(), data.end(), 0);
+}
@@ -86,4 +86,35 @@ public:
     void Clear();
 };
 
+/**
+ * RollingBloomFilter is a probabilistic "keep track of most recently inserted" set.
+ * Construct it with the number of items to keep track of, and a false-positive rate.
+ *
+ * contains(item) will always return true if item was one of the last N things
+ * insert()'ed, and may return true for older items at the false-positive rate.
+ *
+ * The items are kept in three generations of N/2 items each, the oldest generation
+ * is wiped when a new one starts, so it never needs to be cleared by its owner.
+ */
+class CRollingBloomFilter {
+public:
+    CRollingBloomFilter(uint32_t nElements, double nFPRate);
+
+    void insert(const uint256& hash);
+    bool contains(const uint256& hash) const;
+
+    void reset();
+
+private:
+    uint32_t nEntriesPerGeneration;
+    uint32_t nEntriesThisGeneration;
+    uint32_t nGeneration;
+    // 2 bits per position, in the bits of data[2 * i] and data[2 * i + 1], 0 is unset, 1-3 the generation
+    vector<uint64_t> data;
+    uint32_t nTweak;
+    uint32_t nHashFuncs;
+
+    uint32_t Hash(uint32_t nHashNum, const uint256& hash) const;
+};
+
 #endif /* COIN_BLOOM_H */
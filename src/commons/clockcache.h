@@ -0,0 +1,141 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef COIN_CLOCKCACHE_H
+#define COIN_CLOCKCACHE_H
+
+#include <stddef.h>
+
+#include <map>
+#include <vector>
+
+/**
+ * STL-like cache bounded by the total usage of its entries, the usage of each entry is given by
+ * the caller. Entries are evicted by the CLOCK algorithm, an approximation of LRU: the hand sweeps
+ * the slots, gives the entries referenced since the last sweep a second chance and evicts the rest.
+ * IndexMap maps the key to the slot, std::map or openhashmap.
+ */
+template <typename K, typename V, typename IndexMap = std::map<K, size_t>>
+class clockcache {
+private:
+    struct Entry {
+        K key;
+        V value;
+        size_t usage    = 0;
+        bool referenced = false;
+        bool used       = false;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<size_t> freeSlots;
+    IndexMap index;
+    size_t hand      = 0;
+    size_t nUsage    = 0;
+    size_t nMaxUsage = 0;
+
+public:
+    explicit clockcache(size_t maxUsageIn = 0) : nMaxUsage(maxUsageIn) {}
+
+    size_t size() const { return index.size(); }
+    bool empty() const { return index.empty(); }
+    size_t usage() const { return nUsage; }
+    size_t max_usage() const { return nMaxUsage; }
+
+    void set_max_usage(size_t maxUsageIn) {
+        nMaxUsage = maxUsageIn;
+        Evict(0);
+    }
+
+    // return nullptr if not found, the pointer is valid until the next insert or erase
+    const V* find(const K& key) {
+        auto it = index.find(key);
+        if (it == index.end())
+            return nullptr;
+
+        Entry& entry     = entries[it->second];
+        entry.referenced = true;
+        return &entry.value;
+    }
+
+    // insert or replace the entry, the entry larger than the max usage is not cached
+    void insert(const K& key, const V& value, size_t entryUsage) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            Entry& entry     = entries[it->second];
+            nUsage           = nUsage - entry.usage + entryUsage;
+            entry.value      = value;
+            entry.usage      = entryUsage;
+            entry.referenced = true;
+            Evict(0);
+            return;
+        }
+
+        if (entryUsage > nMaxUsage)
+            return;
+        Evict(entryUsage);
+
+        size_t pos;
+        if (!freeSlots.empty()) {
+            pos = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            pos = entries.size();
+            entries.emplace_back();
+        }
+        Entry& entry     = entries[pos];
+        entry.key        = key;
+        entry.value      = value;
+        entry.usage      = entryUsage;
+        entry.referenced = false;
+        entry.used       = true;
+        index.emplace(key, pos);
+        nUsage += entryUsage;
+    }
+
+    bool erase(const K& key) {
+        auto it = index.find(key);
+        if (it == index.end())
+            return false;
+
+        size_t pos = it->second;
+        index.erase(key);
+        Release(pos);
+        return true;
+    }
+
+    void clear() {
+        entries.clear();
+        freeSlots.clear();
+        index.clear();
+        hand   = 0;
+        nUsage = 0;
+    }
+
+private:
+    void Release(size_t pos) {
+        nUsage -= entries[pos].usage;
+        entries[pos] = Entry();
+        freeSlots.push_back(pos);
+    }
+
+    void Evict(size_t entryUsage) {
+        while (nUsage + entryUsage > nMaxUsage && !index.empty()) {
+            if (hand >= entries.size())
+                hand = 0;
+
+            Entry& entry = entries[hand];
+            if (entry.used) {
+                if (entry.referenced) {
+                    entry.referenced = false;  // second chance
+                } else {
+                    index.erase(entry.key);
+                    Release(hand);
+                }
+            }
+            ++hand;
+        }
+    }
+};
+
+#endif  // COIN_CLOCKCACHE_H
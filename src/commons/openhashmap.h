@@ -0,0 +1,214 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef COIN_OPENHASHMAP_H
+#define COIN_OPENHASHMAP_H
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/**
+ * STL-like unordered map using open addressing with linear probing.
+ * All the entries live in one flat array, so point lookups touch one or two cache lines
+ * instead of walking a red-black tree. Erasing uses backward shift, no tombstones.
+ * NOTE: any insert may rehash and invalidate all iterators and references.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>>
+class openhashmap {
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<K, V> value_type;
+    typedef size_t size_type;
+
+private:
+    static const size_t MIN_CAPACITY = 8;
+    static const size_t EMPTY_HASH   = 0;
+
+    std::vector<size_t> hashes;     // EMPTY_HASH marks an empty slot
+    std::vector<value_type> slots;
+    size_type nCount = 0;
+    Hash hasher;
+
+    template <typename MapPtr, typename Value>
+    class iterator_base {
+        friend class openhashmap;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Value value_type;
+        typedef ptrdiff_t difference_type;
+        typedef Value* pointer;
+        typedef Value& reference;
+
+        iterator_base() : pMap(nullptr), pos(0) {}
+        // iterator -> const_iterator
+        template <typename M, typename W>
+        iterator_base(const iterator_base<M, W>& other) : pMap(other.pMap), pos(other.pos) {}
+
+        reference operator*() const { return pMap->slots[pos]; }
+        pointer operator->() const { return &pMap->slots[pos]; }
+
+        iterator_base& operator++() {
+            pos = pMap->NextUsed(pos + 1);
+            return *this;
+        }
+        iterator_base operator++(int) {
+            iterator_base ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        template <typename M, typename W>
+        bool operator==(const iterator_base<M, W>& other) const { return pos == other.pos; }
+        template <typename M, typename W>
+        bool operator!=(const iterator_base<M, W>& other) const { return pos != other.pos; }
+
+    private:
+        template <typename M, typename W> friend class iterator_base;
+
+        iterator_base(MapPtr pMapIn, size_t posIn) : pMap(pMapIn), pos(posIn) {}
+
+        MapPtr pMap;
+        size_t pos;
+    };
+
+public:
+    typedef iterator_base<openhashmap*, value_type> iterator;
+    typedef iterator_base<const openhashmap*, const value_type> const_iterator;
+
+    openhashmap() {}
+
+    iterator begin() { return iterator(this, NextUsed(0)); }
+    iterator end() { return iterator(this, slots.size()); }
+    const_iterator begin() const { return const_iterator(this, NextUsed(0)); }
+    const_iterator end() const { return const_iterator(this, slots.size()); }
+
+    size_type size() const { return nCount; }
+    bool empty() const { return nCount == 0; }
+    size_type bucket_count() const { return slots.size(); }
+
+    void clear() {
+        hashes.clear();
+        slots.clear();
+        nCount = 0;
+    }
+
+    void reserve(size_type n) {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity * 3 < n * 4) // keep the load factor under 3/4
+            capacity <<= 1;
+        if (capacity > slots.size())
+            Rehash(capacity);
+    }
+
+    iterator find(const key_type& key) { return iterator(this, Find(key, HashOf(key))); }
+    const_iterator find(const key_type& key) const { return const_iterator(this, Find(key, HashOf(key))); }
+    size_type count(const key_type& key) const { return find(key) != end() ? 1 : 0; }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(const key_type& key, Args&&... args) {
+        size_t hash = HashOf(key);
+        size_t pos  = Find(key, hash);
+        if (pos != slots.size())
+            return std::make_pair(iterator(this, pos), false);
+
+        if ((nCount + 1) * 4 > slots.size() * 3)
+            Rehash(slots.empty() ? MIN_CAPACITY : slots.size() << 1);
+
+        pos         = FreeSlot(hash);
+        hashes[pos] = hash;
+        slots[pos]  = value_type(key, V(std::forward<Args>(args)...));
+        ++nCount;
+        return std::make_pair(iterator(this, pos), true);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return emplace(value.first, value.second); }
+
+    mapped_type& operator[](const key_type& key) { return emplace(key).first->second; }
+
+    size_type erase(const key_type& key) {
+        size_t pos = Find(key, HashOf(key));
+        if (pos == slots.size())
+            return 0;
+        EraseAt(pos);
+        return 1;
+    }
+
+    void erase(iterator it) { EraseAt(it.pos); }
+
+private:
+    size_t Mask() const { return slots.size() - 1; }
+
+    size_t HashOf(const key_type& key) const {
+        size_t hash = hasher(key);
+        return hash == EMPTY_HASH ? 1 : hash;
+    }
+
+    size_t NextUsed(size_t pos) const {
+        while (pos < hashes.size() && hashes[pos] == EMPTY_HASH)
+            ++pos;
+        return pos;
+    }
+
+    // return slots.size() if not found
+    size_t Find(const key_type& key, size_t hash) const {
+        if (nCount == 0)
+            return slots.size();
+        for (size_t pos = hash & Mask();; pos = (pos + 1) & Mask()) {
+            if (hashes[pos] == EMPTY_HASH)
+                return slots.size();
+            if (hashes[pos] == hash && slots[pos].first == key)
+                return pos;
+        }
+    }
+
+    size_t FreeSlot(size_t hash) const {
+        size_t pos = hash & Mask();
+        while (hashes[pos] != EMPTY_HASH)
+            pos = (pos + 1) & Mask();
+        return pos;
+    }
+
+    void Rehash(size_t capacity) {
+        assert((capacity & (capacity - 1)) == 0);
+        std::vector<size_t> oldHashes(capacity, EMPTY_HASH);
+        std::vector<value_type> oldSlots(capacity);
+        oldHashes.swap(hashes);
+        oldSlots.swap(slots);
+        for (size_t i = 0; i < oldSlots.size(); i++) {
+            if (oldHashes[i] == EMPTY_HASH)
+                continue;
+            size_t pos  = FreeSlot(oldHashes[i]);
+            hashes[pos] = oldHashes[i];
+            slots[pos]  = std::move(oldSlots[i]);
+        }
+    }
+
+    // backward shift deletion (Knuth's Algorithm R): move each following entry of the cluster into
+    // the hole unless its home slot lies cyclically in (hole, entry]
+    void EraseAt(size_t pos) {
+        assert(pos < slots.size() && hashes[pos] != EMPTY_HASH);
+        size_t hole = pos;
+        for (size_t i = (pos + 1) & Mask(); hashes[i] != EMPTY_HASH; i = (i + 1) & Mask()) {
+            size_t home = hashes[i] & Mask();
+            bool inRange = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+            if (inRange)
+                continue;
+            hashes[hole] = hashes[i];
+            slots[hole]  = std::move(slots[i]);
+            hole         = i;
+        }
+        hashes[hole] = EMPTY_HASH;
+        slots[hole]  = value_type();
+        --nCount;
+    }
+};
+
+#endif  // COIN_OPENHASHMAP_H
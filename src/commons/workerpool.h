@@ -0,0 +1,95 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef COIN_WORKERPOOL_H
+#define COIN_WORKERPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "commons/util/util.h"
+
+/**
+ * Worker threads kept over the job sets. The thread running a job set takes jobs as well, so a pool
+ * of n workers runs n + 1 jobs at the same time. The job sets of concurrent callers run one by one.
+ */
+class CWorkerPool {
+public:
+    CWorkerPool(uint32_t workers, const std::string &threadNameIn) : threadName(threadNameIn) {
+        for (uint32_t i = 0; i < workers; i++)
+            threads.emplace_back(&CWorkerPool::WorkerLoop, this);
+    }
+
+    ~CWorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cond.notify_all();
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    uint32_t GetWorkerCount() const { return threads.size(); }
+
+    // run job(0) ... job(count - 1), return when all of them are done, the job must not throw
+    void Run(size_t count, const std::function<void(size_t)> &job) {
+        std::lock_guard<std::mutex> runLock(runMutex);
+        std::unique_lock<std::mutex> lock(mutex);
+        pJob      = &job;
+        jobCount  = count;
+        nextJob   = 0;
+        doneCount = 0;
+        cond.notify_all();
+
+        while (nextJob < jobCount)
+            RunJob(lock);
+
+        doneCond.wait(lock, [&]() { return doneCount == jobCount; });
+        pJob = nullptr;
+    }
+
+private:
+    void RunJob(std::unique_lock<std::mutex> &lock) {
+        size_t index = nextJob++;
+        const std::function<void(size_t)> &job = *pJob;
+        lock.unlock();
+        job(index);
+        lock.lock();
+        if (++doneCount == jobCount)
+            doneCond.notify_all();
+    }
+
+    void WorkerLoop() {
+        RenameThread(threadName.c_str());
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cond.wait(lock, [&]() { return stopping || (pJob != nullptr && nextJob < jobCount); });
+            if (stopping)
+                return;
+            RunJob(lock);
+        }
+    }
+
+    std::string threadName;
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::condition_variable doneCond;
+    const std::function<void(size_t)> *pJob = nullptr;
+    size_t jobCount  = 0;
+    size_t nextJob   = 0;
+    size_t doneCount = 0;
+    bool stopping    = false;
+    std::vector<std::thread> threads;
+};
+
+#endif  // COIN_WORKERPOOL_H
@@ -431,7 +431,11 @@ CBaseParams::CBaseParams() {
     fReindex                = false;
     fBenchmark              = false;
     fTxIndex                = false;
+    fAddrIndex              = false;
     fLogFailures            = false;
+    wasmTraceLevel          = DEFAULT_WASM_TRACE_LEVEL;
+    nParTxExecThreads       = DEFAULT_PAR_TX_EXEC_THREADS;
+    nParSigVerifyThreads    = 1;
     nTxCacheHeight          = 500;
     nTimeBestReceived       = 0;
     nCacheSize              = 300 << 10;  // 300K bytes
@@ -65,8 +65,12 @@ protected:
     mutable bool fReindex;
     mutable bool fBenchmark;
     mutable bool fTxIndex;
+    mutable bool fAddrIndex;
     mutable bool fLogFailures;
     mutable bool fGenReceipt;
+    mutable WasmTraceLevel wasmTraceLevel;
+    mutable uint32_t nParTxExecThreads;
+    mutable uint32_t nParSigVerifyThreads;
     mutable int64_t nTimeBestReceived;
     mutable uint32_t nCacheSize;
     mutable int32_t nTxCacheHeight;
@@ -100,6 +104,7 @@ public:
         te += strprintf("fReindex:%d\n",                            fReindex);
         te += strprintf("fBenchmark:%d\n",                          fBenchmark);
         te += strprintf("fTxIndex:%d\n",                            fTxIndex);
+        te += strprintf("fAddrIndex:%d\n",                          fAddrIndex);
         te += strprintf("fLogFailures:%d\n",                        fLogFailures);
         te += strprintf("nTimeBestReceived:%llu\n",                 nTimeBestReceived);
         te += strprintf("nBlockIntervalPreStableCoinRelease:%u\n",  nBlockIntervalPreStableCoinRelease);
@@ -153,8 +158,12 @@ public:
     bool IsReindex() const { return fReindex; }
     bool IsBenchmark() const { return fBenchmark; }
     bool IsTxIndex() const { return fTxIndex; }
+    bool IsAddrIndex() const { return fAddrIndex; }
     bool IsLogFailures() const { return fLogFailures; };
     bool IsGenReceipt() const { return fGenReceipt; };
+    WasmTraceLevel GetWasmTraceLevel() const { return wasmTraceLevel; }
+    uint32_t GetParTxExecThreads() const { return nParTxExecThreads; }
+    uint32_t GetParSigVerifyThreads() const { return nParSigVerifyThreads; }
     int64_t GetBestRecvTime() const { return nTimeBestReceived; }
     uint32_t GetCacheSize() const { return nCacheSize; }
     int32_t GetTxCacheHeight() const { return nTxCacheHeight; }
@@ -162,8 +171,12 @@ public:
     void SetReIndex(bool flag) const { fReindex = flag; }
     void SetBenchMark(bool flag) const { fBenchmark = flag; }
     void SetTxIndex(bool flag) const { fTxIndex = flag; }
+    void SetAddrIndex(bool flag) const { fAddrIndex = flag; }
     void SetLogFailures(bool flag) const { fLogFailures = flag; }
     void SetGenReceipt(bool flag) const { fGenReceipt = flag; }
+    void SetWasmTraceLevel(WasmTraceLevel level) const { wasmTraceLevel = level; }
+    void SetParTxExecThreads(uint32_t threads) const { nParTxExecThreads = threads; }
+    void SetParSigVerifyThreads(uint32_t threads) const { nParSigVerifyThreads = threads; }
     void SetBestRecvTime(int64_t nTime) const { nTimeBestReceived = nTime; }
     int32_t GetMaxForkHeight(int32_t currBlockHeight) const;
     const MessageStartChars& MessageStart() const { return pchMessageStart; }
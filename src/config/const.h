@@ -128,6 +128,26 @@ static const int64_t DEFAULT_DB_CACHE = 100;
 static const int64_t MAX_DB_CACHE = sizeof(void *) > 4 ? 4096 : 1024;
 /** min. -dbcache in (MiB) */
 static const int64_t MIN_DB_CACHE = 4;
+/** -statecache default (MiB) */
+static const int64_t DEFAULT_STATE_CACHE = 64;
+
+/** -wasmtrace, what is kept of the wasm tx traces served by gettxtrace */
+enum WasmTraceLevel : uint8_t {
+    WASM_TRACE_NONE    = 0,  // no trace is stored and no console output is captured
+    WASM_TRACE_SUMMARY = 1,  // the action traces without the console output
+    WASM_TRACE_FULL    = 2,  // the action traces with the console output
+};
+static const WasmTraceLevel DEFAULT_WASM_TRACE_LEVEL = WASM_TRACE_SUMMARY;
+/** -partxexec default, the threads executing the txs of a block speculatively, 0 = serial execution */
+static const int32_t DEFAULT_PAR_TX_EXEC_THREADS = 0;
+/** max. -partxexec */
+static const int32_t MAX_PAR_TX_EXEC_THREADS = 16;
+/** -parsigverify default, the threads verifying the signatures of a block, 0 = one per core */
+static const int32_t DEFAULT_PAR_SIG_VERIFY_THREADS = 0;
+/** max. -parsigverify */
+static const int32_t MAX_PAR_SIG_VERIFY_THREADS = 16;
+/** the blocks indexed at once by the -addrindex catch-up, between the releases of cs_main */
+static const uint32_t ADDR_INDEX_CATCHUP_BATCH_SIZE = 100;
 
 /** Coinbase transaction outputs can only be spent after this number of new blocks (network rule) */
 static const int32_t BLOCK_REWARD_MATURITY = 100;
@@ -5,19 +5,34 @@
 
 #include "hash.h"
 
+bool Hash_InitSanityCheck() {
+    // sha256d("abc"), through one, two and three parts and the hash writer
+    static const string data = "abc";
+    static const uint256 expected =
+        uint256S("58636c3ec08c12d55aedda056d602d5bcca72d8df6a69b519b72d32dc2428b4f");
+
+    CHashWriter ss(SER_GETHASH, 0);
+    ss.write(data.data(), data.size());
+    return Hash(data.begin(), data.end()) == expected &&
+           Hash(data.begin(), data.begin() + 1, data.begin() + 1, data.end()) == expected &&
+           Hash(data.begin(), data.begin() + 1, data.begin() + 1, data.begin() + 2, data.begin() + 2, data.end()) ==
+               expected &&
+           ss.GetHash() == expected;
+}
+
 inline uint32_t ROTL32(uint32_t x, int8_t r) { return (x << r) | (x >> (32 - r)); }
 
-uint32_t MurmurHash3(uint32_t nHashSeed, const vector<uint8_t> &vDataToHash) {
+uint32_t MurmurHash3(uint32_t nHashSeed, const uint8_t *pData, size_t size) {
     // The following is MurmurHash3 (x86_32), see http://code.google.com/p/smhasher/source/browse/trunk/MurmurHash3.cpp
     uint32_t h1       = nHashSeed;
     const uint32_t c1 = 0xcc9e2d51;
     const uint32_t c2 = 0x1b873593;
 
-    const int32_t nblocks = vDataToHash.size() / 4;
+    const int32_t nblocks = size / 4;
 
     //----------
     // body
-    const uint32_t *blocks = (const uint32_t *)(&vDataToHash[0] + nblocks * 4);
+    const uint32_t *blocks = (const uint32_t *)(pData + nblocks * 4);
 
     for (int32_t i = -nblocks; i; i++) {
         uint32_t k1 = blocks[i];
@@ -33,11 +48,11 @@ uint32_t MurmurHash3(uint32_t nHashSeed, const vector<uint8_t> &vDataToHash) {
 
     //----------
     // tail
-    const uint8_t *tail = (const uint8_t *)(&vDataToHash[0] + nblocks * 4);
+    const uint8_t *tail = (const uint8_t *)(pData + nblocks * 4);
 
     uint32_t k1 = 0;
 
-    switch (vDataToHash.size() & 3) {
+    switch (size & 3) {
         case 3:
             k1 ^= tail[2] << 16;  // Falls through
         case 2:
@@ -52,7 +67,7 @@ uint32_t MurmurHash3(uint32_t nHashSeed, const vector<uint8_t> &vDataToHash) {
 
     //----------
     // finalization
-    h1 ^= vDataToHash.size();
+    h1 ^= size;
     h1 ^= h1 >> 16;
     h1 *= 0x85ebca6b;
     h1 ^= h1 >> 13;
@@ -62,6 +77,10 @@ uint32_t MurmurHash3(uint32_t nHashSeed, const vector<uint8_t> &vDataToHash) {
     return h1;
 }
 
+uint32_t MurmurHash3(uint32_t nHashSeed, const vector<uint8_t> &vDataToHash) {
+    return MurmurHash3(nHashSeed, vDataToHash.data(), vDataToHash.size());
+}
+
 int32_t HMAC_SHA512_Init(HMAC_SHA512_CTX *pctx, const void *pkey, size_t len) {
     uint8_t key[128];
     if (len <= 128) {
@@ -10,6 +10,7 @@
 #include "commons/uint256.h"
 #include "commons/util/util.h"
 #include "config/version.h"
+#include "crypto/sha256.h"
 
 #include <openssl/ripemd.h>
 #include <openssl/sha.h>
@@ -18,40 +19,42 @@
 
 using namespace std;
 
+// sha256d, through the backend selected by SHA256AutoDetect() at startup
 template <typename T1>
 inline uint256 Hash(const T1 pbegin, const T1 pend) {
-    static uint8_t pblank[1];
+    static const uint8_t pblank[1] = {};
     uint256 hash1;
-    SHA256((pbegin == pend ? pblank : (uint8_t *)&pbegin[0]), (pend - pbegin) * sizeof(pbegin[0]),
-           (uint8_t *)&hash1);
+    CSHA256()
+        .Write((pbegin == pend ? pblank : (const uint8_t *)&pbegin[0]), (pend - pbegin) * sizeof(pbegin[0]))
+        .Finalize((uint8_t *)&hash1);
     uint256 hash2;
-    SHA256((uint8_t *)&hash1, sizeof(hash1), (uint8_t *)&hash2);
+    CSHA256().Write((const uint8_t *)&hash1, sizeof(hash1)).Finalize((uint8_t *)&hash2);
     return hash2;
 }
 
 class CHashWriter {
 private:
-    SHA256_CTX ctx;
+    CSHA256 ctx;
 
 public:
     int32_t nType;
     int32_t nVersion;
 
-    void Init() { SHA256_Init(&ctx); }
+    void Init() { ctx.Reset(); }
 
-    CHashWriter(int32_t nTypeIn, int32_t nVersionIn) : nType(nTypeIn), nVersion(nVersionIn) { Init(); }
+    CHashWriter(int32_t nTypeIn, int32_t nVersionIn) : nType(nTypeIn), nVersion(nVersionIn) {}
 
     CHashWriter &write(const char *pch, size_t size) {
-        SHA256_Update(&ctx, pch, size);
+        ctx.Write((const uint8_t *)pch, size);
         return (*this);
     }
 
     // invalidates the object
     uint256 GetHash() {
         uint256 hash1;
-        SHA256_Final((uint8_t *)&hash1, &ctx);
+        ctx.Finalize((uint8_t *)&hash1);
         uint256 hash2;
-        SHA256((uint8_t *)&hash1, sizeof(hash1), (uint8_t *)&hash2);
+        CSHA256().Write((const uint8_t *)&hash1, sizeof(hash1)).Finalize((uint8_t *)&hash2);
         return hash2;
     }
 
@@ -65,36 +68,29 @@ public:
 
 template <typename T1, typename T2>
 inline uint256 Hash(const T1 p1begin, const T1 p1end, const T2 p2begin, const T2 p2end) {
-    static uint8_t pblank[1];
+    static const uint8_t pblank[1] = {};
     uint256 hash1;
-    SHA256_CTX ctx;
-    SHA256_Init(&ctx);
-    SHA256_Update(&ctx, (p1begin == p1end ? pblank : (uint8_t *)&p1begin[0]),
-                  (p1end - p1begin) * sizeof(p1begin[0]));
-    SHA256_Update(&ctx, (p2begin == p2end ? pblank : (uint8_t *)&p2begin[0]),
-                  (p2end - p2begin) * sizeof(p2begin[0]));
-    SHA256_Final((uint8_t *)&hash1, &ctx);
+    CSHA256()
+        .Write((p1begin == p1end ? pblank : (const uint8_t *)&p1begin[0]), (p1end - p1begin) * sizeof(p1begin[0]))
+        .Write((p2begin == p2end ? pblank : (const uint8_t *)&p2begin[0]), (p2end - p2begin) * sizeof(p2begin[0]))
+        .Finalize((uint8_t *)&hash1);
     uint256 hash2;
-    SHA256((uint8_t *)&hash1, sizeof(hash1), (uint8_t *)&hash2);
+    CSHA256().Write((const uint8_t *)&hash1, sizeof(hash1)).Finalize((uint8_t *)&hash2);
     return hash2;
 }
 
 template <typename T1, typename T2, typename T3>
 inline uint256 Hash(const T1 p1begin, const T1 p1end, const T2 p2begin, const T2 p2end, const T3 p3begin,
                     const T3 p3end) {
-    static uint8_t pblank[1];
+    static const uint8_t pblank[1] = {};
     uint256 hash1;
-    SHA256_CTX ctx;
-    SHA256_Init(&ctx);
-    SHA256_Update(&ctx, (p1begin == p1end ? pblank : (uint8_t *)&p1begin[0]),
-                  (p1end - p1begin) * sizeof(p1begin[0]));
-    SHA256_Update(&ctx, (p2begin == p2end ? pblank : (uint8_t *)&p2begin[0]),
-                  (p2end - p2begin) * sizeof(p2begin[0]));
-    SHA256_Update(&ctx, (p3begin == p3end ? pblank : (uint8_t *)&p3begin[0]),
-                  (p3end - p3begin) * sizeof(p3begin[0]));
-    SHA256_Final((uint8_t *)&hash1, &ctx);
+    CSHA256()
+        .Write((p1begin == p1end ? pblank : (const uint8_t *)&p1begin[0]), (p1end - p1begin) * sizeof(p1begin[0]))
+        .Write((p2begin == p2end ? pblank : (const uint8_t *)&p2begin[0]), (p2end - p2begin) * sizeof(p2begin[0]))
+        .Write((p3begin == p3end ? pblank : (const uint8_t *)&p3begin[0]), (p3end - p3begin) * sizeof(p3begin[0]))
+        .Finalize((uint8_t *)&hash1);
     uint256 hash2;
-    SHA256((uint8_t *)&hash1, sizeof(hash1), (uint8_t *)&hash2);
+    CSHA256().Write((const uint8_t *)&hash1, sizeof(hash1)).Finalize((uint8_t *)&hash2);
     return hash2;
 }
 
@@ -107,10 +103,11 @@ uint256 SerializeHash(const T &obj, int32_t nType = SER_GETHASH, int32_t nVersio
 
 template <typename T1>
 inline uint160 Hash160(const T1 pbegin, const T1 pend) {
-    static uint8_t pblank[1];
+    static const uint8_t pblank[1] = {};
     uint256 hash1;
-    SHA256((pbegin == pend ? pblank : (uint8_t *)&pbegin[0]), (pend - pbegin) * sizeof(pbegin[0]),
-           (uint8_t *)&hash1);
+    CSHA256()
+        .Write((pbegin == pend ? pblank : (const uint8_t *)&pbegin[0]), (pend - pbegin) * sizeof(pbegin[0]))
+        .Finalize((uint8_t *)&hash1);
     uint160 hash2;
     RIPEMD160((uint8_t *)&hash1, sizeof(hash1), (uint8_t *)&hash2);
     return hash2;
@@ -118,8 +115,12 @@ inline uint160 Hash160(const T1 pbegin, const T1 pend) {
 
 inline uint160 Hash160(const vector<uint8_t> &vch) { return Hash160(vch.begin(), vch.end()); }
 
+uint32_t MurmurHash3(uint32_t nHashSeed, const uint8_t *pData, size_t size);
 uint32_t MurmurHash3(uint32_t nHashSeed, const vector<uint8_t> &vDataToHash);
 
+// check Hash() and CHashWriter against a known sha256d, with the backend selected by SHA256AutoDetect()
+bool Hash_InitSanityCheck();
+
 typedef struct {
     SHA512_CTX ctxInner;
     SHA512_CTX ctxOuter;
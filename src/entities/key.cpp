@@ -8,7 +8,9 @@
 #include <openssl/ecdsa.h>
 #include <openssl/obj_mac.h>
 #include <openssl/rand.h>
+#include <mutex>
 #include "commons/base58.h"
+#include "commons/clockcache.h"
 #include "commons/common.h"
 #include "commons/random.h"
 #include "crypto/hash.h"
@@ -18,6 +20,9 @@
 static secp256k1_context *secp256k1_context_verify = nullptr;
 static secp256k1_context *secp256k1_context_sign   = nullptr;
 
+// parsed public keys kept by CPubKey::Parse()
+static const size_t PARSED_PUBKEY_CACHE_SIZE = 1024;
+
 // Check that the sig has a low R value and will be less than 71 bytes
 bool SigHasLowR(const secp256k1_ecdsa_signature *sig) {
     uint8_t compact_sig[64];
@@ -192,21 +197,46 @@ CKeyID CPubKey::GetKeyId() const { return CKeyID(Hash160(vch, vch + size())); }
 uint256 CPubKey::GetHash() const { return Hash(vch, vch + size()); }
 
 bool CPubKey::Verify(const uint256 &hash, const vector<uint8_t> &vchSig) const {
-    if (!IsValid())
+    secp256k1_pubkey pubkey;
+    if (!Parse(pubkey))
         return false;
 
-    secp256k1_pubkey pubkey;
-    secp256k1_ecdsa_signature sig;
-    if (!secp256k1_ec_pubkey_parse(secp256k1_context_verify, &pubkey, vch, size())) {
+    return Verify(pubkey, hash, vchSig);
+}
+
+bool CPubKey::Parse(secp256k1_pubkey &parsed) const {
+    if (!IsValid())
         return false;
+
+    // parsing a compressed key computes its y coordinate
+    static std::mutex cacheMutex;
+    static clockcache<CPubKey, secp256k1_pubkey> parsedCache(PARSED_PUBKEY_CACHE_SIZE);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        const secp256k1_pubkey *pCached = parsedCache.find(*this);
+        if (pCached != nullptr) {
+            parsed = *pCached;
+            return true;
+        }
     }
+
+    if (!secp256k1_ec_pubkey_parse(secp256k1_context_verify, &parsed, vch, size()))
+        return false;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    parsedCache.insert(*this, parsed, 1);
+    return true;
+}
+
+bool CPubKey::Verify(const secp256k1_pubkey &parsed, const uint256 &hash, const vector<uint8_t> &vchSig) {
+    secp256k1_ecdsa_signature sig;
     if (!ecdsa_signature_parse_der_lax(secp256k1_context_verify, &sig, vchSig.data(), vchSig.size())) {
         return false;
     }
     /* libsecp256k1's ECDSA verification requires lower-S signatures, which have
      * not historically been enforced in Bitcoin, so normalize them first. */
     secp256k1_ecdsa_signature_normalize(secp256k1_context_verify, &sig, &sig);
-    return secp256k1_ecdsa_verify(secp256k1_context_verify, &sig, hash.begin(), &pubkey);
+    return secp256k1_ecdsa_verify(secp256k1_context_verify, &sig, hash.begin(), &parsed);
 }
 
 bool CPubKey::RecoverCompact(const uint256 &hash, const vector<uint8_t> &vchSig) {
@@ -206,6 +206,13 @@ public:
     // If this public key is not fully valid, the return value will be false.
     bool Verify(const uint256 &hash, const vector<uint8_t> &vchSig) const;
 
+    // Parse this public key once for the verification of many signatures.
+    // The parsed keys of the frequent signers, e.g. the price feeders and the dex operators, are cached.
+    bool Parse(secp256k1_pubkey &parsed) const;
+
+    // Verify a DER signature with a public key parsed by Parse().
+    static bool Verify(const secp256k1_pubkey &parsed, const uint256 &hash, const vector<uint8_t> &vchSig);
+
     // Recover a public key from a compact signature.
     bool RecoverCompact(const uint256 &hash, const vector<uint8_t> &vchSig);
 
@@ -216,6 +223,17 @@ public:
     bool Derive(CPubKey &pubkeyChild, uint8_t ccChild[32], uint32_t nChild, const uint8_t cc[32]) const;
 };
 
+/** A signature to verify in a batch, see VerifySignatures() */
+struct CSignatureCheck {
+    uint256 sigHash;
+    CPubKey pubKey;
+    vector<uint8_t> signature;
+
+    CSignatureCheck() {}
+    CSignatureCheck(const uint256 &sigHashIn, const CPubKey &pubKeyIn, const vector<uint8_t> &signatureIn)
+        : sigHash(sigHashIn), pubKey(pubKeyIn), signature(signatureIn) {}
+};
+
 // secure_allocator is defined in allocators.h
 // CPrivKey is a serialized private key, with all parameters included (279 bytes)
 typedef vector<uint8_t, secure_allocator<uint8_t> > CPrivKey;
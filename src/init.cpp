@@ -21,10 +21,13 @@
 #include "miner/miner.h"
 #include "net.h"
 #include "persistence/blockdb.h"
+#include "persistence/blockfilereader.h"
+#include "persistence/blockprefetcher.h"
 #include "persistence/accountdb.h"
 #include "persistence/txdb.h"
 #include "persistence/contractdb.h"
 #include "tx/tx.h"
+#include "vm/wasm/wasm_interface.hpp"
 #include "commons/util/util.h"
 #include "commons/util/time.h"
 #ifdef USE_UPNP
@@ -45,6 +48,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <thread>
 
 #ifndef WIN32
 #include <signal.h>
@@ -151,6 +155,8 @@ void Shutdown() {
             delete pCdMan;
             pCdMan = nullptr;
         }
+        GetBlockFileReader().CloseAll();
+        GetUndoFileReader().CloseAll();
     }
 
     boost::filesystem::remove(GetPidFile());
@@ -208,18 +214,31 @@ string HelpMessage() {
 #endif
     strUsage += "  -datadir=<dir>         " + _("Specify data directory") + "\n";
     strUsage += "  -dbcache=<n>           " + strprintf(_("Set database cache size in megabytes (%d to %d, default: %d)"), MIN_DB_CACHE, MAX_DB_CACHE, DEFAULT_DB_CACHE) + "\n";
+    strUsage += "  -dbcompression         " + _("Compress leveldb blocks with snappy if available (default: 0)") + "\n";
+    strUsage += "  -dbblocksize=<n>       " + _("Set leveldb block size in bytes (default: 4096)") + "\n";
+    strUsage += "  -dbwritebuffer=<n>     " + _("Set leveldb write buffer size in bytes (default: derived from each db's cache size)") + "\n";
+    strUsage += "  -dbmaxopenfiles=<n>    " + _("Set max open files of each leveldb database (default: 64)") + "\n";
+    strUsage += "  -dbbloombits=<n>       " + _("Set bloom filter bits per key, 0 to disable (default: 10)") + "\n";
+    strUsage += "                         " + _("Each -db<option> above can be set for a single db by -db<option>.<dbname>, e.g. -dbcompression.receipts=1") + "\n";
     strUsage += "  -loadblock=<file>      " + _("Imports blocks from external blk000??.dat file") + " " + _("on startup") + "\n";
     strUsage += "  -pid=<file>            " + _("Specify pid file (default: coin.pid)") + "\n";
     strUsage += "  -reindex               " + _("Rebuild block chain index from current blk000??.dat files") + " " + _("on startup") + "\n";
+    strUsage += "  -statecache=<n>        " + strprintf(_("Keep recently used accounts, cdps and dex operators in memory over the state flushes, in megabytes (default: %d)"), DEFAULT_STATE_CACHE) + "\n";
     strUsage += "  -txindex               " + _("Maintain a full transaction index (default: 0)") + "\n";
+    strUsage += "  -addrindex             " + _("Maintain an index of the transactions by address for listaddrtx, the blocks connected before are indexed in the background (default: 0)") + "\n";
     strUsage += "  -logfailures           " + _("Log failures into level db in detail (default: 0)") + "\n";
     strUsage += "  -genreceipt               " + _("Whether generate receipt(default: 0)") + "\n";
+    strUsage += "  -wasmprecompile        " + _("Compile the deployed wasm contracts in the background on startup (default: 1)") + "\n";
+    strUsage += "  -wasmtrace=<level>     " + _("Wasm tx traces kept for gettxtrace: none, summary or full with the console output (default: summary)") + "\n";
+    strUsage += "  -partxexec=<n>         " + strprintf(_("Execute the transfer and lua contract txs of a block speculatively on <n> threads (0 to %d, default: %d, 0 = serial)"), MAX_PAR_TX_EXEC_THREADS, DEFAULT_PAR_TX_EXEC_THREADS) + "\n";
+    strUsage += "  -parsigverify=<n>      " + strprintf(_("Verify the signatures of a block on <n> threads (0 to %d, default: %d, 0 = one per core)"), MAX_PAR_SIG_VERIFY_THREADS, DEFAULT_PAR_SIG_VERIFY_THREADS) + "\n";
 
     strUsage += "\n" + _("Connection options:") + "\n";
     strUsage += "  -addnode=<ip>          " + _("Add a node to connect to and attempt to keep the connection open") + "\n";
     strUsage += "  -banscore=<n>          " + _("Threshold for disconnecting misbehaving peers (default: 100)") + "\n";
     strUsage += "  -bantime=<n>           " + _("Number of seconds to keep misbehaving peers from reconnecting (default: 86400)") + "\n";
     strUsage += "  -bind=<addr>           " + _("Bind to given address and always listen on it. Use [host]:port notation for IPv6") + "\n";
+    strUsage += "  -cmpctblock            " + _("Ask the peers for the new blocks as compact blocks, rebuilt from the mempool (default: 1)") + "\n";
     strUsage += "  -connect=<ip>          " + _("Connect only to the specified node(s)") + "\n";
     strUsage += "  -discover              " + _("Discover own IP address (default: 1 when listening and no -externalip)") + "\n";
     strUsage += "  -dns                   " + _("Allow DNS lookups for -addnode, -seednode and -connect") + " " + _("(default: 1)") + "\n";
@@ -379,6 +398,34 @@ void ThreadImport(vector<boost::filesystem::path> vImportFiles) {
     }
 }
 
+// compile the deployed wasm contracts, so that their first calls after the restart, including the ones
+// in the blocks being mined, don't pay for it
+void ThreadPrecompileWasm() {
+    RenameThread("coin-wasmjit");
+
+    vector<string> codes;
+    {
+        LOCK(cs_main);
+        map<string, CUniversalContract> contracts;
+        pCdMan->pContractCache->GetContracts(contracts);
+        for (auto &item : contracts) {
+            if (item.second.vm_type == VMType::WASM_VM && !item.second.code.empty())
+                codes.push_back(std::move(item.second.code));
+        }
+    }
+
+    int64_t nStart = GetTimeMillis();
+    uint32_t nCount = 0;
+    wasm::wasm_interface wasmif;
+    wasmif.initialize(wasm::vm_type::eos_vm_jit);
+    for (const auto &code : codes) {
+        boost::this_thread::interruption_point();
+        if (wasmif.precompile(Hash(code.begin(), code.end()), code))
+            ++nCount;
+    }
+    LogPrint(BCLog::INFO, "Precompiled %u of %u wasm contracts (%dms)\n", nCount, codes.size(), GetTimeMillis() - nStart);
+}
+
 /** Initialize Coin.
  *  @pre Parameters should be parsed and config file should be read.
  */
@@ -443,6 +490,11 @@ bool AppInit(boost::thread_group &threadGroup) {
 #endif
 #endif
 
+    // Select the sha256 backend of the cpu before any thread hashes
+    string sha256Algo = SHA256AutoDetect();
+    if (!Hash_InitSanityCheck())
+        return InitError("SHA256 sanity check failure. Aborting.");
+
     if (SysCfg().IsArgCount("-bind")) {
         // when specifying an explicit binding address, you want to listen on it
         // even when -connect or -proxy is specified
@@ -530,6 +582,7 @@ bool AppInit(boost::thread_group &threadGroup) {
 
     LogPrint(BCLog::INFO, "%s version %s (%s)\n", IniCfg().GetCoinName().c_str(), FormatFullVersion().c_str(), CLIENT_DATE);
     LogPrint(BCLog::INFO, "Using OpenSSL version %s\n", SSLeay_version(SSLEAY_VERSION));
+    LogPrint(BCLog::INFO, "Using the '%s' SHA256 implementation\n", sha256Algo);
 #ifdef USE_LUA
     LogPrint(BCLog::INFO, "Using Lua version %s\n", LUA_RELEASE);
 #endif
@@ -663,6 +716,24 @@ bool AppInit(boost::thread_group &threadGroup) {
 
     SysCfg().SetGenReceipt(SysCfg().GetBoolArg("-genreceipt", false));
 
+    string strWasmTrace = SysCfg().GetArg("-wasmtrace", "summary");
+    if (strWasmTrace == "none")
+        SysCfg().SetWasmTraceLevel(WASM_TRACE_NONE);
+    else if (strWasmTrace == "summary")
+        SysCfg().SetWasmTraceLevel(WASM_TRACE_SUMMARY);
+    else if (strWasmTrace == "full")
+        SysCfg().SetWasmTraceLevel(WASM_TRACE_FULL);
+    else
+        return InitError(strprintf(_("Invalid -wasmtrace level: '%s'"), strWasmTrace));
+
+    int64_t nParTxExecThreads = SysCfg().GetArg("-partxexec", DEFAULT_PAR_TX_EXEC_THREADS);
+    SysCfg().SetParTxExecThreads(std::max<int64_t>(0, std::min<int64_t>(nParTxExecThreads, MAX_PAR_TX_EXEC_THREADS)));
+
+    int64_t nParSigVerifyThreads = SysCfg().GetArg("-parsigverify", DEFAULT_PAR_SIG_VERIFY_THREADS);
+    if (nParSigVerifyThreads <= 0)
+        nParSigVerifyThreads = std::thread::hardware_concurrency();
+    SysCfg().SetParSigVerifyThreads(std::max<int64_t>(1, std::min<int64_t>(nParSigVerifyThreads, MAX_PAR_SIG_VERIFY_THREADS)));
+
     filesystem::path blocksDir = GetDataDir() / "blocks";
     if (!filesystem::exists(blocksDir)) {
         filesystem::create_directories(blocksDir);
@@ -716,6 +787,17 @@ bool AppInit(boost::thread_group &threadGroup) {
                     break;
                 }
 
+                // -addrindex can be switched without -reindex, the blocks connected before switching it on
+                // are indexed by ThreadAddrIndexCatchUp
+                bool fAddrIndex = false;
+                pCdMan->pBlockCache->ReadFlag("addrindex", fAddrIndex);
+                if (fAddrIndex != SysCfg().GetBoolArg("-addrindex", false)) {
+                    fAddrIndex = !fAddrIndex;
+                    pCdMan->pBlockCache->WriteFlag("addrindex", fAddrIndex);
+                    pCdMan->pBlockCache->SetAddrIndexCatchUpHeight(fAddrIndex ? chainActive.Height() + 1 : 0);
+                }
+                SysCfg().SetAddrIndex(fAddrIndex);
+
                 if (!VerifyDB(SysCfg().GetArg("-checklevel", 3), SysCfg().GetArg("-checkblocks", 288))) {
                     strLoadError = _("Corrupted block database detected");
                     break;
@@ -760,7 +842,7 @@ bool AppInit(boost::thread_group &threadGroup) {
     if (SysCfg().IsArgCount("-printblock")) {
         string strMatch = SysCfg().GetArg("-printblock", "");
         int32_t nFound      = 0;
-        for (map<uint256, CBlockIndex *>::iterator mi = mapBlockIndex.begin(); mi != mapBlockIndex.end(); ++mi) {
+        for (BlockMap::iterator mi = mapBlockIndex.begin(); mi != mapBlockIndex.end(); ++mi) {
             uint256 hash = (*mi).first;
             if (strncmp(hash.ToString().c_str(), strMatch.c_str(), strMatch.size()) == 0) {
                 CBlockIndex *pIndex = (*mi).second;
@@ -787,15 +869,19 @@ bool AppInit(boost::thread_group &threadGroup) {
     int32_t nCacheHeight     = SysCfg().GetTxCacheHeight();
     int32_t nCount           = 0;
     CBlock block;
-    while (pBlockIndex && nCacheHeight-- > 0) {
-        if (!ReadBlockFromDisk(pBlockIndex, block))
+    {
+        vector<CBlockIndex *> vIndex;
+        for (; pBlockIndex && nCacheHeight-- > 0; pBlockIndex = pBlockIndex->pprev)
+            vIndex.push_back(pBlockIndex);
+
+        CBlockPrefetcher prefetcher(vIndex);
+        while (prefetcher.Next(pBlockIndex, block)) {
+            if (!pCdMan->pTxCache->AddBlockTx(block))
+                return InitError("Failed to add block to transaction memory cache");
+            ++nCount;
+        }
+        if (pBlockIndex != nullptr)
             return InitError("Failed to read block from disk");
-
-        if (!pCdMan->pTxCache->AddBlockTx(block))
-            return InitError("Failed to add block to transaction memory cache");
-
-        pBlockIndex = pBlockIndex->pprev;
-        ++nCount;
     }
     LogPrint(BCLog::INFO, "Added the latest %d blocks to transaction memory cache (%dms)\n", nCount, GetTimeMillis() - nStart);
 
@@ -833,6 +919,12 @@ bool AppInit(boost::thread_group &threadGroup) {
     }
     threadGroup.create_thread(boost::bind(&ThreadImport, vImportFiles));
 
+    if (SysCfg().GetBoolArg("-wasmprecompile", true))
+        threadGroup.create_thread(&ThreadPrecompileWasm);
+
+    if (SysCfg().IsAddrIndex())
+        threadGroup.create_thread(&ThreadAddrIndexCatchUp);
+
 
     nStart = GetTimeMillis();
     {
@@ -26,9 +26,13 @@
 #include "p2p/processmessage.hpp"
 #include "p2p/sendmessage.hpp"
 #include "chain/blockdelegates.h"
+#include "persistence/blockprefetcher.h"
 #include "persistence/blockundo.h"
+#include "commons/workerpool.h"
+#include "tx/txexecutor.h"
 #include "tx/txserializer.h"
 
+#include <fcntl.h>
 #include <sstream>
 #include <algorithm>
 #include <boost/algorithm/string/replace.hpp>
@@ -53,7 +57,8 @@ using namespace boost;
 CCacheDBManager *pCdMan = nullptr;
 CCriticalSection cs_main;
 CTxMemPool mempool;
-map<uint256, CBlockIndex *> mapBlockIndex;
+BlockMap mapBlockIndex;
+CBlockIndexArena blockIndexArena;  // the memory of the indexes of mapBlockIndex
 int32_t nSyncTipHeight = 0;
 string externalIp;
 map<uint256/* blockhash */, std::shared_ptr<CCacheWrapper>> mapForkCache;
@@ -250,6 +255,77 @@ bool VerifySignature(const uint256 &sigHash, const std::vector<uint8_t> &signatu
     return true;
 }
 
+// the verifications of one job of the worker pool, so that its synchronization is cheap next to them
+static const size_t SIG_VERIFY_JOB_SIZE = 16;
+
+// -parsigverify is set on startup, the pool is only replaced by the tests
+static CWorkerPool &GetSigVerifyWorkerPool(uint32_t workers) {
+    static std::unique_ptr<CWorkerPool> spPool;
+    if (spPool == nullptr || spPool->GetWorkerCount() != workers)
+        spPool.reset(new CWorkerPool(workers, "coin-sigverify"));
+    return *spPool;
+}
+
+bool VerifySignatures(const std::vector<CSignatureCheck> &checks, std::vector<bool> &valid) {
+    // the cached signatures are valid, the public keys of the others are parsed once per batch
+    vector<uint8_t> results(checks.size(), 0);
+    vector<pair<size_t, const secp256k1_pubkey *>> pending;
+    map<CPubKey, secp256k1_pubkey> parsedKeys;
+    for (size_t i = 0; i < checks.size(); i++) {
+        const CSignatureCheck &check = checks[i];
+        if (signatureCache.Get(check.sigHash, check.signature, check.pubKey)) {
+            results[i] = true;
+            continue;
+        }
+
+        auto it = parsedKeys.find(check.pubKey);
+        if (it == parsedKeys.end()) {
+            secp256k1_pubkey parsed;
+            if (!check.pubKey.Parse(parsed))
+                continue;
+            it = parsedKeys.emplace(check.pubKey, parsed).first;
+        }
+        pending.emplace_back(i, &it->second);
+    }
+
+    auto verifyJob = [&](size_t job) {
+        size_t end = min(pending.size(), (job + 1) * SIG_VERIFY_JOB_SIZE);
+        for (size_t j = job * SIG_VERIFY_JOB_SIZE; j < end; j++) {
+            const CSignatureCheck &check = checks[pending[j].first];
+            results[pending[j].first]    = CPubKey::Verify(*pending[j].second, check.sigHash, check.signature);
+        }
+    };
+    size_t jobs      = (pending.size() + SIG_VERIFY_JOB_SIZE - 1) / SIG_VERIFY_JOB_SIZE;
+    uint32_t threads = SysCfg().GetParSigVerifyThreads();
+    if (threads <= 1 || jobs <= 1) {
+        for (size_t job = 0; job < jobs; job++)
+            verifyJob(job);
+    } else {
+        GetSigVerifyWorkerPool(threads - 1).Run(jobs, verifyJob);
+    }
+
+    for (const auto &item : pending) {
+        const CSignatureCheck &check = checks[item.first];
+        if (results[item.first])
+            signatureCache.Set(check.sigHash, check.signature, check.pubKey);
+    }
+    valid.assign(results.begin(), results.end());
+    return std::find(results.begin(), results.end(), 0) == results.end();
+}
+
+// Verify the signatures of the txs in one batch ahead of their CheckTx, which finds the valid ones in the
+// signature cache then. The signers are looked up in cw, the txs with an unknown signer are left to CheckTx.
+static void PrevalidateSignatures(const vector<CBaseTx *> &txs, CCacheWrapper &cw) {
+    vector<CSignatureCheck> checks;
+    for (CBaseTx *pBaseTx : txs)
+        pBaseTx->GetSignatureChecks(cw, checks);
+    if (checks.size() <= 1)
+        return;  // nothing to batch, CheckTx verifies it alone
+
+    vector<bool> valid;
+    VerifySignatures(checks, valid);
+}
+
 bool AcceptToMemoryPool(CTxMemPool &pool, CValidationState &state, CBaseTx *pBaseTx,
                         bool fLimitFree, bool fRejectInsaneFee) {
     AssertLockHeld(cs_main);
@@ -279,6 +355,9 @@ bool AcceptToMemoryPool(CTxMemPool &pool, CValidationState &state, CBaseTx *pBas
     uint32_t blockTime = pTip->GetBlockTime();
     uint32_t prevBlockTime = pTip->pprev != nullptr ? pTip->pprev->GetBlockTime() : pTip->GetBlockTime();
 
+    // the multisig and the dex txs with an operator carry several signatures
+    PrevalidateSignatures({pBaseTx}, *spCW);
+
     CTxExecuteContext context(chainActive.Height(), 0, fuelRate, blockTime, prevBlockTime, spCW.get(), &state);
     if (!pBaseTx->CheckTx(context))
         return ERRORMSG("AcceptToMemoryPool() : CheckTx failed, txid: %s", hash.GetHex());
@@ -322,7 +401,7 @@ int32_t CMerkleTx::GetDepthInMainChainINTERNAL(CBlockIndex *&pindexRet) const {
     AssertLockHeld(cs_main);
 
     // Find the block it claims to be in
-    map<uint256, CBlockIndex *>::iterator mi = mapBlockIndex.find(blockHash);
+    BlockMap::iterator mi = mapBlockIndex.find(blockHash);
     if (mi == mapBlockIndex.end())
         return 0;
 
@@ -362,14 +441,9 @@ int32_t GetTxConfirmHeight(const uint256 &hash, CBlockDBCache &blockCache) {
     if (SysCfg().IsTxIndex()) {
         CDiskTxPos diskTxPos;
         if (blockCache.ReadTxIndex(hash, diskTxPos)) {
-            CAutoFile file(OpenBlockFile(diskTxPos, true), SER_DISK, CLIENT_VERSION);
             CBlockHeader header;
-            try {
-                file >> header;
-            } catch (std::exception &e) {
-                ERRORMSG("%s : Deserialize or I/O error - %s", __func__, e.what());
+            if (!ReadBlockHeaderFromDisk(diskTxPos, header))
                 return -1;
-            }
             return header.GetHeight();
         }
     }
@@ -380,6 +454,7 @@ int32_t GetTxConfirmHeight(const uint256 &hash, CBlockDBCache &blockCache) {
 // Return transaction in tx, and if it was found inside a block, its hash is placed in blockHash
 bool GetTransaction(std::shared_ptr<CBaseTx> &pBaseTx, const uint256 &hash, CBlockDBCache &blockCache,
                     bool bSearchMemPool) {
+    CDiskTxPos diskTxPos;
     {
         LOCK(cs_main);
         {
@@ -390,23 +465,13 @@ bool GetTransaction(std::shared_ptr<CBaseTx> &pBaseTx, const uint256 &hash, CBlo
             }
         }
 
-        if (SysCfg().IsTxIndex()) {
-            CDiskTxPos diskTxPos;
-            if (blockCache.ReadTxIndex(hash, diskTxPos)) {
-                CAutoFile file(OpenBlockFile(diskTxPos, true), SER_DISK, CLIENT_VERSION);
-                CBlockHeader header;
-                try {
-                    file >> header;
-                    fseek(file, diskTxPos.nTxOffset, SEEK_CUR);
-                    file >> pBaseTx;
-                } catch (std::exception &e) {
-                    return ERRORMSG("%s : Deserialize or I/O error - %s", __func__, e.what());
-                }
-                return true;
-            }
-        }
+        if (!SysCfg().IsTxIndex() || !blockCache.ReadTxIndex(hash, diskTxPos))
+            return false;
     }
-    return false;
+
+    // the block files are read without cs_main
+    CBlockHeader header;
+    return ReadTxFromDisk(diskTxPos, header, pBaseTx);
 }
 
 uint256 GetOrphanRoot(const uint256 &hash) {
@@ -487,7 +552,7 @@ void CheckForkWarningConditions() {
             string strCmd = SysCfg().GetArg("-alertnotify", "");
             if (!strCmd.empty()) {
                 string warning = string("'Warning: Large-work fork detected, forking after block ") +
-                                 pIndexBestForkBase->pBlockHash->ToString() + string("'");
+                                 pIndexBestForkBase->GetBlockHash().ToString() + string("'");
                 boost::replace_all(strCmd, "%s", warning);
                 boost::thread t(runCommand, strCmd);  // thread runs free
             }
@@ -497,8 +562,8 @@ void CheckForkWarningConditions() {
                      "CheckForkWarningConditions: Warning: Large valid fork found\n"
                      "  forking from height %d (%s)\n"
                      "  lasting to   height %d (%s)\n",
-                     pIndexBestForkBase->height, pIndexBestForkBase->pBlockHash->ToString(),
-                     pIndexBestForkTip->height, pIndexBestForkTip->pBlockHash->ToString());
+                     pIndexBestForkBase->height, pIndexBestForkBase->GetBlockHash().ToString(),
+                     pIndexBestForkTip->height, pIndexBestForkTip->GetBlockHash().ToString());
 
             fLargeWorkForkFound = true;
         } else {
@@ -620,6 +685,7 @@ bool InvalidateBlock(CValidationState &state, CBlockIndex *pIndex) {
     LogPrint(BCLog::INFO, "Invalidate block[%d]: %s BLOCK_FAILED_VALID\n", pIndex->height,
              pIndex->GetBlockHash().ToString());
 
+    std::shared_ptr<CBlock> spTipBlock;
     while (chainActive.Contains(pIndex)) {
         CBlockIndex *pindexWalk = chainActive.Tip();
         pindexWalk->nStatus |= BLOCK_FAILED_CHILD;
@@ -631,7 +697,7 @@ bool InvalidateBlock(CValidationState &state, CBlockIndex *pIndex) {
 
         // ActivateBestChain considers blocks already in chainActive
         // unconditionally valid already, so force disconnect away from it.
-        if (!DisconnectBlockFromTip(state)) {
+        if (!DisconnectBlockFromTip(state, spTipBlock)) {
             return false;
         }
     }
@@ -644,7 +710,7 @@ bool ReconsiderBlock(CValidationState &state, CBlockIndex *pIndex) {
     AssertLockHeld(cs_main);
 
     // Remove the invalidity flag from this block and all its descendants.
-    map<uint256, CBlockIndex *>::const_iterator it = mapBlockIndex.begin();
+    BlockMap::const_iterator it = mapBlockIndex.begin();
     int32_t height                                    = pIndex->height;
     while (it != mapBlockIndex.end()) {
         if (it->second->nStatus & BLOCK_FAILED_MASK && it->second->GetAncestor(height) == pIndex) {
@@ -909,6 +975,70 @@ bool SaveTxIndex(const uint256 &txid, CCacheWrapper &cw, CValidationState &state
     return true;
 }
 
+void WriteAddrTxIndex(const CBlock &block, CCacheWrapper &cw) {
+    for (uint32_t index = 0; index < block.vptx.size(); index++) {
+        const auto &spTx = block.vptx[index];
+        set<CKeyID> keyIds;
+        if (!spTx->GetInvolvedKeyIds(cw, keyIds)) {
+            // the index is optional, it must not reject a block
+            LogPrint(BCLog::ERROR, "WriteAddrTxIndex() : get involved keyids failed, txid=%s\n",
+                     spTx->GetHash().GetHex());
+            continue;
+        }
+
+        for (const auto &keyId : keyIds)
+            cw.blockCache.SetAddrTxIndex(keyId, block.GetHeight(), index, spTx->GetHash());
+    }
+}
+
+void ThreadAddrIndexCatchUp() {
+    RenameThread("coin-addrindex");
+
+    int64_t nStart   = GetTimeMillis();
+    uint32_t nBlocks = 0;
+    while (true) {
+        boost::this_thread::interruption_point();
+
+        int32_t height = 0;
+        vector<CBlockIndex *> vIndex;
+        {
+            LOCK(cs_main);
+            height = pCdMan->pBlockCache->GetAddrIndexCatchUpHeight();
+            for (int32_t h = height - 1; h >= 0 && vIndex.size() < ADDR_INDEX_CATCHUP_BATCH_SIZE; h--) {
+                if (chainActive[h] == nullptr)
+                    break;
+                vIndex.push_back(chainActive[h]);
+            }
+        }
+        if (vIndex.empty())
+            break;
+
+        // the block files are read without cs_main
+        vector<CBlock> blocks(vIndex.size());
+        for (uint32_t i = 0; i < vIndex.size(); i++) {
+            if (!ReadBlockFromDisk(vIndex[i], blocks[i])) {
+                LogPrint(BCLog::ERROR, "ThreadAddrIndexCatchUp() : read block failed, height=%d\n", vIndex[i]->height);
+                return;
+            }
+        }
+
+        LOCK(cs_main);
+        CCacheWrapper cw(pCdMan);
+        for (uint32_t i = 0; i < vIndex.size(); i++) {
+            // a block reorganized meanwhile, the one connected instead is indexed in ConnectBlock
+            if (chainActive.Contains(vIndex[i]))
+                WriteAddrTxIndex(blocks[i], cw);
+        }
+        cw.blockCache.SetAddrIndexCatchUpHeight(height - vIndex.size());
+        cw.blockCache.Flush();
+        nBlocks += vIndex.size();
+    }
+
+    if (nBlocks > 0)
+        LogPrint(BCLog::INFO, "Address indexed %u blocks connected before -addrindex (%dms)\n", nBlocks,
+                 GetTimeMillis() - nStart);
+}
+
 // compute vote staking interest && revoke votes
 static bool ComputeVoteStakingInterestAndRevokeVotes(const int32_t currHeight, const uint32_t currBlockTime,
                                                     CCacheWrapper &cw, CValidationState &state) {
@@ -1079,6 +1209,7 @@ bool ConnectBlock(CBlock &block, CCacheWrapper &cw, CBlockIndex *pIndex, CValida
         uint32_t fuelRate     = block.GetFuelRate();
         uint64_t totalRunStep = 0;
 
+        CParallelTxExecutor txExecutor(block.vptx, cw, blockUndo, SysCfg().GetParTxExecThreads());
         for (int32_t index = 1; index < (int32_t)block.vptx.size(); ++index) {
             std::shared_ptr<CBaseTx> &pBaseTx = block.vptx[index];
             if (cw.txCache.HaveTx((pBaseTx->GetHash())))
@@ -1090,11 +1221,10 @@ bool ConnectBlock(CBlock &block, CCacheWrapper &cw, CBlockIndex *pIndex, CValida
                                  pBaseTx->GetHash().GetHex()), REJECT_INVALID, "tx-invalid-height");
 
             pBaseTx->nFuelRate = fuelRate;
-            CTxUndoOpLogger opLogger(cw, pBaseTx->GetHash(), blockUndo);
 
             uint32_t prevBlockTime = pIndex->pprev != nullptr ? pIndex->pprev->GetBlockTime() : pIndex->GetBlockTime();
             CTxExecuteContext context(pIndex->height, index, fuelRate, pIndex->nTime, prevBlockTime, &cw, &state);
-            if (!pBaseTx->ExecuteTx(context)) {
+            if (!txExecutor.ExecuteTx(context)) {
                 pCdMan->pLogCache->SetExecuteFail(pIndex->height, pBaseTx->GetHash(), state.GetRejectCode(),
                                                   state.GetRejectReason());
                 return state.DoS(100, ERRORMSG("ConnectBlock() : txid=%s execute failed, in detail: %s",
@@ -1122,6 +1252,10 @@ bool ConnectBlock(CBlock &block, CCacheWrapper &cw, CBlockIndex *pIndex, CValida
             LogPrint(BCLog::DEBUG, "total fuel fee:%d, tx fuel fee:%d runStep:%d fuelRate:%d txid:%s\n", totalFuel,
                      fuel, pBaseTx->nRunStep, fuelRate, pBaseTx->GetHash().GetHex());
         }
+
+        if (txExecutor.GetSpeculatedCount() > 0)
+            LogPrint(BCLog::DEBUG, "ConnectBlock() : height=%d, speculated txs=%u, re-executed txs=%u\n",
+                     pIndex->height, txExecutor.GetSpeculatedCount(), txExecutor.GetReexecutedCount());
     }
 
     // Verify total fuel
@@ -1188,6 +1322,10 @@ bool ConnectBlock(CBlock &block, CCacheWrapper &cw, CBlockIndex *pIndex, CValida
             }
         }
 
+        // undone with the tx indexes on disconnecting
+        if (SysCfg().IsAddrIndex())
+            WriteAddrTxIndex(block, cw);
+
         // TODO: move the block delegates undo to block_undo
         if (!chain::ProcessBlockDelegates(block, cw, state)) {
             return state.DoS(100, ERRORMSG("ConnectBlock() : failed to process block delegates! block=%d:%s",
@@ -1229,11 +1367,14 @@ bool ConnectBlock(CBlock &block, CCacheWrapper &cw, CBlockIndex *pIndex, CValida
     // Write undo information to disk
     if (pIndex->GetUndoPos().IsNull() || (pIndex->nStatus & BLOCK_VALID_MASK) < BLOCK_VALID_SCRIPTS) {
         if (pIndex->GetUndoPos().IsNull()) {
+            CDataStream ssUndo(SER_DISK, CLIENT_VERSION);
+            ssUndo << blockUndo;
+
             CDiskBlockPos pos;
-            if (!FindUndoPos(state, pIndex->nFile, pos, ::GetSerializeSize(blockUndo, SER_DISK, CLIENT_VERSION) + 40))
+            if (!FindUndoPos(state, pIndex->nFile, pos, ssUndo.size() + 40))
                 return state.Abort(_("ConnectBlock() : failed to find undo data's position"));
 
-            if (!blockUndo.WriteToDisk(pos, pIndex->pprev->GetBlockHash()))
+            if (!CBlockUndo::WriteToDisk(pos, pIndex->pprev->GetBlockHash(), ssUndo))
                 return state.Abort(_("ConnectBlock() : failed to write undo data"));
 
             // Update nUndoPos in block index
@@ -1366,14 +1507,20 @@ void static UpdateTip(CBlockIndex *pIndexNew, const CBlock &block) {
     }
 }
 
-// Disconnect chainActive's tip.
-bool static DisconnectTip(CValidationState &state) {
+// Disconnect chainActive's tip. spBlock is the block of the tip if it has been read, it is replaced by the
+// block of the new tip, which is read for its median price anyway, so that a reorg reads each block once.
+bool static DisconnectTip(CValidationState &state, std::shared_ptr<CBlock> &spBlock) {
     CBlockIndex *pIndexDelete = chainActive.Tip();
     assert(pIndexDelete);
     // Read block from disk.
-    CBlock block;
-    if (!ReadBlockFromDisk(pIndexDelete, block))
-        return state.Abort(_("Failed to read blocks from disk."));
+    if (spBlock == nullptr || spBlock->GetHash() != pIndexDelete->GetBlockHash()) {
+        spBlock = std::make_shared<CBlock>();
+        if (!ReadBlockFromDisk(pIndexDelete, *spBlock))
+            return state.Abort(_("Failed to read blocks from disk."));
+    }
+    std::shared_ptr<CBlock> spDeleteBlock = spBlock;
+    CBlock &block                         = *spDeleteBlock;
+    spBlock                               = nullptr;
     // Apply the block atomically to the chain state.
     int64_t nStart = GetTimeMicros();
     {
@@ -1387,13 +1534,14 @@ bool static DisconnectTip(CValidationState &state) {
 
         // Attention: need to reset the lastest block price median
         CBlockIndex *pPreBlockIndex = pIndexDelete->pprev;
-        CBlock preBlock;
         if (pPreBlockIndex) {
-            if (!ReadBlockFromDisk(pPreBlockIndex, preBlock))
+            auto spPreBlock = std::make_shared<CBlock>();
+            if (!ReadBlockFromDisk(pPreBlockIndex, *spPreBlock))
                 return ERRORMSG("DisconnectTip() : failed to read block [%d]: %s", pPreBlockIndex->height,
                                 pPreBlockIndex->GetBlockHash().ToString());
 
-            pCdMan->pPpCache->SetLatestBlockMedianPricePoints(preBlock.GetBlockMedianPrice());
+            pCdMan->pPpCache->SetLatestBlockMedianPricePoints(spPreBlock->GetBlockMedianPrice());
+            spBlock = spPreBlock;
         }
     }
     if (SysCfg().IsBenchmark())
@@ -1419,6 +1567,11 @@ bool static DisconnectTip(CValidationState &state) {
     return true;
 }
 
+bool static DisconnectTip(CValidationState &state) {
+    std::shared_ptr<CBlock> spBlock;
+    return DisconnectTip(state, spBlock);
+}
+
 // Connect a new block to chainActive.
 bool static ConnectTip(CValidationState &state, CBlockIndex *pIndexNew) {
     assert(pIndexNew->pprev == chainActive.Tip());
@@ -1583,8 +1736,9 @@ bool ActivateBestChain(CValidationState &state, CBlockIndex* pNewIndex) {
         }
 
         // Disconnect active blocks which are no longer in the best chain.
+        std::shared_ptr<CBlock> spTipBlock;
         while (chainActive.Tip() && !chainMostWork.Contains(chainActive.Tip())) {
-            if (!DisconnectTip(state))
+            if (!DisconnectTip(state, spTipBlock))
                 return false;
 
             if (chainActive.Tip() && chainMostWork.Contains(chainActive.Tip())){
@@ -1635,27 +1789,21 @@ bool AddToBlockIndex(CBlock &block, CValidationState &state, const CDiskBlockPos
         return state.Invalid(ERRORMSG("AddToBlockIndex() : %s already exists", hash.ToString()), 0, "duplicate");
 
     // Construct new block index object
-    CBlockIndex *pIndexNew = new CBlockIndex(block);
-
-    assert(pIndexNew);
+    CBlockIndex *pIndexNew = blockIndexArena.Alloc();
+    *pIndexNew             = CBlockIndex(block);
     {
         LOCK(cs_nBlockSequenceId);
         pIndexNew->nSequenceId = nBlockSequenceId++;
     }
-    map<uint256, CBlockIndex *>::iterator mi = mapBlockIndex.insert(make_pair(hash, pIndexNew)).first;
+    mapBlockIndex.insert(make_pair(hash, pIndexNew));
     // LogPrint(BCLog::INFO, "in map hash:%s map size:%d\n", hash.GetHex(), mapBlockIndex.size());
-    pIndexNew->pBlockHash                        = &((*mi).first);
-    map<uint256, CBlockIndex *>::iterator miPrev = mapBlockIndex.find(block.GetPrevBlockHash());
+    BlockMap::iterator miPrev = mapBlockIndex.find(block.GetPrevBlockHash());
     if (miPrev != mapBlockIndex.end()) {
         pIndexNew->pprev  = (*miPrev).second;
         pIndexNew->height = pIndexNew->pprev->height + 1;
         pIndexNew->BuildSkip();
     }
 
-    if(block.GetHeight() == 0 )
-        pIndexNew->miner = CRegID("0-1");
-    else
-        pIndexNew->miner = block.vptx[0]->txUid.get<CRegID>();
     pIndexNew->nTx        = block.vptx.size();
     pIndexNew->nChainWork = pIndexNew->height;
     pIndexNew->nChainTx   = (pIndexNew->pprev ? pIndexNew->pprev->nChainTx : 0) + pIndexNew->nTx;
@@ -1920,6 +2068,13 @@ bool CheckBlock(const CBlock &block, CValidationState &state, CCacheWrapper &cw,
     // recalculated many times during this block's validation.
     block.BuildMerkleTree();
 
+    if (fCheckTx) {
+        vector<CBaseTx *> txs;
+        for (const auto &ptx : block.vptx)
+            txs.push_back(ptx.get());
+        PrevalidateSignatures(txs, cw);
+    }
+
     // Check for duplicate txids. This is caught by ConnectInputs(),
     // but catching it earlier avoids a potential DoS attack:
     set<uint256> uniqueTx;
@@ -1989,7 +2144,7 @@ bool AcceptBlock(CBlock &block, CValidationState &state, CDiskBlockPos *dbp, boo
     CBlockIndex *pPrevBlockIndex = nullptr;
     int32_t height = 0;
     if (block.GetHeight() != 0 || blockHash != SysCfg().GetGenesisBlockHash()) {
-        map<uint256, CBlockIndex *>::iterator mi = mapBlockIndex.find(block.GetPrevBlockHash());
+        BlockMap::iterator mi = mapBlockIndex.find(block.GetPrevBlockHash());
         if (mi == mapBlockIndex.end())
             return state.DoS(10, ERRORMSG("AcceptBlock() : prev block not found"), 0, "bad-prevblk");
 
@@ -2048,11 +2203,21 @@ bool AcceptBlock(CBlock &block, CValidationState &state, CDiskBlockPos *dbp, boo
     CBlockIndex* pTip = chainActive.Tip() ;
     if (pTip->GetBlockHash() == blockHash) {
         {
+            // the peers asking for compact blocks rebuild the block from their mempools
+            CBlockHeaderAndShortTxIDs cmpctBlock;
+            if (mining)
+                cmpctBlock = CBlockHeaderAndShortTxIDs(block, GetRand(std::numeric_limits<uint64_t>::max()));
+
             LOCK(cs_vNodes);
             for (auto pNode : vNodes) {
                 //p2p_xiaoyu_20191116
                 if (mining) {
-                    pNode->PushMessage(NetMsgType::BLOCK, block);
+                    if (pNode->fAnnounceCmpctBlock) {
+                        pNode->PushMessage(NetMsgType::CMPCTBLOCK, cmpctBlock);
+                        GetCmpctBlockStats().AddSent();
+                    } else {
+                        pNode->PushMessage(NetMsgType::BLOCK, block);
+                    }
                     continue;
                 }
                 if (chainActive.Height() > (pNode->nStartingHeight != -1 ? pNode->nStartingHeight - 2000 : 0))
@@ -2401,16 +2566,19 @@ bool VerifyDB(int32_t nCheckLevel, int32_t nCheckDepth) {
     int32_t nGoodTransactions  = 0;
     CValidationState state;
 
+    vector<CBlockIndex *> vIndex;
     for (CBlockIndex *pIndex = chainActive.Tip(); pIndex && pIndex->pprev; pIndex = pIndex->pprev) {
-        boost::this_thread::interruption_point();
         if (pIndex->height < chainActive.Height() - nCheckDepth)
             break;
+        vIndex.push_back(pIndex);
+    }
 
-        CBlock block;
-        // check level 0: read from disk
-        if (!ReadBlockFromDisk(pIndex, block))
-            return ERRORMSG("VerifyDB() : *** ReadBlockFromDisk failed at %d, hash=%s",
-                            pIndex->height, pIndex->GetBlockHash().ToString());
+    CBlockPrefetcher prefetcher(vIndex);
+    CBlockIndex *pIndex;
+    CBlock block;
+    // check level 0: read from disk
+    while (prefetcher.Next(pIndex, block)) {
+        boost::this_thread::interruption_point();
 
         // check level 1: verify block validity
         if (nCheckLevel >= 1 && !CheckBlock(block, state, *spCW, false))
@@ -2443,25 +2611,32 @@ bool VerifyDB(int32_t nCheckLevel, int32_t nCheckDepth) {
             }
         }
     }
+    if (pIndex != nullptr)
+        return ERRORMSG("VerifyDB() : *** ReadBlockFromDisk failed at %d, hash=%s",
+                        pIndex->height, pIndex->GetBlockHash().ToString());
+
     if (pIndexFailure)
         return ERRORMSG("VerifyDB() : *** coin database inconsistencies found (last %i blocks, %i good transactions before that)\n",
                         chainActive.Height() - pIndexFailure->height + 1, nGoodTransactions);
 
     // check level 4: try reconnecting blocks
     if (nCheckLevel >= 4) {
-        CBlockIndex *pIndex = pIndexState;
-        while (pIndex != chainActive.Tip()) {
-            boost::this_thread::interruption_point();
-            pIndex = chainActive.Next(pIndex);
-            CBlock block;
-            if (!ReadBlockFromDisk(pIndex, block))
-                return ERRORMSG("VerifyDB() : *** ReadBlockFromDisk failed at %d, hash=%s",
-                                pIndex->height, pIndex->GetBlockHash().ToString());
+        vIndex.clear();
+        for (CBlockIndex *pNextIndex = pIndexState; pNextIndex != chainActive.Tip();) {
+            pNextIndex = chainActive.Next(pNextIndex);
+            vIndex.push_back(pNextIndex);
+        }
 
+        CBlockPrefetcher connectPrefetcher(vIndex);
+        while (connectPrefetcher.Next(pIndex, block)) {
+            boost::this_thread::interruption_point();
             if (!ConnectBlock(block, *spCW, pIndex, state, false))
                 return ERRORMSG("VerifyDB() : *** found un-connectable block at %d, hash=%s",
                                 pIndex->height, pIndex->GetBlockHash().ToString());
         }
+        if (pIndex != nullptr)
+            return ERRORMSG("VerifyDB() : *** ReadBlockFromDisk failed at %d, hash=%s",
+                            pIndex->height, pIndex->GetBlockHash().ToString());
     }
 
     LogPrint(BCLog::INFO, "No coin database inconsistencies in last %i blocks (%i transactions)\n",
@@ -2472,6 +2647,7 @@ bool VerifyDB(int32_t nCheckLevel, int32_t nCheckDepth) {
 
 void UnloadBlockIndex() {
     mapBlockIndex.clear();
+    blockIndexArena.Clear();
     setBlockIndexValid.clear();
     chainActive.SetTip(nullptr);
     pIndexBestInvalid = nullptr;
@@ -2525,7 +2701,7 @@ void PrintBlockTree() {
     AssertLockHeld(cs_main);
     // pre-compute tree structure
     map<CBlockIndex *, vector<CBlockIndex *> > mapNext;
-    for (map<uint256, CBlockIndex *>::iterator mi = mapBlockIndex.begin(); mi != mapBlockIndex.end(); ++mi) {
+    for (BlockMap::iterator mi = mapBlockIndex.begin(); mi != mapBlockIndex.end(); ++mi) {
         CBlockIndex *pIndex = (*mi).second;
         mapNext[pIndex->pprev].push_back(pIndex);
     }
@@ -2582,6 +2758,10 @@ void PrintBlockTree() {
 bool LoadExternalBlockFile(FILE *fileIn, CDiskBlockPos *dbp) {
     int64_t nStart = GetTimeMillis();
     int32_t nLoaded    = 0;
+#ifdef POSIX_FADV_SEQUENTIAL
+    // the file is scanned from the start to the end, let the kernel read it ahead further
+    posix_fadvise(fileno(fileIn), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
     try {
         CBufferedFile blkdat(fileIn, 2 * MAX_BLOCK_SIZE, MAX_BLOCK_SIZE + 8, SER_DISK, CLIENT_VERSION);
         uint64_t nStartByte = 0;
@@ -2705,10 +2885,8 @@ class CMainCleanup {
     CMainCleanup() {}
     ~CMainCleanup() {
         // block headers
-        map<uint256, CBlockIndex *>::iterator it1 = mapBlockIndex.begin();
-        for (; it1 != mapBlockIndex.end(); it1++)
-            delete (*it1).second;
         mapBlockIndex.clear();
+        blockIndexArena.Clear();
 
         // orphan blocks
         map<uint256, COrphanBlock *>::iterator it2 = mapOrphanBlocks.begin();
@@ -2724,6 +2902,10 @@ bool DisconnectBlockFromTip(CValidationState &state) {
     return DisconnectTip(state);
 }
 
+bool DisconnectBlockFromTip(CValidationState &state, std::shared_ptr<CBlock> &spBlock) {
+    return DisconnectTip(state, spBlock);
+}
+
 bool EraseBlockIndexFromSet(CBlockIndex *pIndex) {
     AssertLockHeld(cs_main);
     return setBlockIndexValid.erase(pIndex) > 0;
@@ -45,7 +45,8 @@ extern CChain chainActive;
 extern CSignatureCache signatureCache;
 
 extern CTxMemPool mempool;
-extern map<uint256, CBlockIndex *> mapBlockIndex;
+extern BlockMap mapBlockIndex;
+extern CBlockIndexArena blockIndexArena;
 extern uint64_t nLastBlockTx;
 extern uint64_t nLastBlockSize;
 extern const string strMessageMagic;
@@ -105,6 +106,10 @@ string GetWarnings(string strFor);
 bool GetTransaction(std::shared_ptr<CBaseTx> &pBaseTx, const uint256 &hash, CBlockDBCache &blockCache, bool bSearchMempool = true);
 /** Retrieve a transaction height comfirmed in block*/
 int32_t GetTxConfirmHeight(const uint256 &hash, CBlockDBCache &blockCache);
+/** Index the txs of a block by the addresses involved in them, see -addrindex */
+void WriteAddrTxIndex(const CBlock &block, CCacheWrapper &cw);
+/** Index the blocks connected before -addrindex was switched on, from the newest to the oldest */
+void ThreadAddrIndexCatchUp();
 
 /** Abort with a message */
 bool AbortNode(const string &msg);
@@ -114,6 +119,9 @@ bool GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats);
 void Misbehaving(NodeId nodeid, int32_t howmuch);
 
 bool VerifySignature(const uint256 &sigHash, const std::vector<uint8_t> &signature, const CPubKey &pubKey);
+/** Verify a batch of signatures on the -parsigverify threads and add the valid ones to the signature cache.
+ *  valid[i] tells whether checks[i] is valid, return whether all of them are. */
+bool VerifySignatures(const std::vector<CSignatureCheck> &checks, std::vector<bool> &valid);
 
 /** (try to) add transaction to memory pool **/
 bool AcceptToMemoryPool(CTxMemPool &pool, CValidationState &state, CBaseTx *pBaseTx,
@@ -234,6 +242,8 @@ bool AcceptBlock(CBlock &block, CValidationState &state, CDiskBlockPos *dbp = nu
 
 //disconnect block for test
 bool DisconnectBlockFromTip(CValidationState &state);
+// disconnect the blocks one by one, spBlock carries the block of the next tip between the calls
+bool DisconnectBlockFromTip(CValidationState &state, std::shared_ptr<CBlock> &spBlock);
 
 /** Mark a block as invalid. */
 bool InvalidateBlock(CValidationState &state, CBlockIndex *pIndex);
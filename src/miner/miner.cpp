@@ -330,13 +330,13 @@ static bool CreateNewBlockPreStableCoinRelease(CCacheWrapper &cwIn, std::unique_
                 continue;
             }
 
-            auto spCW = std::make_shared<CCacheWrapper>(&cwIn);
+            CCacheSavepoint savepoint(cwIn);
 
             try {
                 CValidationState state;
                 pBaseTx->nFuelRate = fuelRate;
                 uint32_t prevBlockTime = pIndexPrev->GetBlockTime();
-                CTxExecuteContext context(height, index + 1, fuelRate, blockTime, prevBlockTime, spCW.get(), &state, wasm::transaction_status_type::mining);
+                CTxExecuteContext context(height, index + 1, fuelRate, blockTime, prevBlockTime, &cwIn, &state, wasm::transaction_status_type::mining);
                 if (!pBaseTx->CheckTx(context) || !pBaseTx->ExecuteTx(context)) {
                     LogPrint(BCLog::MINER, "CreateNewBlockPreStableCoinRelease() : failed to pack transaction, txid: %s\n",
                             pBaseTx->GetHash().GetHex());
@@ -357,7 +357,7 @@ static bool CreateNewBlockPreStableCoinRelease(CCacheWrapper &cwIn, std::unique_
                 continue;
             }
 
-            spCW->Flush();
+            savepoint.Release();
 
             auto fuel        = pBaseTx->GetFuel(height, fuelRate);
             auto fees_symbol = std::get<0>(pBaseTx->GetFees());
@@ -472,7 +472,7 @@ static bool CreateNewBlockStableCoinRelease(int64_t startMiningMs, CCacheWrapper
                 continue;
             }
 
-            auto spCW = std::make_shared<CCacheWrapper>(&cwIn);
+            CCacheSavepoint savepoint(cwIn);
 
             try {
                 CValidationState state;
@@ -485,21 +485,21 @@ static bool CreateNewBlockStableCoinRelease(int64_t startMiningMs, CCacheWrapper
 
                     map<CoinPricePair, uint64_t> mapMedianPricePoints;
                     uint64_t slideWindow = 0;
-                    spCW->sysParamCache.GetParam(SysParamType::MEDIAN_PRICE_SLIDE_WINDOW_BLOCKCOUNT, slideWindow);
-                    spCW->ppCache.GetBlockMedianPricePoints(height, slideWindow, mapMedianPricePoints);
+                    cwIn.sysParamCache.GetParam(SysParamType::MEDIAN_PRICE_SLIDE_WINDOW_BLOCKCOUNT, slideWindow);
+                    cwIn.ppCache.GetBlockMedianPricePoints(height, slideWindow, mapMedianPricePoints);
 
                     pPriceMedianTx->SetMedianPricePoints(mapMedianPricePoints);
                     pPriceMedianTx->ComputeSignatureHash(true);
                 }
 
                 LogPrint(BCLog::MINER, "CreateNewBlockStableCoinRelease() : begin to pack transaction: %s\n",
-                         pBaseTx->ToString(spCW->accountCache));
+                         pBaseTx->ToString(cwIn.accountCache));
 
                 uint32_t prevBlockTime = pIndexPrev->GetBlockTime();
-                CTxExecuteContext context(height, index + 1, fuelRate, blockTime, prevBlockTime, spCW.get(), &state, wasm::transaction_status_type::mining);
+                CTxExecuteContext context(height, index + 1, fuelRate, blockTime, prevBlockTime, &cwIn, &state, wasm::transaction_status_type::mining);
                 if (!pBaseTx->CheckTx(context) || !pBaseTx->ExecuteTx(context)) {
                     LogPrint(BCLog::MINER, "CreateNewBlockStableCoinRelease() : failed to pack transaction: %s\n",
-                             pBaseTx->ToString(spCW->accountCache));
+                             pBaseTx->ToString(cwIn.accountCache));
 
                     pCdMan->pLogCache->SetExecuteFail(height, pBaseTx->GetHash(), state.GetRejectCode(),
                                                       state.GetRejectReason());
@@ -518,7 +518,7 @@ static bool CreateNewBlockStableCoinRelease(int64_t startMiningMs, CCacheWrapper
                 continue;
             }
 
-            spCW->Flush();
+            savepoint.Release();
 
             auto fuel        = pBaseTx->GetFuel(height, fuelRate);
             auto fees_symbol = std::get<0>(pBaseTx->GetFees());
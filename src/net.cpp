@@ -15,6 +15,7 @@
 #include "tx/tx.h"
 #include "commons/util/time.h"
 #include "p2p/node.h"
+#include "p2p/relaycache.h"
 
 #ifdef WIN32
 #include <string.h>
@@ -78,9 +79,6 @@ CNodeSignals& GetNodeSignals() { return g_node_signals; }
 
 vector<CNode*> vNodes;
 CCriticalSection cs_vNodes;
-map<CInv, CDataStream> mapRelay;
-deque<pair<int64_t, CInv> > vRelayExpiration;
-CCriticalSection cs_mapRelay;
 
 
 static deque<string> vOneShots;
@@ -1482,18 +1480,9 @@ void RelayTransaction(CBaseTx* pBaseTx, const uint256& hash) {
 
 void RelayTransaction(CBaseTx* pBaseTx, const uint256& hash, const CDataStream& ss) {
     CInv inv(MSG_TX, hash);
-    {
-        LOCK(cs_mapRelay);
-        // Expire old relay messages
-        while (!vRelayExpiration.empty() && vRelayExpiration.front().first < GetTime()) {
-            mapRelay.erase(vRelayExpiration.front().second);
-            vRelayExpiration.pop_front();
-        }
+    // Save original serialized message so newer versions are preserved
+    GetRelayCache().Insert(hash, ss);
 
-        // Save original serialized message so newer versions are preserved
-        mapRelay.insert(make_pair(inv, ss));
-        vRelayExpiration.push_back(make_pair(GetTime() + 15 * 60, inv));
-    }
     LOCK(cs_vNodes);
     for (auto pNode : vNodes) {
         if (!pNode->fRelayTxes)
@@ -80,9 +80,6 @@ extern CAddrMan addrman;
 extern int32_t nMaxConnections;
 extern vector<CNode*> vNodes;
 extern CCriticalSection cs_vNodes;
-extern map<CInv, CDataStream> mapRelay;
-extern deque<pair<int64_t, CInv> > vRelayExpiration;
-extern CCriticalSection cs_mapRelay;
 extern vector<string> vAddedNodes;
 extern CCriticalSection cs_vAddedNodes;
 extern map<CNetAddr, LocalServiceInfo> mapLocalHost;
@@ -0,0 +1,173 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockencodings.h"
+
+#include <unordered_map>
+
+#include "commons/util/util.h"
+#include "config/version.h"
+#include "crypto/hash.h"
+#include "crypto/siphash.h"
+#include "tx/txmempool.h"
+#include "tx/txserializer.h"
+
+CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock &block, uint64_t nonceIn)
+    : header(block.GetBlockHeader()), nonce(nonceIn) {
+    FillShortTxIdKeys();
+
+    shortTxIds.reserve(block.vptx.size());
+    for (uint32_t i = 0; i < block.vptx.size(); i++) {
+        const std::shared_ptr<CBaseTx> &pTx = block.vptx[i];
+        // the reward and the price median txs are made by the miner, they are never in the mempools
+        if (pTx->IsBlockRewardTx() || pTx->IsCoinRewardTx() || pTx->IsPriceMedianTx())
+            prefilledTxs.push_back({i, pTx});
+        else
+            shortTxIds.push_back(GetShortTxId(pTx->GetHash()));
+    }
+}
+
+void CBlockHeaderAndShortTxIDs::FillShortTxIdKeys() const {
+    CHashWriter ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << header << nonce;
+    uint256 keyHash = ss.GetHash();
+    shortTxIdK0     = keyHash.GetUint64(0);
+    shortTxIdK1     = keyHash.GetUint64(1);
+}
+
+uint64_t CBlockHeaderAndShortTxIDs::GetShortTxId(const uint256 &txid) const {
+    return SipHashUint256(shortTxIdK0, shortTxIdK1, txid) & 0xffffffffffffULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class CPartialBlock
+
+CmpctReadStatus CPartialBlock::Init(const CBlockHeaderAndShortTxIDs &cmpctBlock, const CTxMemPool &pool) {
+    size_t txCount = cmpctBlock.GetTxCount();
+    if (txCount == 0 || txCount > MAX_BLOCK_SIZE / SHORT_TXID_SIZE)
+        return CMPCT_READ_INVALID;
+
+    header = cmpctBlock.header;
+    vptx.assign(txCount, nullptr);
+    mempoolTxCount = 0;
+
+    for (const auto &prefilledTx : cmpctBlock.prefilledTxs) {
+        if (prefilledTx.index >= txCount || prefilledTx.pTx == nullptr || vptx[prefilledTx.index] != nullptr)
+            return CMPCT_READ_INVALID;
+        vptx[prefilledTx.index] = prefilledTx.pTx;
+    }
+
+    // the short txids fill the slots left by the prefilled txs in order
+    std::unordered_map<uint64_t, uint32_t> shortTxIdIndexes;
+    shortTxIdIndexes.reserve(cmpctBlock.shortTxIds.size());
+    uint32_t index = 0;
+    for (uint64_t shortTxId : cmpctBlock.shortTxIds) {
+        while (vptx[index] != nullptr)
+            index++;
+        if (!shortTxIdIndexes.emplace(shortTxId, index).second)
+            return CMPCT_READ_FAILED;  // two txs of the block have the same short txid
+
+        index++;
+    }
+
+    LOCK(pool.cs);
+    for (const auto &item : pool.memPoolTxs) {
+        auto it = shortTxIdIndexes.find(cmpctBlock.GetShortTxId(item.first));
+        if (it == shortTxIdIndexes.end())
+            continue;
+
+        std::shared_ptr<CBaseTx> &pTx = vptx[it->second];
+        if (pTx == nullptr) {
+            pTx = item.second.GetTransaction();
+            mempoolTxCount++;
+        } else {
+            // two mempool txs have the same short txid, request the tx of the block
+            pTx = nullptr;
+            mempoolTxCount--;
+            shortTxIdIndexes.erase(it);
+        }
+    }
+
+    return CMPCT_READ_OK;
+}
+
+std::vector<uint32_t> CPartialBlock::GetMissingTxIndexes() const {
+    std::vector<uint32_t> indexes;
+    for (uint32_t i = 0; i < vptx.size(); i++) {
+        if (vptx[i] == nullptr)
+            indexes.push_back(i);
+    }
+    return indexes;
+}
+
+CmpctReadStatus CPartialBlock::FillBlock(CBlock &block, const std::vector<std::shared_ptr<CBaseTx>> &missingTxs) const {
+    block = CBlock(header);
+    block.vptx.reserve(vptx.size());
+
+    size_t missingIndex = 0;
+    for (const auto &pTx : vptx) {
+        if (pTx != nullptr) {
+            // the block must not share the txs with the mempool
+            block.vptx.push_back(pTx->GetNewInstance());
+            continue;
+        }
+
+        if (missingIndex >= missingTxs.size() || missingTxs[missingIndex] == nullptr)
+            return CMPCT_READ_INVALID;
+        block.vptx.push_back(missingTxs[missingIndex++]);
+    }
+    if (missingIndex != missingTxs.size())
+        return CMPCT_READ_INVALID;
+
+    // a mempool tx out of the block has the same short txid as a tx of the block
+    if (block.BuildMerkleTree() != header.GetMerkleRootHash())
+        return CMPCT_READ_FAILED;
+
+    return CMPCT_READ_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class CCmpctBlockStats
+
+void CCmpctBlockStats::AddSent() {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.sent++;
+}
+
+void CCmpctBlockStats::AddReceived() {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.received++;
+}
+
+void CCmpctBlockStats::AddFallback() {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.fallbacks++;
+}
+
+void CCmpctBlockStats::AddRebuilt(const CBlockHeader &header, int64_t nTimeReceived, size_t missingTxs) {
+    int64_t rebuildMicros = GetTimeMicros() - nTimeReceived;
+    int64_t delayMillis   = GetTimeMillis() - header.GetBlockTime() * 1000;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (missingTxs == 0) {
+        counters.fromMempool++;
+    } else {
+        counters.withBlockTxn++;
+        counters.missingTxs += missingTxs;
+    }
+    counters.rebuildMicros += rebuildMicros;
+    counters.maxRebuildMicros = std::max(counters.maxRebuildMicros, rebuildMicros);
+    counters.delayMillis += delayMillis;
+    counters.lastDelayMillis = delayMillis;
+}
+
+CCmpctBlockCounters CCmpctBlockStats::Get() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+CCmpctBlockStats &GetCmpctBlockStats() {
+    static CCmpctBlockStats stats;
+    return stats;
+}
@@ -0,0 +1,191 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef P2P_BLOCKENCODINGS_H
+#define P2P_BLOCKENCODINGS_H
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "commons/serialize.h"
+#include "commons/uint256.h"
+#include "persistence/block.h"
+
+class CTxMemPool;
+
+// the version of the compact blocks announced by sendcmpct
+static const uint64_t CMPCTBLOCK_VERSION = 1;
+// the bytes of a short txid
+static const uint32_t SHORT_TXID_SIZE = 6;
+// the blocks deeper than it in the chain are served in full instead of compact
+static const int32_t MAX_CMPCTBLOCK_DEPTH = 10;
+
+/** Serializes the short txids of a compact block, SHORT_TXID_SIZE bytes each */
+class CShortTxIdsWrapper {
+public:
+    explicit CShortTxIdsWrapper(std::vector<uint64_t> &idsIn) : ids(idsIn) {}
+
+    unsigned int GetSerializeSize(int nType, int nVersion) const {
+        return GetSizeOfCompactSize(ids.size()) + ids.size() * SHORT_TXID_SIZE;
+    }
+
+    template <typename Stream>
+    void Serialize(Stream &s, int nType, int nVersion) const {
+        WriteCompactSize(s, ids.size());
+        for (uint64_t id : ids) {
+            uint8_t buf[SHORT_TXID_SIZE];
+            for (uint32_t i = 0; i < SHORT_TXID_SIZE; i++)
+                buf[i] = (uint8_t)(id >> (8 * i));
+            s.write((char *)buf, SHORT_TXID_SIZE);
+        }
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream &s, int nType, int nVersion) {
+        uint64_t count = ReadCompactSize(s);
+        ids.clear();
+        ids.reserve(std::min<uint64_t>(count, MAX_BLOCK_SIZE / SHORT_TXID_SIZE));
+        for (uint64_t n = 0; n < count; n++) {
+            uint8_t buf[SHORT_TXID_SIZE];
+            s.read((char *)buf, SHORT_TXID_SIZE);
+            uint64_t id = 0;
+            for (uint32_t i = 0; i < SHORT_TXID_SIZE; i++)
+                id |= (uint64_t)buf[i] << (8 * i);
+            ids.push_back(id);
+        }
+    }
+
+private:
+    std::vector<uint64_t> &ids;
+};
+
+/** A tx sent within a compact block, e.g. the block reward tx, which is never relayed alone */
+struct CPrefilledTx {
+    uint32_t index;  // the index of the tx in the block
+    std::shared_ptr<CBaseTx> pTx;
+
+    IMPLEMENT_SERIALIZE(
+        READWRITE(VARINT(index));
+        READWRITE(pTx);
+    )
+};
+
+/**
+ * The cmpctblock message: the header of a block, the short txids of the txs the receiver is expected
+ * to have in its mempool, and the txs which are not relayed to the mempools. A short txid is the
+ * SipHash of the txid, keyed by the hash of the header and a nonce, cut to SHORT_TXID_SIZE bytes.
+ */
+class CBlockHeaderAndShortTxIDs {
+public:
+    CBlockHeader header;
+    uint64_t nonce;
+    std::vector<uint64_t> shortTxIds;
+    std::vector<CPrefilledTx> prefilledTxs;
+
+    CBlockHeaderAndShortTxIDs() : nonce(0) {}
+    CBlockHeaderAndShortTxIDs(const CBlock &block, uint64_t nonceIn);
+
+    uint64_t GetShortTxId(const uint256 &txid) const;
+    size_t GetTxCount() const { return shortTxIds.size() + prefilledTxs.size(); }
+
+    IMPLEMENT_SERIALIZE(
+        READWRITE(header);
+        READWRITE(nonce);
+        READWRITE(REF(CShortTxIdsWrapper(REF(shortTxIds))));
+        READWRITE(prefilledTxs);
+        if (fRead)
+            FillShortTxIdKeys();
+    )
+
+private:
+    void FillShortTxIdKeys() const;
+
+    mutable uint64_t shortTxIdK0 = 0;
+    mutable uint64_t shortTxIdK1 = 0;
+};
+
+/** The getblocktxn message: the indexes of the txs of a compact block which are missing in the mempool */
+class CBlockTxnRequest {
+public:
+    uint256 blockHash;
+    std::vector<uint32_t> indexes;
+
+    IMPLEMENT_SERIALIZE(
+        READWRITE(blockHash);
+        READWRITE(indexes);
+    )
+};
+
+/** The blocktxn message: the txs requested by getblocktxn */
+class CBlockTxn {
+public:
+    uint256 blockHash;
+    std::vector<std::shared_ptr<CBaseTx>> txs;
+
+    IMPLEMENT_SERIALIZE(
+        READWRITE(blockHash);
+        READWRITE(txs);
+    )
+};
+
+enum CmpctReadStatus {
+    CMPCT_READ_OK,
+    CMPCT_READ_INVALID,  // the message is malformed, the peer is misbehaving
+    CMPCT_READ_FAILED,   // the block can not be rebuilt, e.g. on a short txid collision, get the full block
+};
+
+/** A block being rebuilt from a compact block, the mempool and the txs of a blocktxn */
+class CPartialBlock {
+public:
+    CBlockHeader header;
+    int64_t nTimeReceived = 0;  // micros, when the compact block was received
+
+    CmpctReadStatus Init(const CBlockHeaderAndShortTxIDs &cmpctBlock, const CTxMemPool &pool);
+
+    std::vector<uint32_t> GetMissingTxIndexes() const;
+    uint32_t GetMempoolTxCount() const { return mempoolTxCount; }
+
+    // fill the missing txs in the order of GetMissingTxIndexes(), check the merkle root of the block
+    CmpctReadStatus FillBlock(CBlock &block, const std::vector<std::shared_ptr<CBaseTx>> &missingTxs) const;
+
+private:
+    std::vector<std::shared_ptr<CBaseTx>> vptx;
+    uint32_t mempoolTxCount = 0;
+};
+
+struct CCmpctBlockCounters {
+    uint64_t sent            = 0;  // compact blocks sent
+    uint64_t received        = 0;  // compact blocks received
+    uint64_t fromMempool     = 0;  // blocks rebuilt from the mempool alone
+    uint64_t withBlockTxn    = 0;  // blocks rebuilt after a getblocktxn round trip
+    uint64_t missingTxs      = 0;  // txs requested by getblocktxn
+    uint64_t fallbacks       = 0;  // full blocks requested instead
+    int64_t rebuildMicros    = 0;  // total time from receiving the compact blocks to rebuilding them
+    int64_t maxRebuildMicros = 0;
+    int64_t delayMillis      = 0;  // total time from the block times to rebuilding the blocks
+    int64_t lastDelayMillis  = 0;
+};
+
+/** The propagation metrics of the compact blocks */
+class CCmpctBlockStats {
+public:
+    void AddSent();
+    void AddReceived();
+    void AddFallback();
+    void AddRebuilt(const CBlockHeader &header, int64_t nTimeReceived, size_t missingTxs);
+
+    CCmpctBlockCounters Get();
+
+private:
+    std::mutex mutex;
+    CCmpctBlockCounters counters;
+};
+
+CCmpctBlockStats &GetCmpctBlockStats();
+
+#endif  // P2P_BLOCKENCODINGS_H
@@ -11,6 +11,9 @@
 #include "commons/util/util.h"
 #include "main.h"
 #include "net.h"
+#include "p2p/blockencodings.h"
+#include "p2p/relaycache.h"
+#include "miner/miner.h"
 #include "miner/pbftcontext.h"
 #include "miner/pbftmanager.h"
 #include "tx/einvalidtxtype.h"
@@ -101,9 +104,9 @@ inline void ProcessGetData(CNode *pFrom) {
             boost::this_thread::interruption_point();
             it++;
 
-            if (inv.type == MSG_BLOCK || inv.type == MSG_FILTERED_BLOCK) {
+            if (inv.type == MSG_BLOCK || inv.type == MSG_FILTERED_BLOCK || inv.type == MSG_CMPCT_BLOCK) {
                 bool send                                = false;
-                map<uint256, CBlockIndex *>::iterator mi = mapBlockIndex.find(inv.hash);
+                BlockMap::iterator mi = mapBlockIndex.find(inv.hash);
                 if (mi != mapBlockIndex.end()) {
                     send = true;
                 } else {
@@ -114,10 +117,20 @@ inline void ProcessGetData(CNode *pFrom) {
                     // Send block from disk
                     CBlock block;
                     ReadBlockFromDisk((*mi).second, block);
-                    if (inv.type == MSG_BLOCK) {
+                    // the txs of the old blocks are out of the mempools, send them in full
+                    bool fCmpctBlock = inv.type == MSG_CMPCT_BLOCK &&
+                                       chainActive.Height() - (*mi).second->height <= MAX_CMPCTBLOCK_DEPTH;
+                    if (inv.type == MSG_BLOCK || (inv.type == MSG_CMPCT_BLOCK && !fCmpctBlock)) {
                         LogPrint(BCLog::NET, "send block[%u]: %s to peer %s\n", block.GetHeight(), block.GetHash().GetHex(),
                                  pFrom->addr.ToString());
                         pFrom->PushMessage(NetMsgType::BLOCK, block);
+                    } else if (fCmpctBlock) {
+                        CBlockHeaderAndShortTxIDs cmpctBlock(block, GetRand(std::numeric_limits<uint64_t>::max()));
+                        LogPrint(BCLog::NET, "send cmpctblock[%u]: %s to peer %s, txs=%u, prefilled_txs=%u\n",
+                                 block.GetHeight(), block.GetHash().GetHex(), pFrom->addr.ToString(),
+                                 cmpctBlock.GetTxCount(), cmpctBlock.prefilledTxs.size());
+                        pFrom->PushMessage(NetMsgType::CMPCTBLOCK, cmpctBlock);
+                        GetCmpctBlockStats().AddSent();
                     }
                     else  // MSG_FILTERED_BLOCK)
                     {
@@ -131,8 +144,9 @@ inline void ProcessGetData(CNode *pFrom) {
                             // send here - they must either disconnect and retry or request the full block. Thus, the
                             // protocol spec specified allows for us to provide duplicate txn here, however we MUST
                             // always provide at least what the remote peer needs
+                            LOCK(pFrom->cs_inventory);
                             for (auto &pair : merkleBlock.vMatchedTxn)
-                                if (!pFrom->setInventoryKnown.count(CInv(MSG_TX, pair.second)))
+                                if (!pFrom->filterInventoryKnown.contains(pair.second))
                                     pFrom->PushMessage(NetMsgType::TX, block.vptx[pair.first]);
                         }
                         // else
@@ -154,11 +168,10 @@ inline void ProcessGetData(CNode *pFrom) {
             } else if (inv.IsKnownType()) {
                 // Send stream from relay memory
                 bool pushed = false;
-                {
-                    LOCK(cs_mapRelay);
-                    map<CInv, CDataStream>::iterator mi = mapRelay.find(inv);
-                    if (mi != mapRelay.end()) {
-                        pFrom->PushMessage(inv.GetCommand(), (*mi).second);
+                if (inv.type == MSG_TX) {
+                    std::shared_ptr<const CDataStream> spData = GetRelayCache().Find(inv.hash);
+                    if (spData != nullptr) {
+                        pFrom->PushMessage(inv.GetCommand(), *spData);
                         pushed = true;
                     }
                 }
@@ -180,7 +193,7 @@ inline void ProcessGetData(CNode *pFrom) {
             // Track requests for our stuff.
             // g_signals.Inventory(inv.hash);
 
-            if (inv.type == MSG_BLOCK || inv.type == MSG_FILTERED_BLOCK)
+            if (inv.type == MSG_BLOCK || inv.type == MSG_FILTERED_BLOCK || inv.type == MSG_CMPCT_BLOCK)
                 break;
         }
     }
@@ -539,7 +552,7 @@ inline bool ProcessGetHeadersMessage(CNode *pFrom, CDataStream &vRecv) {
     CBlockIndex *pIndex = nullptr;
     if (locator.IsNull()) {
         // If locator is null, return the hashStop block
-        map<uint256, CBlockIndex *>::iterator mi = mapBlockIndex.find(hashStop);
+        BlockMap::iterator mi = mapBlockIndex.find(hashStop);
         if (mi == mapBlockIndex.end())
             return true;
 
@@ -705,14 +718,8 @@ inline bool ProcessGetDataMessage(CNode *pFrom, CDataStream &vRecv) {
     return true;
 }
 
-inline void ProcessBlockMessage(CNode *pFrom, CDataStream &vRecv) {
-    CBlock block;
-    vRecv >> block;
-
-    LogPrint(BCLog::NET, "recv block! time_ms=%lld, hash=%s, peer=%s\n", GetTimeMillis(),
-        block.GetHash().ToString(), pFrom->addr.ToString());
-    // block.Print();
-
+// Process a block received in full, or rebuilt from a compact block.
+inline void ProcessReceivedBlock(CNode *pFrom, CBlock &block) {
     CInv inv(MSG_BLOCK, block.GetHash());
     pFrom->AddInventoryKnown(inv);
 
@@ -737,6 +744,252 @@ inline void ProcessBlockMessage(CNode *pFrom, CDataStream &vRecv) {
 
 }
 
+inline void ProcessBlockMessage(CNode *pFrom, CDataStream &vRecv) {
+    CBlock block;
+    vRecv >> block;
+
+    LogPrint(BCLog::NET, "recv block! time_ms=%lld, hash=%s, peer=%s\n", GetTimeMillis(),
+        block.GetHash().ToString(), pFrom->addr.ToString());
+    // block.Print();
+
+    ProcessReceivedBlock(pFrom, block);
+}
+
+inline void ProcessSendCmpctMessage(CNode *pFrom, CDataStream &vRecv) {
+    bool fAnnounce   = false;
+    uint64_t version = 0;
+    vRecv >> fAnnounce >> version;
+
+    LogPrint(BCLog::NET, "recv sendcmpct! announce=%d, version=%u, peer=%s\n", fAnnounce, version, pFrom->addrName);
+    if (version != CMPCTBLOCK_VERSION)
+        return;
+
+    pFrom->fSupportsCmpctBlock = true;
+    pFrom->fAnnounceCmpctBlock = fAnnounce;
+}
+
+// Request the full block, if the compact block can not be rebuilt.
+inline void RequestFullBlock(CNode *pFrom, const uint256 &blockHash) {
+    LogPrint(BCLog::NET, "request the full block of cmpctblock! hash=%s, peer=%s\n", blockHash.ToString(),
+             pFrom->addrName);
+    GetCmpctBlockStats().AddFallback();
+
+    vector<CInv> vGetData;
+    vGetData.push_back(CInv(MSG_BLOCK, blockHash));
+    pFrom->PushMessage(NetMsgType::GETDATA, vGetData);
+}
+
+inline bool CompletePartialBlock(CNode *pFrom, const CPartialBlock &partialBlock,
+                                 const vector<std::shared_ptr<CBaseTx>> &missingTxs) {
+    uint256 blockHash = partialBlock.header.GetHash();
+    CBlock block;
+    CmpctReadStatus status = partialBlock.FillBlock(block, missingTxs);
+    if (status == CMPCT_READ_INVALID) {
+        LogPrint(BCLog::INFO, "Misbehaving: invalid blocktxn, nMisbehavior add 100\n");
+        Misbehaving(pFrom->GetId(), 100);
+        return ERRORMSG("invalid txs of cmpctblock %s from peer %s", blockHash.ToString(), pFrom->addrName);
+    }
+    if (status == CMPCT_READ_FAILED) {
+        RequestFullBlock(pFrom, blockHash);
+        return true;
+    }
+
+    GetCmpctBlockStats().AddRebuilt(partialBlock.header, partialBlock.nTimeReceived, missingTxs.size());
+    LogPrint(BCLog::NET, "rebuilt cmpctblock! time_ms=%lld, hash=%s, txs=%u, mempool_txs=%u, missing_txs=%u, "
+             "rebuild_us=%d, peer=%s\n", GetTimeMillis(), blockHash.ToString(), block.vptx.size(),
+             partialBlock.GetMempoolTxCount(), missingTxs.size(), GetTimeMicros() - partialBlock.nTimeReceived,
+             pFrom->addrName);
+
+    ProcessReceivedBlock(pFrom, block);
+    return true;
+}
+
+// Requires cs_main. The header of a compact block extending the tip must be signed by the delegate
+// of its slot, checked before its txs are looked up in the mempool
+inline bool CheckCmpctBlockHeader(const CBlockHeader &header) {
+    AssertLockHeld(cs_main);
+    VoteDelegateVector delegates;
+    if (!pCdMan->pDelegateCache->GetActiveDelegates(delegates))
+        return ERRORMSG("CheckCmpctBlockHeader() : get active delegates failed");
+
+    ShuffleDelegates(header.GetHeight(), header.GetTime(), delegates);
+
+    VoteDelegate delegate;
+    if (!GetCurrentDelegate(header.GetTime(), header.GetHeight(), delegates, delegate))
+        return ERRORMSG("CheckCmpctBlockHeader() : get current delegate failed");
+
+    CAccount account;
+    if (!pCdMan->pAccountCache->GetAccount(delegate.regid, account))
+        return ERRORMSG("CheckCmpctBlockHeader() : get delegate account failed, regid=%s", delegate.regid.ToString());
+
+    const auto &signature = header.GetSignature();
+    if (signature.empty() || signature.size() > MAX_SIGNATURE_SIZE)
+        return ERRORMSG("CheckCmpctBlockHeader() : invalid block signature size");
+
+    uint256 sigHash = header.ComputeSignatureHash();
+    if (!VerifySignature(sigHash, signature, account.owner_pubkey) &&
+        !VerifySignature(sigHash, signature, account.miner_pubkey))
+        return ERRORMSG("CheckCmpctBlockHeader() : verify signature error, delegate=%s", delegate.regid.ToString());
+
+    return true;
+}
+
+inline bool ProcessCmpctBlockMessage(CNode *pFrom, CDataStream &vRecv) {
+    int64_t nTimeReceived = GetTimeMicros();
+    CBlockHeaderAndShortTxIDs cmpctBlock;
+    vRecv >> cmpctBlock;
+
+    uint256 blockHash = cmpctBlock.header.GetHash();
+    LogPrint(BCLog::NET, "recv cmpctblock! time_ms=%lld, hash=%s, txs=%u, prefilled_txs=%u, peer=%s\n",
+             GetTimeMillis(), blockHash.ToString(), cmpctBlock.GetTxCount(), cmpctBlock.prefilledTxs.size(),
+             pFrom->addrName);
+    GetCmpctBlockStats().AddReceived();
+    pFrom->AddInventoryKnown(CInv(MSG_BLOCK, blockHash));
+
+    {
+        LOCK(cs_main);
+        if (mapBlockIndex.count(blockHash) || mapOrphanBlocks.count(blockHash)) {
+            LOCK(cs_mapNodeState);
+            MarkBlockAsReceived(blockHash, pFrom->GetId());
+            return true;
+        }
+
+        // only the compact blocks asked to the peer, or pushed by a peer we sent sendcmpct to
+        bool fInFlight;
+        {
+            LOCK(cs_mapNodeState);
+            auto itInFlight = mapBlocksInFlight.find(blockHash);
+            fInFlight = itInFlight != mapBlocksInFlight.end() && std::get<0>(itInFlight->second) == pFrom->GetId();
+        }
+        if (!fInFlight && !pFrom->fSentSendCmpct) {
+            LogPrint(BCLog::NET, "ignore unsolicited cmpctblock! hash=%s, peer=%s\n", blockHash.ToString(),
+                     pFrom->addrName);
+            return true;
+        }
+
+        auto itPrev = mapBlockIndex.find(cmpctBlock.header.GetPrevBlockHash());
+        if (itPrev == mapBlockIndex.end()) {
+            // an asked block is still wanted, it is kept as an orphan once received in full
+            if (fInFlight)
+                RequestFullBlock(pFrom, blockHash);
+            else
+                LogPrint(BCLog::NET, "ignore cmpctblock of an unknown previous block! hash=%s, peer=%s\n",
+                         blockHash.ToString(), pFrom->addrName);
+            return true;
+        }
+        if (cmpctBlock.header.GetHeight() != (uint32_t)itPrev->second->height + 1) {
+            LogPrint(BCLog::INFO, "Misbehaving: cmpctblock of a wrong height, nMisbehavior add 100\n");
+            Misbehaving(pFrom->GetId(), 100);
+            return ERRORMSG("cmpctblock %s of height %u after block of height %d from peer %s", blockHash.ToString(),
+                            cmpctBlock.header.GetHeight(), itPrev->second->height, pFrom->addrName);
+        }
+        // the delegates are only known at the tip, the blocks of the forks go through the full checks
+        if (itPrev->second != chainActive.Tip()) {
+            RequestFullBlock(pFrom, blockHash);
+            return true;
+        }
+        if (!CheckCmpctBlockHeader(cmpctBlock.header)) {
+            LogPrint(BCLog::INFO, "Misbehaving: cmpctblock not signed by the delegate, nMisbehavior add 100\n");
+            Misbehaving(pFrom->GetId(), 100);
+            return ERRORMSG("cmpctblock %s with an invalid signature from peer %s", blockHash.ToString(),
+                            pFrom->addrName);
+        }
+    }
+
+    auto spPartialBlock           = std::make_shared<CPartialBlock>();
+    spPartialBlock->nTimeReceived = nTimeReceived;
+    CmpctReadStatus status        = spPartialBlock->Init(cmpctBlock, mempool);
+    if (status == CMPCT_READ_INVALID) {
+        LogPrint(BCLog::INFO, "Misbehaving: invalid cmpctblock, nMisbehavior add 100\n");
+        Misbehaving(pFrom->GetId(), 100);
+        return ERRORMSG("invalid cmpctblock %s from peer %s", blockHash.ToString(), pFrom->addrName);
+    }
+    if (status == CMPCT_READ_FAILED) {
+        RequestFullBlock(pFrom, blockHash);
+        return true;
+    }
+
+    CBlockTxnRequest request;
+    request.blockHash = blockHash;
+    request.indexes   = spPartialBlock->GetMissingTxIndexes();
+    if (request.indexes.empty())
+        return CompletePartialBlock(pFrom, *spPartialBlock, vector<std::shared_ptr<CBaseTx>>());
+
+    // one compact block waits for its txs per peer, get the replaced one in full
+    std::shared_ptr<CPartialBlock> spReplacedBlock = spPartialBlock;
+    {
+        LOCK(cs_mapNodeState);
+        CNodeState *state = State(pFrom->GetId());
+        if (state == nullptr)
+            return false;
+        spReplacedBlock.swap(state->spPartialBlock);
+    }
+    if (spReplacedBlock != nullptr && spReplacedBlock->header.GetHash() != blockHash)
+        RequestFullBlock(pFrom, spReplacedBlock->header.GetHash());
+
+    LogPrint(BCLog::NET, "send getblocktxn! hash=%s, missing_txs=%u, peer=%s\n", blockHash.ToString(),
+             request.indexes.size(), pFrom->addrName);
+    pFrom->PushMessage(NetMsgType::GETBLOCKTXN, request);
+    return true;
+}
+
+inline bool ProcessGetBlockTxnMessage(CNode *pFrom, CDataStream &vRecv) {
+    CBlockTxnRequest request;
+    vRecv >> request;
+
+    CBlock block;
+    {
+        LOCK(cs_main);
+        auto it = mapBlockIndex.find(request.blockHash);
+        if (it == mapBlockIndex.end() || chainActive.Height() - it->second->height > MAX_CMPCTBLOCK_DEPTH) {
+            LogPrint(BCLog::NET, "ignore getblocktxn of an unknown or old block! hash=%s, peer=%s\n",
+                     request.blockHash.ToString(), pFrom->addrName);
+            return true;
+        }
+
+        if (!ReadBlockFromDisk(it->second, block))
+            return ERRORMSG("read block %s for getblocktxn failed", request.blockHash.ToString());
+    }
+
+    CBlockTxn blockTxn;
+    blockTxn.blockHash = request.blockHash;
+    blockTxn.txs.reserve(request.indexes.size());
+    for (uint32_t index : request.indexes) {
+        if (index >= block.vptx.size()) {
+            LogPrint(BCLog::INFO, "Misbehaving: getblocktxn out of the block, nMisbehavior add 100\n");
+            Misbehaving(pFrom->GetId(), 100);
+            return ERRORMSG("getblocktxn of tx %u out of block %s from peer %s", index, request.blockHash.ToString(),
+                            pFrom->addrName);
+        }
+        blockTxn.txs.push_back(block.vptx[index]);
+    }
+
+    LogPrint(BCLog::NET, "send blocktxn! hash=%s, txs=%u, peer=%s\n", request.blockHash.ToString(),
+             blockTxn.txs.size(), pFrom->addrName);
+    pFrom->PushMessage(NetMsgType::BLOCKTXN, blockTxn);
+    return true;
+}
+
+inline bool ProcessBlockTxnMessage(CNode *pFrom, CDataStream &vRecv) {
+    CBlockTxn blockTxn;
+    vRecv >> blockTxn;
+
+    std::shared_ptr<CPartialBlock> spPartialBlock;
+    {
+        LOCK(cs_mapNodeState);
+        CNodeState *state = State(pFrom->GetId());
+        if (state == nullptr || state->spPartialBlock == nullptr ||
+            state->spPartialBlock->header.GetHash() != blockTxn.blockHash) {
+            LogPrint(BCLog::NET, "ignore unrequested blocktxn! hash=%s, peer=%s\n", blockTxn.blockHash.ToString(),
+                     pFrom->addrName);
+            return true;
+        }
+        spPartialBlock.swap(state->spPartialBlock);
+    }
+
+    return CompletePartialBlock(pFrom, *spPartialBlock, blockTxn.txs);
+}
+
 inline void ProcessMempoolMessage(CNode *pFrom, CDataStream &vRecv) {
     LOCK2(cs_main, pFrom->cs_filter);
 
@@ -19,6 +19,7 @@
 #include "p2p/netmessage.h"
 
 class CNode ;
+class CPartialBlock;
 struct CNodeSignals;
 struct CNodeState ;
 
@@ -38,6 +39,13 @@ static const uint32_t MAX_INV_SZ = 50000;
 static const size_t MAPASKFOR_MAX_SZ = MAX_INV_SZ;
 /** The maximum number of new addresses to accumulate before announcing. */
 static const uint32_t MAX_ADDR_TO_SEND = 1000;
+/** The maximum number of entries in an 'inv' message sent by a batch */
+static const uint32_t MAX_INV_SEND_SZ = 1000;
+/** The interval between the batches of the tx invs sent to a peer, the block invs are sent at once */
+static const int64_t INV_BROADCAST_INTERVAL = 100;  // millis
+/** The recent invs known by a peer and the false positive rate of the filter of them */
+static const uint32_t MAX_INV_KNOWN_SZ = 20000;
+static const double INV_KNOWN_FP_RATE  = 0.000001;
 
 extern limitedmap<CInv, int64_t> mapAlreadyAskedFor;
 
@@ -115,6 +123,7 @@ struct CNodeState {
     int32_t nBlocksToDownload;        // blocks number to be downloaded
     int64_t nLastBlockReceive;        // the latest receiving blocks time
     int64_t nLastBlockProcess;        // the latest processing blocks time
+    std::shared_ptr<CPartialBlock> spPartialBlock;  // the compact block waiting for its missing txs
 
     CNodeState() {
         nMisbehavior      = 0;
@@ -172,6 +181,12 @@ public:
     // b) the peer may tell us in their version message that we should not relay tx invs
     //    until they have initialized their bloom filter.
     bool fRelayTxes;
+    // the peer sent sendcmpct: it serves the blocks as compact blocks, and it wants the blocks
+    // made by us pushed as compact blocks (fAnnounceCmpctBlock)
+    bool fSupportsCmpctBlock;
+    bool fAnnounceCmpctBlock;
+    // we sent sendcmpct to the peer, it may push its new blocks to us as compact blocks
+    bool fSentSendCmpct;
     CSemaphoreGrant grantOutbound;
     CCriticalSection cs_filter;
     CBloomFilter* pFilter;
@@ -201,9 +216,10 @@ public:
     set<uint256> setKnown;  // alertHash
 
     // inventory based relay
-    mruset<CInv> setInventoryKnown;  //存放已收到的inv
-    vector<CInv> vInventoryToSend;   //待发送的inv
-    std::set<CInv> setForceToSend;   //强制发送的inv
+    CRollingBloomFilter filterInventoryKnown;  //存放已收到的inv
+    vector<CInv> vInventoryToSend;             //待发送的inv
+    std::set<CInv> setForceToSend;             //强制发送的inv
+    int64_t nNextInvSend;                      // micros, when the next batch of the tx invs is sent
 
     CCriticalSection cs_inventory;
     multimap<int64_t, CInv> mapAskFor;  //向网络请求交易的时间, a priority queue
@@ -222,7 +238,8 @@ public:
     bool fPingQueued;
 
     CNode(SOCKET hSocketIn, CAddress addrIn, string addrNameIn = "", bool fInboundIn = false)
-            : ssSend(SER_NETWORK, INIT_PROTO_VERSION), setAddrKnown(5000) {
+            : ssSend(SER_NETWORK, INIT_PROTO_VERSION), setAddrKnown(5000),
+              filterInventoryKnown(MAX_INV_KNOWN_SZ, INV_KNOWN_FP_RATE) {
         nServices                = 0;
         hSocket                  = hSocketIn;
         nRecvVersion             = INIT_PROTO_VERSION;
@@ -252,7 +269,10 @@ public:
         fStartSync               = false;
         fGetAddr                 = false;
         fRelayTxes               = false;
-        setInventoryKnown.max_size(SendBufferSize() / 1000);
+        fSupportsCmpctBlock      = false;
+        fAnnounceCmpctBlock      = false;
+        fSentSendCmpct           = false;
+        nNextInvSend             = 0;
         setBlockConfirmMsgKnown.max_size(200);
         pFilter        = new CBloomFilter();
         nPingNonceSent = 0;
@@ -353,7 +373,7 @@ public:
     void AddInventoryKnown(const CInv& inv) {
         {
             LOCK(cs_inventory);
-            setInventoryKnown.insert(inv);
+            filterInventoryKnown.insert(inv.hash);
         }
     }
 
@@ -365,7 +385,7 @@ public:
                 setForceToSend.insert(inv);
             }
 
-            if (forced || !setInventoryKnown.count(inv))
+            if (forced || !filterInventoryKnown.contains(inv.hash))
                 vInventoryToSend.push_back(inv);
 
         }
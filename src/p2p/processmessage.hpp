@@ -35,6 +35,12 @@ bool static ProcessMessage(CNode *pFrom, string strCommand, CDataStream &vRecv)
 
     else if (strCommand == NetMsgType::VERACK) {
         pFrom->SetRecvVersion(min(pFrom->nVersion, PROTOCOL_VERSION));
+
+        // Ask for the blocks as compact blocks, the peers not knowing sendcmpct ignore it
+        if (SysCfg().GetBoolArg("-cmpctblock", true)) {
+            pFrom->PushMessage(NetMsgType::SENDCMPCT, true, CMPCTBLOCK_VERSION);
+            pFrom->fSentSendCmpct = true;
+        }
     }
 
     else if (strCommand == NetMsgType::ADDR) {
@@ -72,6 +78,25 @@ bool static ProcessMessage(CNode *pFrom, string strCommand, CDataStream &vRecv)
         ProcessBlockMessage(pFrom, vRecv);
     }
 
+    else if (strCommand == NetMsgType::SENDCMPCT) {
+        ProcessSendCmpctMessage(pFrom, vRecv);
+    }
+
+    else if (strCommand == NetMsgType::CMPCTBLOCK && !SysCfg().IsImporting() && !SysCfg().IsReindex()) {
+        if (!ProcessCmpctBlockMessage(pFrom, vRecv))
+            return false;
+    }
+
+    else if (strCommand == NetMsgType::GETBLOCKTXN) {
+        if (!ProcessGetBlockTxnMessage(pFrom, vRecv))
+            return false;
+    }
+
+    else if (strCommand == NetMsgType::BLOCKTXN && !SysCfg().IsImporting() && !SysCfg().IsReindex()) {
+        if (!ProcessBlockTxnMessage(pFrom, vRecv))
+            return false;
+    }
+
     else if (strCommand == NetMsgType::GETADDR) {
         pFrom->vAddrToSend.clear();
         vector<CAddress> vAddr = addrman.GetAddr();
@@ -0,0 +1,55 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "relaycache.h"
+
+#include "commons/util/util.h"
+
+void CRelayCache::Expire(int64_t now) {
+    while (!expirations.empty() && (expirations.front().first < now || entries.size() >= maxSize)) {
+        entries.erase(expirations.front().second);
+        expirations.pop_front();
+    }
+}
+
+void CRelayCache::Insert(const uint256 &txid, const CDataStream &ss) {
+    // the serialization is copied out of the lock
+    auto spData = std::make_shared<const CDataStream>(ss);
+    int64_t now = GetTime();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.count(txid))
+        return;
+
+    Expire(now);
+    entries.emplace(txid, CEntry{spData, now + expiry});
+    expirations.emplace_back(now + expiry, txid);
+}
+
+std::shared_ptr<const CDataStream> CRelayCache::Find(const uint256 &txid) {
+    int64_t now = GetTime();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(txid);
+    if (it == entries.end() || it->second.expireTime < now)
+        return nullptr;
+
+    return it->second.spData;
+}
+
+size_t CRelayCache::Size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+void CRelayCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    expirations.clear();
+}
+
+CRelayCache &GetRelayCache() {
+    static CRelayCache cache;
+    return cache;
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef P2P_RELAYCACHE_H
+#define P2P_RELAYCACHE_H
+
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "commons/serialize.h"
+#include "commons/uint256.h"
+
+// the relayed txs are served to the getdata of the peers for it
+static const int64_t RELAY_CACHE_EXPIRY = 15 * 60;  // seconds
+// the most relayed txs kept, the oldest are dropped first
+static const size_t MAX_RELAY_CACHE_SIZE = 100000;
+
+/**
+ * The serialized txs relayed to the peers, kept for their getdata. An entry is dropped when it
+ * expires or when the cache is full, the oldest first, the first serialization of a tx is kept.
+ */
+class CRelayCache {
+public:
+    CRelayCache(size_t maxSizeIn = MAX_RELAY_CACHE_SIZE, int64_t expiryIn = RELAY_CACHE_EXPIRY)
+        : maxSize(maxSizeIn), expiry(expiryIn) {}
+
+    void Insert(const uint256 &txid, const CDataStream &ss);
+    // nullptr if the tx is not cached or expired
+    std::shared_ptr<const CDataStream> Find(const uint256 &txid);
+
+    size_t Size();
+    void Clear();
+
+private:
+    void Expire(int64_t now);
+
+    struct CEntry {
+        std::shared_ptr<const CDataStream> spData;
+        int64_t expireTime;
+    };
+
+    const size_t maxSize;
+    const int64_t expiry;
+
+    std::mutex mutex;
+    std::unordered_map<uint256, CEntry, CUint256Hasher> entries;
+    std::deque<std::pair<int64_t, uint256>> expirations;  // in the order of insertion
+};
+
+CRelayCache &GetRelayCache();
+
+#endif  // P2P_RELAYCACHE_H
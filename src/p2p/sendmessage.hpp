@@ -68,11 +68,15 @@ bool SendMessages(CNode *pTo, bool fSendTrickle) {
             //LogPrint(BCLog::NET, "send ping: %s\n", DateTimeStrFormat("YYYY-MM-DDTHH-MM-SS", pTo->nPingUsecStart).c_str());
         }
 
+        // Get the new blocks as compact blocks, their txs are in the mempool
+        bool fGetCmpctBlock = false;
         {
             TRY_LOCK(cs_main, lockMain);  // Acquire cs_main for IsInitialBlockDownload() and CNodeState()
             if (!lockMain)
                 return true;
 
+            fGetCmpctBlock = pTo->fSupportsCmpctBlock && !IsInitialBlockDownload();
+
             // Address refresh broadcast
             static int64_t nLastRebroadcast;
             if (!IsInitialBlockDownload() && (GetTime() - nLastRebroadcast > 24 * 60 * 60)) {
@@ -153,50 +157,37 @@ bool SendMessages(CNode *pTo, bool fSendTrickle) {
         //
         // Message: inventory
         //
+        int64_t nNow = GetTimeMicros();
         vector<CInv> vInv;
-        vector<CInv> vInvWait;
         {
             LOCK(pTo->cs_inventory);
-            vInv.reserve(pTo->vInventoryToSend.size());
-            vInvWait.reserve(pTo->vInventoryToSend.size());
-            for (const auto &inv : pTo->vInventoryToSend) {
+            // the tx invs are coalesced into a batch every INV_BROADCAST_INTERVAL, the block invs go at once
+            bool fSendTxInvs = pTo->nNextInvSend <= nNow;
+            if (fSendTxInvs)
+                pTo->nNextInvSend = nNow + INV_BROADCAST_INTERVAL * 1000;
 
-                if(pTo->setForceToSend.count(inv)){
-                    pTo->setInventoryKnown.insert(inv);
+            vector<CInv> vInvWait;
+            vInv.reserve(min<size_t>(pTo->vInventoryToSend.size(), MAX_INV_SEND_SZ));
+            for (const auto &inv : pTo->vInventoryToSend) {
+                if (pTo->setForceToSend.erase(inv)) {
+                    pTo->filterInventoryKnown.insert(inv.hash);
                     vInv.push_back(inv);
-                    pTo->setForceToSend.erase(inv);
+                } else if (pTo->filterInventoryKnown.contains(inv.hash)) {
                     continue;
-                }
-
-                if (pTo->setInventoryKnown.count(inv))
+                } else if (inv.type == MSG_TX && !fSendTxInvs) {
+                    vInvWait.push_back(inv);
                     continue;
-
-                // trickle out tx inv to protect privacy
-                if (inv.type == MSG_TX && !fSendTrickle) {
-                    // 1/4 of tx invs blast to all immediately
-                    static uint256 hashSalt;
-                    if (hashSalt.IsNull())
-                        hashSalt = GetRandHash();
-                    uint256 hashRand  = ArithToUint256(UintToArith256(inv.hash) ^ UintToArith256(hashSalt));
-                    hashRand          = Hash(BEGIN(hashRand), END(hashRand));
-                    bool fTrickleWait = ((UintToArith256(hashRand) & 3) != 0);
-
-                    if (fTrickleWait) {
-                        vInvWait.push_back(inv);
-                        continue;
-                    }
+                } else {
+                    pTo->filterInventoryKnown.insert(inv.hash);
+                    vInv.push_back(inv);
                 }
 
-                // returns true if wasn't already contained in the set
-                if (pTo->setInventoryKnown.insert(inv).second) {
-                    vInv.push_back(inv);
-                    if (vInv.size() >= 1000) {
-                        pTo->PushMessage(NetMsgType::INV, vInv);
-                        vInv.clear();
-                    }
+                if (vInv.size() >= MAX_INV_SEND_SZ) {
+                    pTo->PushMessage(NetMsgType::INV, vInv);
+                    vInv.clear();
                 }
             }
-            pTo->vInventoryToSend = vInvWait;
+            pTo->vInventoryToSend.swap(vInvWait);
         }
         if (!vInv.empty())
             pTo->PushMessage(NetMsgType::INV, vInv);
@@ -205,7 +196,7 @@ bool SendMessages(CNode *pTo, bool fSendTrickle) {
         // received a (requested) block in one minute, and that all blocks are
         // in flight for over two minutes, since we first had a chance to
         // process an incoming block.
-        int64_t nNow = GetTimeMicros();
+        nNow = GetTimeMicros();
         if (!pTo->fDisconnect && state.nBlocksInFlight &&
             state.nLastBlockReceive < state.nLastBlockProcess - BLOCK_DOWNLOAD_TIMEOUT * 1000000 &&
             state.vBlocksInFlight.front().nTime < state.nLastBlockProcess - 2 * BLOCK_DOWNLOAD_TIMEOUT * 1000000) {
@@ -220,10 +211,11 @@ bool SendMessages(CNode *pTo, bool fSendTrickle) {
         int32_t index = 0;
         while (!pTo->fDisconnect && state.nBlocksToDownload && state.nBlocksInFlight < MAX_BLOCKS_IN_TRANSIT_PER_PEER) {
             uint256 hash = state.vBlocksToDownload.front();
-            vGetData.push_back(CInv(MSG_BLOCK, hash));
+            vGetData.push_back(CInv(fGetCmpctBlock ? MSG_CMPCT_BLOCK : MSG_BLOCK, hash));
             MarkBlockAsInFlight(hash, pTo->GetId());
-            LogPrint(BCLog::NET, "send MSG_BLOCK msg! time_ms=%lld, hash=%s, peer=%s, FlightBlocks=%d, index=%d\n",
-                GetTimeMillis(), hash.ToString(), state.name, state.nBlocksInFlight, index++);
+            LogPrint(BCLog::NET, "send %s msg! time_ms=%lld, hash=%s, peer=%s, FlightBlocks=%d, index=%d\n",
+                fGetCmpctBlock ? "MSG_CMPCT_BLOCK" : "MSG_BLOCK", GetTimeMillis(), hash.ToString(), state.name,
+                state.nBlocksInFlight, index++);
             if (vGetData.size() >= 1000) {
                 pTo->PushMessage(NetMsgType::GETDATA, vGetData);
                 vGetData.clear();
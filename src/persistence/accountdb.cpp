@@ -297,15 +297,12 @@ uint32_t CAccountDBCache::GetCacheSize() const {
 }
 
 std::tuple<uint64_t /* total coins */, uint64_t /* total regids */> CAccountDBCache::TraverseAccount() {
-    map<CKeyID, CAccount> items;
-
-    accountCache.GetAllElements(items);
-
     uint64_t totalCoins  = 0;
     uint64_t totalRegIds = 0;
-    for (auto &item : items) {
+    CDBIterator<decltype(accountCache)> it(accountCache);
+    for (it.First(); it.IsValid(); it.Next()) {
         totalRegIds++;
-        totalCoins += item.second.GetToken(SYMB::WICC).free_amount;
+        totalCoins += it.GetValue().GetToken(SYMB::WICC).free_amount;
     }
     return std::tie(totalCoins, totalRegIds);
 }
@@ -15,6 +15,7 @@
 #include "entities/account.h"
 #include "dbconf.h"
 #include "dbaccess.h"
+#include "dbiterator.h"
 
 class uint256;
 class CKeyID;
@@ -96,12 +97,29 @@ public:
 
     bool Flush();
 
+    void EnableCleanCache(size_t maxUsage) {
+        accountCache.EnableCleanCache(maxUsage * 3 / 4);
+        regId2KeyIdCache.EnableCleanCache(maxUsage / 4);
+    }
+
     void SetDbOpLogMap(CDBOpLogMap *pDbOpLogMapIn) {
         accountCache.SetDbOpLogMap(pDbOpLogMapIn);
         regId2KeyIdCache.SetDbOpLogMap(pDbOpLogMapIn);
         nickId2KeyIdCache.SetDbOpLogMap(pDbOpLogMapIn);
     }
 
+    void SetJournal(CCacheJournal *pJournalIn) {
+        accountCache.SetJournal(pJournalIn);
+        regId2KeyIdCache.SetJournal(pJournalIn);
+        nickId2KeyIdCache.SetJournal(pJournalIn);
+    }
+
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn) {
+        accountCache.SetAccessSet(pAccessSetIn);
+        regId2KeyIdCache.SetAccessSet(pAccessSetIn);
+        nickId2KeyIdCache.SetAccessSet(pAccessSetIn);
+    }
+
     void RegisterUndoFunc(UndoDataFuncMap &undoDataFuncMap) {
         regId2KeyIdCache.RegisterUndoFunc(undoDataFuncMap);
         nickId2KeyIdCache.RegisterUndoFunc(undoDataFuncMap);
@@ -111,11 +129,11 @@ private:
 /*  CCompositeKVCache     prefixType            key              value           variable           */
 /*  -------------------- --------------------   --------------  -------------   --------------------- */
     // <prefix$RegID -> KeyID>
-    CCompositeKVCache< dbk::REGID_KEYID,          string,       CKeyID >         regId2KeyIdCache;
+    CHashKVCache<      dbk::REGID_KEYID,          string,       CKeyID >         regId2KeyIdCache;
     // <prefix$NickID -> KeyID>
     CCompositeKVCache< dbk::NICKID_KEYID,         CVarIntValue<uint64_t>,      std::pair<CVarIntValue<uint32_t>,CKeyID>>   nickId2KeyIdCache;
     // <prefix$KeyID -> Account>
-    CCompositeKVCache< dbk::KEYID_ACCOUNT,        CKeyID,       CAccount>        accountCache;
+    CHashKVCache<      dbk::KEYID_ACCOUNT,        CKeyID,       CAccount>        accountCache;
 
 };
 
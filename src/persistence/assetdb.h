@@ -75,6 +75,16 @@ public:
         assetTradingPairCache.SetDbOpLogMap(pDbOpLogMapIn);
     }
 
+    void SetJournal(CCacheJournal *pJournalIn) {
+        assetCache.SetJournal(pJournalIn);
+        assetTradingPairCache.SetJournal(pJournalIn);
+    }
+
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn) {
+        assetCache.SetAccessSet(pAccessSetIn);
+        assetTradingPairCache.SetAccessSet(pAccessSetIn);
+    }
+
     void RegisterUndoFunc(UndoDataFuncMap &undoDataFuncMap) {
         assetCache.RegisterUndoFunc(undoDataFuncMap);
         assetTradingPairCache.RegisterUndoFunc(undoDataFuncMap);
@@ -5,6 +5,9 @@
 
 #include "block.h"
 
+#include "blockfilereader.h"
+#include "commons/random.h"
+#include "crypto/sha256.h"
 #include "entities/account.h"
 #include "tx/blockpricemediantx.h"
 #include "main.h"
@@ -29,16 +32,34 @@ uint256 CBlock::BuildMerkleTree() const {
     for (const auto& ptx : vptx) {
         vMerkleTree.push_back(ptx->GetHash());
     }
-    int32_t j = 0;
-    for (int32_t nSize = vptx.size(); nSize > 1; nSize = (nSize + 1) / 2) {
-        for (int32_t i = 0; i < nSize; i += 2) {
-            int32_t i2 = min(i + 1, nSize - 1);
-            vMerkleTree.push_back(Hash(BEGIN(vMerkleTree[j + i]), END(vMerkleTree[j + i]),
-                                       BEGIN(vMerkleTree[j + i2]), END(vMerkleTree[j + i2])));
+    return ComputeMerkleTree(vMerkleTree);
+}
+
+uint256 CBlock::ComputeMerkleTree(vector<uint256>& vTree) {
+    static_assert(sizeof(uint256) == 32, "the nodes of a level are hashed in place as 64 byte pairs");
+
+    // size the tree once, so that a level is not moved while the next one is appended
+    size_t nTotal = vTree.size();
+    for (size_t nSize = vTree.size(); nSize > 1; nSize = (nSize + 1) / 2)
+        nTotal += (nSize + 1) / 2;
+    size_t j = vTree.size();
+    vTree.resize(nTotal);
+
+    // every two adjacent nodes of a level are the 64 bytes double-hashed into their parent, the whole
+    // level at once; an odd last node is paired with itself
+    size_t i = 0;
+    for (size_t nSize = j; nSize > 1; nSize = (nSize + 1) / 2) {
+        const uint256* level = &vTree[i];
+        uint256* parents     = &vTree[j];
+        SHA256D64(parents->begin(), level->begin(), nSize / 2);
+        if (nSize & 1) {
+            const uint256& last = level[nSize - 1];
+            parents[nSize / 2] = Hash(BEGIN(last), END(last), BEGIN(last), END(last));
         }
-        j += nSize;
+        i = j;
+        j += (nSize + 1) / 2;
     }
-    return (vMerkleTree.empty() ? uint256() : vMerkleTree.back());
+    return (vTree.empty() ? uint256() : vTree.back());
 }
 
 vector<uint256> CBlock::GetMerkleBranch(int32_t index) const {
@@ -159,15 +180,54 @@ bool WriteBlockToDisk(CBlock &block, CDiskBlockPos &pos) {
 
 bool ReadBlockFromDisk(const CDiskBlockPos &pos, CBlock &block) {
     block.SetNull();
+    if (pos.IsNull())
+        return ERRORMSG("ReadBlockFromDisk : null block position");
 
-    // Open history file to read
-    CAutoFile filein = CAutoFile(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
-    if (!filein)
-        return ERRORMSG("ReadBlockFromDisk : OpenBlockFile failed");
+    try {
+        // the block follows the message start and its size, read along with them at once
+        static const uint32_t nPrefixSize = MESSAGE_START_SIZE + sizeof(uint32_t);
+        if (pos.nPos >= nPrefixSize) {
+            CBlockFileStream filein(CDiskBlockPos(pos.nFile, pos.nPos - nPrefixSize), SER_DISK, CLIENT_VERSION);
+            MessageStartChars messageStart;
+            uint32_t nSize;
+            filein >> FLATDATA(messageStart) >> nSize;
+            if (memcmp(messageStart, SysCfg().MessageStart(), MESSAGE_START_SIZE) == 0 && nSize <= MAX_BLOCK_SIZE)
+                filein.ReadAhead(nSize);
+            filein >> block;
+        } else {
+            CBlockFileStream filein(pos, SER_DISK, CLIENT_VERSION);
+            filein >> block;
+        }
+    } catch (std::exception &e) {
+        return ERRORMSG("%s : Deserialize or I/O error - %s", __func__, e.what());
+    }
+
+    return true;
+}
+
+bool ReadBlockHeaderFromDisk(const CDiskBlockPos &pos, CBlockHeader &header) {
+    if (pos.IsNull())
+        return ERRORMSG("ReadBlockHeaderFromDisk : null block position");
 
-    // Read block
     try {
-        filein >> block;
+        CBlockFileStream filein(pos, SER_DISK, CLIENT_VERSION);
+        filein >> header;
+    } catch (std::exception &e) {
+        return ERRORMSG("%s : Deserialize or I/O error - %s", __func__, e.what());
+    }
+
+    return true;
+}
+
+bool ReadTxFromDisk(const CDiskTxPos &pos, CBlockHeader &header, std::shared_ptr<CBaseTx> &pTx) {
+    if (pos.IsNull())
+        return ERRORMSG("ReadTxFromDisk : null tx position");
+
+    try {
+        CBlockFileStream filein(pos, SER_DISK, CLIENT_VERSION);
+        filein >> header;
+        filein.ignore(pos.nTxOffset);
+        filein >> pTx;
     } catch (std::exception &e) {
         return ERRORMSG("%s : Deserialize or I/O error - %s", __func__, e.what());
     }
@@ -185,6 +245,30 @@ bool ReadBlockFromDisk(const CBlockIndex *pIndex, CBlock &block) {
     return true;
 }
 
+const uint256 &CBlockHashHasher::GetSalt() {
+    static const uint256 salt = GetRandHash();
+    return salt;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class CBlockIndexArena
+
+CBlockIndex *CBlockIndexArena::Alloc() {
+    if (nextInSlab == BLOCK_INDEX_SLAB_SIZE) {
+        slabs.emplace_back(new CBlockIndex[BLOCK_INDEX_SLAB_SIZE]);
+        nextInSlab = 0;
+    }
+
+    allocatedCount++;
+    return &slabs.back()[nextInSlab++];
+}
+
+void CBlockIndexArena::Clear() {
+    slabs.clear();
+    nextInSlab     = BLOCK_INDEX_SLAB_SIZE;
+    allocatedCount = 0;
+}
+
 bool ReadBaseTxFromDisk(const CTxCord txCord, std::shared_ptr<CBaseTx> &pTx) {
     auto pBlock = std::make_shared<CBlock>();
     const CBlockIndex* pBlockIndex = chainActive[ txCord.GetHeight() ];
@@ -21,6 +21,10 @@
 
 #include <stdint.h>
 #include <memory>
+#include <vector>
+
+#include "commons/openhashmap.h"
+#include "crypto/siphash.h"
 
 class CBlockDBCache;
 class CDiskBlockPos;
@@ -164,6 +168,9 @@ public:
 
     uint256 BuildMerkleTree() const;
 
+    // appends the upper levels of the merkle tree to its leaves in vTree, returns the root
+    static uint256 ComputeMerkleTree(vector<uint256> &vTree);
+
     std::tuple<bool, int32_t> GetTxIndex(const uint256 &txid) const;
 
     const uint256 &GetTxid(uint32_t index) const {
@@ -189,8 +196,9 @@ public:
  */
 class CBlockIndex {
 public:
-    // pointer to the hash of the block, if any. memory is owned by this CBlockIndex
-    const uint256 *pBlockHash;
+    // the hash of the block, its key in mapBlockIndex. Kept by value, 24 bytes more than a pointer to
+    // the key, as BlockMap moves its keys when it rehashes
+    uint256 blockHash;
 
     // pointer to the index of the predecessor of this block
     CBlockIndex *pprev;
@@ -235,12 +243,12 @@ public:
     uint32_t nNonce;
     uint64_t nFuel;
     uint32_t nFuelRate;
+    // kept in memory, the headers served to the peers must not read the block files
     vector<unsigned char> vSignature;
 
     CRegID miner;
 
     CBlockIndex() {
-        pBlockHash       = nullptr;
         pprev            = nullptr;
         pskip            = nullptr;
         height           = 0;
@@ -265,7 +273,6 @@ public:
     }
 
     CBlockIndex(const CBlock &block) {
-        pBlockHash       = nullptr;
         pprev            = nullptr;
         pskip            = nullptr;
         height           = 0;
@@ -289,11 +296,12 @@ public:
         nNonce         = block.GetNonce();
         nFuel          = block.GetFuel();
         nFuelRate      = block.GetFuelRate();
+        blockHash      = block.GetHash();
         vSignature     = block.GetSignature();
-      /*  if(block.GetHeight() == 0 )
+        if (block.GetHeight() == 0)
             miner = CRegID("0-1");
-        else
-            miner = block.vptx[0]->txUid.get<CRegID>();*/
+        else if (block.vptx[0]->txUid.is<CRegID>())
+            miner = block.vptx[0]->txUid.get<CRegID>();
     }
 
     CDiskBlockPos GetBlockPos() const {
@@ -329,7 +337,7 @@ public:
         return block;
     }
 
-    uint256 GetBlockHash() const { return *pBlockHash; }
+    uint256 GetBlockHash() const { return blockHash; }
     int64_t GetBlockTime() const { return (int64_t)nTime; }
     bool CheckIndex() const { return true; }
 
@@ -358,8 +366,8 @@ public:
                                 uint32_t nRequired, uint32_t nToCheck);
 
     string ToString() const {
-        return strprintf("CBlockIndex(pprev=%p, height=%d, merkle=%s, blockHash=%s, chainWork=%s, regId=%s)", pprev, height,
-                         merkleRootHash.ToString(), GetBlockHash().ToString(), nChainWork.ToString(), miner.ToString());
+        return strprintf("CBlockIndex(pprev=%p, height=%d, merkle=%s, blockHash=%s, chainWork=%s)", pprev, height,
+                         merkleRootHash.ToString(), GetBlockHash().ToString(), nChainWork.ToString());
     }
 
     string GetIndentityString() const {
@@ -376,6 +384,52 @@ public:
     const CBlockIndex *GetAncestor(int32_t heightIn) const;
 };
 
+/**
+ * The hash function of BlockMap. The block hashes come from the peers, so they are SipHashed with a
+ * random salt of the process, or the headers could be mined to make long probe sequences in the open
+ * addressing table.
+ */
+struct CBlockHashHasher {
+    CBlockHashHasher() : k0(GetSalt().GetUint64(0)), k1(GetSalt().GetUint64(1)) {}
+
+    size_t operator()(const uint256 &hash) const { return SipHashUint256(k0, k1, hash); }
+
+private:
+    static const uint256 &GetSalt();
+
+    uint64_t k0;
+    uint64_t k1;
+};
+
+typedef openhashmap<uint256, CBlockIndex *, CBlockHashHasher> BlockMap;
+
+// the block indexes allocated at once
+static const size_t BLOCK_INDEX_SLAB_SIZE = 4096;
+
+/**
+ * The allocator of the block indexes of mapBlockIndex. The indexes are allocated by slabs of
+ * BLOCK_INDEX_SLAB_SIZE instead of one by one, which saves the per allocation overhead and keeps
+ * the indexes loaded together close in memory. The indexes themselves are not smaller, see
+ * CBlockIndex::blockHash. The indexes are only freed all at once by Clear(),
+ * an index erased from mapBlockIndex may still be pointed to, e.g. by pprev or the node states.
+ * Guarded by cs_main as mapBlockIndex.
+ */
+class CBlockIndexArena {
+public:
+    // a default constructed CBlockIndex
+    CBlockIndex *Alloc();
+    void Clear();
+
+    size_t GetSlabCount() const { return slabs.size(); }
+    size_t GetAllocatedCount() const { return allocatedCount; }
+    size_t GetMemoryUsage() const { return slabs.size() * BLOCK_INDEX_SLAB_SIZE * sizeof(CBlockIndex); }
+
+private:
+    std::vector<std::unique_ptr<CBlockIndex[]>> slabs;
+    size_t nextInSlab = BLOCK_INDEX_SLAB_SIZE;  // the next unused index of the last slab
+    size_t allocatedCount = 0;
+};
+
 
 /** Used to marshal pointers into hashes for db storage. */
 class CDiskBlockIndex : public CBlockIndex {
@@ -433,9 +487,9 @@ public:
     string ToString() const {
         string str = "CDiskBlockIndex(";
         str += CBlockIndex::ToString();
-        str += strprintf("\n                blockHash=%s, hashPrev=%s)",
+        str += strprintf("\n                blockHash=%s, hashPrev=%s, regId=%s)",
                          GetBlockHash().ToString().c_str(),
-                         hashPrev.ToString().c_str());
+                         hashPrev.ToString().c_str(), miner.ToString());
         return str;
     }
 
@@ -468,6 +522,10 @@ struct CBlockLocator {
 bool WriteBlockToDisk(CBlock &block, CDiskBlockPos &pos);
 bool ReadBlockFromDisk(const CDiskBlockPos &pos, CBlock &block);
 bool ReadBlockFromDisk(const CBlockIndex *pIndex, CBlock &block);
+/** Read the header of the block at pos, e.g. the block of a tx index position */
+bool ReadBlockHeaderFromDisk(const CDiskBlockPos &pos, CBlockHeader &header);
+/** Read the tx at the tx index position and the header of its block */
+bool ReadTxFromDisk(const CDiskTxPos &pos, CBlockHeader &header, std::shared_ptr<CBaseTx> &pTx);
 
 
 bool ReadBaseTxFromDisk(const CTxCord txCord, std::shared_ptr<CBaseTx> &pTx);
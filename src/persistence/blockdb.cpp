@@ -57,7 +57,7 @@ bool CBlockIndexDB::LoadBlockIndexes() {
                 pIndexNew->nFuel          = diskIndex.nFuel;
                 pIndexNew->nFuelRate      = diskIndex.nFuelRate;
                 pIndexNew->vSignature     = diskIndex.vSignature;
-                pIndexNew->miner          = diskIndex.miner ;
+                pIndexNew->miner          = diskIndex.miner;
 
                 if (!pIndexNew->CheckIndex())
                     return ERRORMSG("LoadBlockIndex() : CheckIndex failed: %s", pIndexNew->ToString());
@@ -87,39 +87,94 @@ CBlockIndex *InsertBlockIndex(uint256 hash) {
         return nullptr;
 
     // Return existing
-    map<uint256, CBlockIndex *>::iterator mi = mapBlockIndex.find(hash);
+    BlockMap::iterator mi = mapBlockIndex.find(hash);
     if (mi != mapBlockIndex.end())
         return (*mi).second;
 
     // Create new
-    CBlockIndex *pIndexNew = new CBlockIndex();
-    if (!pIndexNew)
-        throw runtime_error("LoadBlockIndex() : new CBlockIndex failed");
-    mi                    = mapBlockIndex.insert(make_pair(hash, pIndexNew)).first;
-    pIndexNew->pBlockHash = &((*mi).first);
+    CBlockIndex *pIndexNew = blockIndexArena.Alloc();
+    pIndexNew->blockHash   = hash;
+    mapBlockIndex.insert(make_pair(hash, pIndexNew));
 
     return pIndexNew;
 }
 
 
+/************************* ADDR_TX_INDEX ****************************/
+shared_ptr<string> ADDR_TX_INDEX::ParseLastPos(const string &lastPosInfo, AddrTxIndexCache::KeyType &lastKey) {
+    CDataStream ds(lastPosInfo, SER_DISK, CLIENT_VERSION);
+    uint256 lastBlockHash;
+    try {
+        ds >> lastBlockHash >> lastKey;
+    } catch (std::exception &e) {
+        return make_shared<string>(strprintf("Deserialize error - %s", e.what()));
+    }
+
+    uint32_t lastHeight = GetHeight(lastKey);
+    CBlockIndex *pBlockIndex = chainActive[lastHeight];
+    if (pBlockIndex == nullptr)
+        return make_shared<string>(strprintf("The last_pos_info is not contained in active chains,"
+            " last_height=%d, tip_height=%d", lastHeight, chainActive.Height()));
+    if (pBlockIndex->GetBlockHash() != lastBlockHash)
+        return make_shared<string>(strprintf("The block of height in last_pos_info does not match with the active block,"
+            " height=%d, last_block_hash=%s, cur_height_block_hash=%s",
+            lastHeight, lastBlockHash.ToString(), pBlockIndex->GetBlockHash().ToString()));
+    return nullptr;
+}
+
+shared_ptr<string> ADDR_TX_INDEX::MakeLastPos(const AddrTxIndexCache::KeyType &lastKey, string &lastPosInfo) {
+    uint32_t lastHeight = GetHeight(lastKey);
+    CBlockIndex *pBlockIndex = chainActive[lastHeight];
+    if (pBlockIndex == nullptr)
+        return make_shared<string>(strprintf("The block of lastKey is not contained in active chains,"
+            " last_height=%d, tip_height=%d", lastHeight, chainActive.Height()));
+
+    CDataStream ds(SER_DISK, CLIENT_VERSION);
+    ds << pBlockIndex->GetBlockHash() << lastKey;
+    lastPosInfo = ds.str();
+    return nullptr;
+}
+
+/************************* CAddrTxGetter ****************************/
+bool CAddrTxGetter::Execute(const CKeyID &keyId, uint32_t maxCount, const AddrTxIndexCache::KeyType &lastKey) {
+    assert(txs.size() == 0 && "Can only execute 1 times");
+
+    CDBPrefixIterator<AddrTxIndexCache, CKeyID> it(db_cache, keyId);
+    for (it.SeekUpper(&lastKey); it.IsValid(); it.Next()) {
+        if (maxCount != 0 && txs.size() >= maxCount) {
+            has_more = true;
+            break;
+        }
+        txs.push_back(make_pair(it.GetKey(), it.GetValue()));
+    }
+    if (!txs.empty())
+        last_key = txs.back().first;
+    return true;
+}
+
+
 /************************* CBlockDBCache ****************************/
 uint32_t CBlockDBCache::GetCacheSize() const {
     return
         txDiskPosCache.GetCacheSize() +
+        addrTxIndexCache.GetCacheSize() +
         flagCache.GetCacheSize() +
         bestBlockHashCache.GetCacheSize() +
         lastBlockFileCache.GetCacheSize() +
         reindexCache.GetCacheSize() +
-        finalityBlockCache.GetCacheSize() ;
+        finalityBlockCache.GetCacheSize() +
+        addrIndexCatchUpCache.GetCacheSize();
 }
 
 bool CBlockDBCache::Flush() {
     txDiskPosCache.Flush();
+    addrTxIndexCache.Flush();
     flagCache.Flush();
     bestBlockHashCache.Flush();
     lastBlockFileCache.Flush();
     reindexCache.Flush();
     finalityBlockCache.Flush();
+    addrIndexCatchUpCache.Flush();
     return true;
 }
 
@@ -159,6 +214,23 @@ bool CBlockDBCache::WriteTxIndexes(const vector<pair<uint256, CDiskTxPos> > &lis
     return true;
 }
 
+bool CBlockDBCache::SetAddrTxIndex(const CKeyID &keyId, uint32_t height, uint32_t index, const uint256 &txid) {
+    return addrTxIndexCache.SetData(ADDR_TX_INDEX::MakeKey(keyId, height, index), txid);
+}
+
+int32_t CBlockDBCache::GetAddrIndexCatchUpHeight() const {
+    int32_t height = 0;
+    addrIndexCatchUpCache.GetData(height);
+    return height;
+}
+
+bool CBlockDBCache::SetAddrIndexCatchUpHeight(int32_t height) {
+    if (height > 0)
+        return addrIndexCatchUpCache.SetData(height);
+    else
+        return addrIndexCatchUpCache.EraseData();
+}
+
 bool CBlockDBCache::WriteReindexing(bool fReindexing) {
     if (fReindexing)
         return reindexCache.SetData(true);
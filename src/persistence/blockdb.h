@@ -10,8 +10,10 @@
 #include <utility>
 #include <vector>
 #include "commons/arith_uint256.h"
+#include "commons/leb128.h"
 #include "leveldbwrapper.h"
 #include "dbaccess.h"
+#include "dbiterator.h"
 #include "persistence/block.h"
 
 #include <map>
@@ -38,6 +40,45 @@ public:
 };
 
 
+/*       type               prefixType                   key                                         value       type            */
+/*  ----------------   -------------------------  ----------------------------------------------  ---------   ------------------- */
+    // keyId, MAX - height, MAX - index -> txid, the txs of an address from the newest to the oldest
+typedef CCompositeKVCache<dbk::KEYID_TXID_INDEX,  tuple<CKeyID, CFixedUInt32, CFixedUInt32>,     uint256>    AddrTxIndexCache;
+
+namespace ADDR_TX_INDEX {
+    inline AddrTxIndexCache::KeyType MakeKey(const CKeyID &keyId, uint32_t height, uint32_t index) {
+        return make_tuple(keyId, CFixedUInt32(UINT32_MAX - height), CFixedUInt32(UINT32_MAX - index));
+    }
+
+    inline uint32_t GetHeight(const AddrTxIndexCache::KeyType &key) {
+        return UINT32_MAX - std::get<1>(key).value;
+    }
+
+    inline uint32_t GetIndex(const AddrTxIndexCache::KeyType &key) {
+        return UINT32_MAX - std::get<2>(key).value;
+    }
+
+    // return err str if err happens
+    shared_ptr<string> ParseLastPos(const string &lastPosInfo, AddrTxIndexCache::KeyType &lastKey);
+
+    shared_ptr<string> MakeLastPos(const AddrTxIndexCache::KeyType &lastKey, string &lastPosInfo);
+};
+
+class CAddrTxGetter {
+public:
+    typedef pair<AddrTxIndexCache::KeyType, uint256> AddrTxItem;
+
+    bool                        has_more = false;   // has more txs in db
+    AddrTxIndexCache::KeyType   last_key;           // the key of last position to get more txs
+    vector<AddrTxItem>          txs;                // the returned txs, from the newest to the oldest
+private:
+    AddrTxIndexCache &db_cache;
+public:
+    CAddrTxGetter(AddrTxIndexCache &dbCache): db_cache(dbCache) {}
+
+    bool Execute(const CKeyID &keyId, uint32_t maxCount, const AddrTxIndexCache::KeyType &lastKey);
+};
+
 /** Access to the block database (blocks/index/) */
 class CBlockDBCache {
 public:
@@ -45,61 +86,97 @@ public:
 
     CBlockDBCache(CDBAccess *pDbAccess):
         txDiskPosCache(pDbAccess),
+        addrTxIndexCache(pDbAccess),
         flagCache(pDbAccess),
         bestBlockHashCache(pDbAccess),
         lastBlockFileCache(pDbAccess),
         reindexCache(pDbAccess),
-        finalityBlockCache(pDbAccess) {
+        finalityBlockCache(pDbAccess),
+        addrIndexCatchUpCache(pDbAccess) {
         assert(pDbAccess->GetDbNameType() == DBNameType::BLOCK);
     };
 
     CBlockDBCache(CBlockDBCache *pBaseIn):
         txDiskPosCache(pBaseIn->txDiskPosCache),
+        addrTxIndexCache(pBaseIn->addrTxIndexCache),
         flagCache(pBaseIn->flagCache),
         bestBlockHashCache(pBaseIn->bestBlockHashCache),
         lastBlockFileCache(pBaseIn->lastBlockFileCache),
         reindexCache(pBaseIn->reindexCache),
-        finalityBlockCache(pBaseIn->finalityBlockCache){};
+        finalityBlockCache(pBaseIn->finalityBlockCache),
+        addrIndexCatchUpCache(pBaseIn->addrIndexCatchUpCache){};
 
 public:
     bool Flush();
     uint32_t GetCacheSize() const;
 
-    bool GetTxHashByAddress(const CKeyID &keyId, uint32_t height, map<string, string > &mapTxHash);
-    bool SetTxHashByAddress(const CKeyID &keyId, uint32_t height, uint32_t index, const uint256 &txid);
-
     void SetBaseViewPtr(CBlockDBCache *pBaseIn) {
         txDiskPosCache.SetBase(&pBaseIn->txDiskPosCache);
+        addrTxIndexCache.SetBase(&pBaseIn->addrTxIndexCache);
         flagCache.SetBase(&pBaseIn->flagCache);
         bestBlockHashCache.SetBase(&pBaseIn->bestBlockHashCache);
         lastBlockFileCache.SetBase(&pBaseIn->lastBlockFileCache);
         reindexCache.SetBase(&pBaseIn->reindexCache);
         finalityBlockCache.SetBase(&pBaseIn->finalityBlockCache);
+        addrIndexCatchUpCache.SetBase(&pBaseIn->addrIndexCatchUpCache);
 
     };
 
     void SetDbOpLogMap(CDBOpLogMap *pDbOpLogMapIn) {
         txDiskPosCache.SetDbOpLogMap(pDbOpLogMapIn);
+        addrTxIndexCache.SetDbOpLogMap(pDbOpLogMapIn);
         flagCache.SetDbOpLogMap(pDbOpLogMapIn);
         bestBlockHashCache.SetDbOpLogMap(pDbOpLogMapIn);
         lastBlockFileCache.SetDbOpLogMap(pDbOpLogMapIn);
         reindexCache.SetDbOpLogMap(pDbOpLogMapIn);
         finalityBlockCache.SetDbOpLogMap(pDbOpLogMapIn);
+        addrIndexCatchUpCache.SetDbOpLogMap(pDbOpLogMapIn);
+    }
+
+    void SetJournal(CCacheJournal *pJournalIn) {
+        txDiskPosCache.SetJournal(pJournalIn);
+        addrTxIndexCache.SetJournal(pJournalIn);
+        flagCache.SetJournal(pJournalIn);
+        bestBlockHashCache.SetJournal(pJournalIn);
+        lastBlockFileCache.SetJournal(pJournalIn);
+        reindexCache.SetJournal(pJournalIn);
+        finalityBlockCache.SetJournal(pJournalIn);
+        addrIndexCatchUpCache.SetJournal(pJournalIn);
+    }
+
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn) {
+        txDiskPosCache.SetAccessSet(pAccessSetIn);
+        addrTxIndexCache.SetAccessSet(pAccessSetIn);
+        flagCache.SetAccessSet(pAccessSetIn);
+        bestBlockHashCache.SetAccessSet(pAccessSetIn);
+        lastBlockFileCache.SetAccessSet(pAccessSetIn);
+        reindexCache.SetAccessSet(pAccessSetIn);
+        finalityBlockCache.SetAccessSet(pAccessSetIn);
+        addrIndexCatchUpCache.SetAccessSet(pAccessSetIn);
     }
 
     void RegisterUndoFunc(UndoDataFuncMap &undoDataFuncMap) {
         txDiskPosCache.RegisterUndoFunc(undoDataFuncMap);
+        addrTxIndexCache.RegisterUndoFunc(undoDataFuncMap);
         flagCache.RegisterUndoFunc(undoDataFuncMap);
         bestBlockHashCache.RegisterUndoFunc(undoDataFuncMap);
         lastBlockFileCache.RegisterUndoFunc(undoDataFuncMap);
         reindexCache.RegisterUndoFunc(undoDataFuncMap);
         finalityBlockCache.RegisterUndoFunc(undoDataFuncMap);
+        addrIndexCatchUpCache.RegisterUndoFunc(undoDataFuncMap);
     }
 
     bool ReadTxIndex(const uint256 &txid, CDiskTxPos &pos);
     bool SetTxIndex(const uint256 &txid, const CDiskTxPos &pos);
     bool WriteTxIndexes(const vector<pair<uint256, CDiskTxPos> > &list);
 
+    bool SetAddrTxIndex(const CKeyID &keyId, uint32_t height, uint32_t index, const uint256 &txid);
+    shared_ptr<CAddrTxGetter> CreateAddrTxGetter() { return make_shared<CAddrTxGetter>(addrTxIndexCache); }
+
+    // the blocks below the height are still to be indexed by address, 0 if none
+    int32_t GetAddrIndexCatchUpHeight() const;
+    bool SetAddrIndexCatchUpHeight(int32_t height);
+
     bool ReadLastBlockFile(int32_t &nFile);
     bool WriteLastBlockFile(int nFile);
 
@@ -119,7 +196,9 @@ private:
 /*  CCompositeKVCache      prefixType               key                     value                 variable               */
 /*  ----------------   -------------------------   -----------------------  ------------------   ------------------------ */
     // txId -> DiskTxPos
-    CCompositeKVCache< dbk::TXID_DISKINDEX,         uint256,                  CDiskTxPos >          txDiskPosCache;
+    CHashKVCache<      dbk::TXID_DISKINDEX,         uint256,                  CDiskTxPos >          txDiskPosCache;
+    // keyId, MAX - height, MAX - index -> txid
+    AddrTxIndexCache                                                                                    addrTxIndexCache;
     // flag$name -> bool
     CCompositeKVCache< dbk::FLAG,                   string,                   bool>                 flagCache;
 
@@ -130,6 +209,7 @@ private:
     CSimpleKVCache< dbk::LAST_BLOCKFILE,            int>          lastBlockFileCache;
     CSimpleKVCache< dbk::REINDEX,                   bool>         reindexCache;
     CSimpleKVCache< dbk::FINALITY_BLOCK,            std::pair<int32_t,uint256>> finalityBlockCache ;
+    CSimpleKVCache< dbk::ADDR_INDEX_CATCHUP,        int32_t>      addrIndexCatchUpCache;
 };
 
 /** Create a new block index entry for a given block hash */
@@ -0,0 +1,142 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockfilereader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "boost/filesystem.hpp"
+#include "commons/util/util.h"
+#include "logging.h"
+
+class CBlockFileReader::CFileHandle {
+public:
+    explicit CFileHandle(int fdIn) : fd(fdIn) {}
+    ~CFileHandle() { close(fd); }
+
+    const int fd;
+};
+
+std::shared_ptr<CBlockFileReader::CFileHandle> CBlockFileReader::GetHandle(int32_t nFile) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::shared_ptr<CFileHandle> *pspHandle = handles.find(nFile);
+    if (pspHandle != nullptr)
+        return *pspHandle;
+
+    boost::filesystem::path path = GetDataDir() / "blocks" / strprintf("%s%05u.dat", prefix, nFile);
+    int fd = open(path.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LogPrint(BCLog::ERROR, "Unable to open file %s: %s\n", path.string(), strerror(errno));
+        return nullptr;
+    }
+
+    // an evicted handle is closed by its last reader
+    auto spHandle = std::make_shared<CFileHandle>(fd);
+    handles.insert(nFile, spHandle, 1);
+    return spHandle;
+}
+
+int64_t CBlockFileReader::Read(int32_t nFile, uint64_t pos, char *pch, size_t size) {
+    std::shared_ptr<CFileHandle> spHandle = GetHandle(nFile);
+    if (spHandle == nullptr)
+        return -1;
+
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = pread(spHandle->fd, pch + done, size - done, pos + done);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            LogPrint(BCLog::ERROR, "Unable to read %u bytes at position %u of %s%05u.dat: %s\n", size, pos, prefix,
+                     nFile, strerror(errno));
+            return -1;
+        }
+        if (n == 0)  // end of file
+            break;
+        done += n;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CBlockFileReadStats &fileStats = stats[nFile];
+    fileStats.reads++;
+    fileStats.bytes += done;
+    return done;
+}
+
+void CBlockFileReader::WillNeed(int32_t nFile, uint64_t pos, uint64_t size) {
+#ifdef POSIX_FADV_WILLNEED
+    std::shared_ptr<CFileHandle> spHandle = GetHandle(nFile);
+    if (spHandle != nullptr)
+        posix_fadvise(spHandle->fd, pos, size, POSIX_FADV_WILLNEED);
+#endif
+}
+
+void CBlockFileReader::CloseAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    handles.clear();
+}
+
+size_t CBlockFileReader::GetOpenCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return handles.size();
+}
+
+std::map<int32_t, CBlockFileReadStats> CBlockFileReader::GetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+CBlockFileReader &GetBlockFileReader() {
+    static CBlockFileReader reader;
+    return reader;
+}
+
+CBlockFileReader &GetUndoFileReader() {
+    static CBlockFileReader reader("rev");
+    return reader;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class CBlockFileStream
+
+CBlockFileStream &CBlockFileStream::read(char *pch, size_t nSize) {
+    while (nSize > 0) {
+        if (nReadPos == vchBuf.size()) {
+            vchBuf.resize(std::max(nChunkSize, nSize));
+            int64_t n = GetBlockFileReader().Read(nFile, nFilePos, vchBuf.data(), vchBuf.size());
+            if (n <= 0) {
+                vchBuf.clear();
+                nReadPos = 0;
+                throw std::ios_base::failure(n < 0 ? "CBlockFileStream::read : read failed"
+                                                   : "CBlockFileStream::read : end of file");
+            }
+            vchBuf.resize(n);
+            nFilePos += n;
+            nReadPos   = 0;
+            nChunkSize = BLOCK_FILE_READ_CHUNK_SIZE;
+        }
+
+        size_t nNow = std::min(nSize, vchBuf.size() - nReadPos);
+        memcpy(pch, &vchBuf[nReadPos], nNow);
+        nReadPos += nNow;
+        pch += nNow;
+        nSize -= nNow;
+    }
+    return *this;
+}
+
+void CBlockFileStream::ignore(uint64_t nSize) {
+    size_t nBuffered = vchBuf.size() - nReadPos;
+    if (nSize <= nBuffered) {
+        nReadPos += nSize;
+        return;
+    }
+
+    nFilePos += nSize - nBuffered;
+    vchBuf.clear();
+    nReadPos = 0;
+}
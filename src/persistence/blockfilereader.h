@@ -0,0 +1,110 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef PERSIST_BLOCKFILEREADER_H
+#define PERSIST_BLOCKFILEREADER_H
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "commons/clockcache.h"
+#include "commons/serialize.h"
+#include "disk.h"
+
+// the read-only handles of the block files kept open
+static const size_t MAX_BLOCK_FILE_READ_HANDLES = 64;
+// the bytes read at once by CBlockFileStream, if the size to read is not known
+static const size_t BLOCK_FILE_READ_CHUNK_SIZE = 4096;
+
+struct CBlockFileReadStats {
+    uint64_t reads = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * Positional reads of the block files (blk?????.dat) for the readers of the stored blocks and txs,
+ * e.g. the rpc calls of the explorers, or of the undo files (rev?????.dat) for disconnecting blocks.
+ * The read-only handles of the recently read files are kept open, the reads are pread()s at their
+ * positions, so that the readers share the handles without seeking and without cs_main. The blocks
+ * are only appended to the files, a handle sees the blocks written after it was opened.
+ */
+class CBlockFileReader {
+public:
+    explicit CBlockFileReader(const std::string &prefixIn = "blk")
+        : prefix(prefixIn), handles(MAX_BLOCK_FILE_READ_HANDLES) {}
+
+    // read up to size bytes at pos of the block file, return the bytes read, -1 on error
+    int64_t Read(int32_t nFile, uint64_t pos, char *pch, size_t size);
+
+    // advise the kernel that the range of the block file is going to be read, so that it is read
+    // ahead in the background, a no-op where posix_fadvise() is not supported
+    void WillNeed(int32_t nFile, uint64_t pos, uint64_t size);
+
+    // close the kept handles, e.g. on shutdown
+    void CloseAll();
+
+    size_t GetOpenCount();
+    std::map<int32_t, CBlockFileReadStats> GetStats();
+
+private:
+    class CFileHandle;
+
+    std::shared_ptr<CFileHandle> GetHandle(int32_t nFile);
+
+    const std::string prefix;  // of the file names
+
+    std::mutex mutex;
+    clockcache<int32_t, std::shared_ptr<CFileHandle>> handles;
+    std::map<int32_t, CBlockFileReadStats> stats;
+};
+
+CBlockFileReader &GetBlockFileReader();
+CBlockFileReader &GetUndoFileReader();
+
+/** Stream deserializing a block file from a position, read through CBlockFileReader */
+class CBlockFileStream {
+public:
+    int nType;
+    int nVersion;
+
+    CBlockFileStream(const CDiskBlockPos &pos, int nTypeIn, int nVersionIn)
+        : nType(nTypeIn), nVersion(nVersionIn), nFile(pos.nFile), nFilePos(pos.nPos),
+          nChunkSize(BLOCK_FILE_READ_CHUNK_SIZE) {}
+
+    int GetType() const { return nType; }
+    int GetVersion() const { return nVersion; }
+
+    CBlockFileStream &read(char *pch, size_t nSize);
+
+    // the next nSize bytes are going to be read, e.g. a whole block, read them from the file at once
+    void ReadAhead(size_t nSize) {
+        size_t nBuffered = vchBuf.size() - nReadPos;
+        if (nSize > nBuffered)
+            nChunkSize = std::max(nSize - nBuffered, BLOCK_FILE_READ_CHUNK_SIZE);
+    }
+
+    // skip the next nSize bytes
+    void ignore(uint64_t nSize);
+
+    template <typename T>
+    CBlockFileStream &operator>>(T &obj) {
+        ::Unserialize(*this, obj, nType, nVersion);
+        return *this;
+    }
+
+private:
+    int32_t nFile;
+    uint64_t nFilePos;          // position of the end of the buffer in the file
+    size_t nChunkSize;          // size of the next read from the file
+    std::vector<char> vchBuf;
+    size_t nReadPos = 0;        // position of the next byte in the buffer
+};
+
+#endif  // PERSIST_BLOCKFILEREADER_H
@@ -0,0 +1,108 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockprefetcher.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "blockfilereader.h"
+#include "commons/util/util.h"
+
+// the file ranges spread wider are left to the reads, e.g. the blocks of a chain interleaved with forks
+static const uint64_t MAX_BLOCK_READAHEAD_SIZE = 32 << 20;
+
+CBlockPrefetcher::CBlockPrefetcher(const std::vector<CBlockIndex *> &indexesIn, size_t depthIn)
+    : indexes(indexesIn), depth(std::max<size_t>(depthIn, 1)) {
+    if (!indexes.empty())
+        thread = std::thread(&CBlockPrefetcher::PrefetchLoop, this);
+}
+
+CBlockPrefetcher::~CBlockPrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    freedCond.notify_all();
+    if (thread.joinable())
+        thread.join();
+}
+
+bool CBlockPrefetcher::Next(CBlockIndex *&pIndex, CBlock &block) {
+    if (nextIndex == indexes.size()) {
+        pIndex = nullptr;
+        return false;
+    }
+
+    CPrefetchedBlock item;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        filledCond.wait(lock, [&]() { return !prefetched.empty(); });
+        item = std::move(prefetched.front());
+        prefetched.pop_front();
+    }
+    freedCond.notify_all();
+
+    pIndex = indexes[nextIndex++];
+    if (!item.fRead) {
+        nextIndex = indexes.size();  // the helper thread stopped at the failed block
+        return false;
+    }
+
+    block = std::move(item.block);
+    return true;
+}
+
+void CBlockPrefetcher::PrefetchLoop() {
+    RenameThread("coin-prefetch");
+
+    for (size_t i = 0; i < indexes.size(); i++) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            freedCond.wait(lock, [&]() { return stopping || prefetched.size() < depth; });
+            if (stopping)
+                return;
+        }
+
+        if (i % (BLOCK_READAHEAD_COUNT / 2) == 0)
+            AdviseReadAhead(i);
+
+        CPrefetchedBlock item;
+        item.fRead = ReadBlockFromDisk(indexes[i], item.block);
+        bool fRead = item.fRead;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            prefetched.push_back(std::move(item));
+        }
+        filledCond.notify_all();
+
+        if (!fRead)
+            return;
+    }
+}
+
+void CBlockPrefetcher::AdviseReadAhead(size_t begin) {
+    // the range of the block positions per file, the windows overlap by half so that the blocks
+    // past the last advised position are in the next window
+    std::map<int32_t, std::pair<uint64_t, uint64_t>> ranges;
+    size_t end = std::min(begin + BLOCK_READAHEAD_COUNT, indexes.size());
+    for (size_t i = begin; i < end; i++) {
+        CDiskBlockPos pos = indexes[i]->GetBlockPos();
+        if (pos.IsNull())
+            continue;
+
+        auto ret = ranges.emplace(pos.nFile, std::make_pair(pos.nPos, pos.nPos));
+        if (!ret.second) {
+            ret.first->second.first  = std::min<uint64_t>(ret.first->second.first, pos.nPos);
+            ret.first->second.second = std::max<uint64_t>(ret.first->second.second, pos.nPos);
+        }
+    }
+
+    for (const auto &item : ranges) {
+        uint64_t size = item.second.second - item.second.first + BLOCK_FILE_READ_CHUNK_SIZE;
+        if (size <= MAX_BLOCK_READAHEAD_SIZE)
+            GetBlockFileReader().WillNeed(item.first, item.second.first, size);
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef PERSIST_BLOCKPREFETCHER_H
+#define PERSIST_BLOCKPREFETCHER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "persistence/block.h"
+
+// the blocks read and decoded ahead of the reader of CBlockPrefetcher
+static const size_t BLOCK_PREFETCH_DEPTH = 16;
+// the blocks whose file ranges are advised to the kernel at once
+static const size_t BLOCK_READAHEAD_COUNT = 256;
+
+/**
+ * Reads the blocks of a list of block indexes in order, e.g. when replaying the chain for verifydb
+ * or for reloading the tx cache. A helper thread reads and decodes the blocks up to
+ * BLOCK_PREFETCH_DEPTH blocks ahead of the reader, and advises the kernel of the block file ranges
+ * of the next BLOCK_READAHEAD_COUNT blocks, so that the files are read ahead in the background
+ * while the reader processes the blocks. The indexes may be in any order, e.g. from the tip down.
+ *
+ *     CBlockPrefetcher prefetcher(indexes);
+ *     CBlockIndex *pIndex;
+ *     CBlock block;
+ *     while (prefetcher.Next(pIndex, block)) { ... }
+ *     if (pIndex != nullptr) { the block of pIndex can not be read }
+ *
+ * The indexes must not be freed until the prefetcher is destroyed. The reader may stop before the
+ * end, the helper thread is stopped by the destructor.
+ */
+class CBlockPrefetcher {
+public:
+    explicit CBlockPrefetcher(const std::vector<CBlockIndex *> &indexesIn, size_t depthIn = BLOCK_PREFETCH_DEPTH);
+    ~CBlockPrefetcher();
+
+    // get the next block and its index, return false at the end, when pIndex is nullptr, or when
+    // the block of pIndex can not be read
+    bool Next(CBlockIndex *&pIndex, CBlock &block);
+
+private:
+    struct CPrefetchedBlock {
+        CBlock block;
+        bool fRead = false;
+    };
+
+    void PrefetchLoop();
+    // advise the kernel of the file ranges of the blocks from the index of indexes
+    void AdviseReadAhead(size_t begin);
+
+    const std::vector<CBlockIndex *> indexes;
+    const size_t depth;
+    size_t nextIndex = 0;  // the index of the block returned by the next Next()
+
+    std::mutex mutex;
+    std::condition_variable filledCond;  // a block is prefetched
+    std::condition_variable freedCond;   // a prefetched block is taken
+    std::deque<CPrefetchedBlock> prefetched;
+    bool stopping = false;
+    std::thread thread;
+};
+
+#endif  // PERSIST_BLOCKPREFETCHER_H
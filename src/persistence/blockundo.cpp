@@ -4,6 +4,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "blockundo.h"
+
+#include <string.h>
+
+#include "blockfilereader.h"
 #include "main.h"
 
 /** Open an undo file (rev?????.dat) */
@@ -24,14 +28,17 @@ string CTxUndo::ToString() const {
 ////////////////////////////////////////////////////////////////////////////////
 // class CBlockUndo
 
-bool CBlockUndo::WriteToDisk(CDiskBlockPos &pos, const uint256 &blockHash) {
+bool CBlockUndo::WriteToDisk(CDiskBlockPos &pos, const uint256 &blockHash, const CDataStream &ssUndo) {
+    if (ssUndo.empty() || ssUndo.size() > MAX_SIZE)
+        return ERRORMSG("CBlockUndo::WriteToDisk : invalid undo data size %u", ssUndo.size());
+
     // Open history file to append
     CAutoFile fileout = CAutoFile(OpenUndoFile(pos), SER_DISK, CLIENT_VERSION);
     if (!fileout)
         return ERRORMSG("CBlockUndo::WriteToDisk : OpenUndoFile failed");
 
     // Write index header
-    uint32_t nSize = fileout.GetSerializeSize(*this);
+    uint32_t nSize = ssUndo.size();
     fileout << FLATDATA(SysCfg().MessageStart()) << nSize;
 
     // Write undo data
@@ -39,12 +46,12 @@ bool CBlockUndo::WriteToDisk(CDiskBlockPos &pos, const uint256 &blockHash) {
     if (fileOutPos < 0)
         return ERRORMSG("CBlockUndo::WriteToDisk : ftell failed");
     pos.nPos = (uint32_t)fileOutPos;
-    fileout << *this;
+    fileout.write(&ssUndo[0], ssUndo.size());
 
-    // calculate & write checksum
+    // calculate & write checksum, the written bytes are the serialized undo data as hashed before
     CHashWriter hasher(SER_GETHASH, PROTOCOL_VERSION);
     hasher << blockHash;
-    hasher << *this;
+    hasher.write(&ssUndo[0], ssUndo.size());
 
     fileout << hasher.GetHash();
 
@@ -57,27 +64,48 @@ bool CBlockUndo::WriteToDisk(CDiskBlockPos &pos, const uint256 &blockHash) {
 }
 
 bool CBlockUndo::ReadFromDisk(const CDiskBlockPos &pos, const uint256 &blockHash) {
-    // Open history file to read
-    CAutoFile filein = CAutoFile(OpenUndoFile(pos, true), SER_DISK, CLIENT_VERSION);
-    if (!filein)
-        return ERRORMSG("CBlockUndo::ReadFromDisk : OpenBlockFile failed");
+    // the undo data follows the message start and its size
+    static const uint32_t nPrefixSize = MESSAGE_START_SIZE + sizeof(uint32_t);
+    if (pos.IsNull() || pos.nPos < nPrefixSize)
+        return ERRORMSG("CBlockUndo::ReadFromDisk : invalid undo position");
+
+    CBlockFileReader &reader = GetUndoFileReader();
+    vector<char> vch(nPrefixSize);
+    if (reader.Read(pos.nFile, pos.nPos - nPrefixSize, vch.data(), vch.size()) != nPrefixSize)
+        return ERRORMSG("CBlockUndo::ReadFromDisk : failed to read the undo header");
 
-    // Read block
-    uint256 hashChecksum;
     try {
-        filein >> *this;
-        filein >> hashChecksum;
+        MessageStartChars messageStart;
+        uint32_t nSize;
+        CDataStream ssHeader(vch, SER_DISK, CLIENT_VERSION);
+        ssHeader >> FLATDATA(messageStart) >> nSize;
+        if (memcmp(messageStart, SysCfg().MessageStart(), MESSAGE_START_SIZE) != 0)
+            return ERRORMSG("CBlockUndo::ReadFromDisk : invalid undo header");
+
+        if (nSize > MAX_SIZE)
+            return ERRORMSG("CBlockUndo::ReadFromDisk : invalid undo data size %u", nSize);
+
+        // the undo data and its checksum at once
+        vch.resize(nSize + sizeof(uint256));
+        if (reader.Read(pos.nFile, pos.nPos, vch.data(), vch.size()) != (int64_t)vch.size())
+            return ERRORMSG("CBlockUndo::ReadFromDisk : failed to read the undo data");
+
+        uint256 hashChecksum;
+        memcpy(hashChecksum.begin(), &vch[nSize], sizeof(uint256));
+
+        // Verify checksum, of the bytes as read instead of the undo data serialized again
+        CHashWriter hasher(SER_GETHASH, PROTOCOL_VERSION);
+        hasher << blockHash;
+        hasher.write(&vch[0], nSize);
+        if (hashChecksum != hasher.GetHash())
+            return ERRORMSG("CBlockUndo::ReadFromDisk : Checksum mismatch");
+
+        CDataStream ss(vch.data(), vch.data() + nSize, SER_DISK, CLIENT_VERSION);
+        ss >> *this;
     } catch (std::exception &e) {
         return ERRORMSG("%s : Deserialize or I/O error - %s", __func__, e.what());
     }
 
-    // Verify checksum
-    CHashWriter hasher(SER_GETHASH, PROTOCOL_VERSION);
-    hasher << blockHash;
-    hasher << *this;
-
-    if (hashChecksum != hasher.GetHash())
-        return ERRORMSG("CBlockUndo::ReadFromDisk : Checksum mismatch");
     return true;
 }
 
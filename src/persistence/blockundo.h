@@ -49,7 +49,9 @@ public:
         READWRITE(vtxundo);
     )
 
-    bool WriteToDisk(CDiskBlockPos &pos, const uint256 &blockHash);
+    // append the serialized undo data to the undo file at pos, which is set to the position of the data.
+    // The data is serialized once by the caller, its bytes are written and hashed as they are
+    static bool WriteToDisk(CDiskBlockPos &pos, const uint256 &blockHash, const CDataStream &ssUndo);
 
     bool ReadFromDisk(const CDiskBlockPos &pos, const uint256 &blockHash);
 
@@ -69,7 +71,7 @@ public:
         cw.SetDbOpLogMap(&tx_undo.dbOpLogMap);
     }
     ~CTxUndoOpLogger() {
-        block_undo.vtxundo.push_back(tx_undo);
+        block_undo.vtxundo.push_back(std::move(tx_undo));
         cw.SetDbOpLogMap(nullptr);
     }
 };
@@ -64,6 +64,8 @@ void CCacheWrapper::CopyFrom(CCacheDBManager* pCdMan){
 
     txCache = *pCdMan->pTxCache;
     ppCache = *pCdMan->pPpCache;
+
+    SetJournal(&journal);
 }
 
 CCacheWrapper& CCacheWrapper::operator=(CCacheWrapper& other) {
@@ -83,10 +85,20 @@ CCacheWrapper& CCacheWrapper::operator=(CCacheWrapper& other) {
     this->txCache        = other.txCache;
     this->ppCache        = other.ppCache;
 
+    SetJournal(&journal);
     return *this;
 }
 
 void CCacheWrapper::Flush() {
+    FlushDbCaches();
+
+    txCache.Flush();
+    ppCache.Flush();
+}
+
+void CCacheWrapper::FlushDbCaches() {
+    assert(!journal.IsActive());
+
     sysParamCache.Flush();
     blockCache.Flush();
     accountCache.Flush();
@@ -97,9 +109,6 @@ void CCacheWrapper::Flush() {
     closedCdpCache.Flush();
     dexCache.Flush();
     txReceiptCache.Flush();
-
-    txCache.Flush();
-    ppCache.Flush();
 }
 
 void CCacheWrapper::SetDbOpLogMap(CDBOpLogMap *pDbOpLogMap) {
@@ -115,6 +124,46 @@ void CCacheWrapper::SetDbOpLogMap(CDBOpLogMap *pDbOpLogMap) {
     txReceiptCache.SetDbOpLogMap(pDbOpLogMap);
 }
 
+void CCacheWrapper::SetAccessSet(CCacheAccessSet *pAccessSet) {
+    sysParamCache.SetAccessSet(pAccessSet);
+    blockCache.SetAccessSet(pAccessSet);
+    accountCache.SetAccessSet(pAccessSet);
+    assetCache.SetAccessSet(pAccessSet);
+    contractCache.SetAccessSet(pAccessSet);
+    delegateCache.SetAccessSet(pAccessSet);
+    cdpCache.SetAccessSet(pAccessSet);
+    closedCdpCache.SetAccessSet(pAccessSet);
+    dexCache.SetAccessSet(pAccessSet);
+    txReceiptCache.SetAccessSet(pAccessSet);
+}
+
+void CCacheWrapper::SetJournal(CCacheJournal *pJournal) {
+    sysParamCache.SetJournal(pJournal);
+    blockCache.SetJournal(pJournal);
+    accountCache.SetJournal(pJournal);
+    assetCache.SetJournal(pJournal);
+    contractCache.SetJournal(pJournal);
+    delegateCache.SetJournal(pJournal);
+    cdpCache.SetJournal(pJournal);
+    closedCdpCache.SetJournal(pJournal);
+    dexCache.SetJournal(pJournal);
+    txReceiptCache.SetJournal(pJournal);
+
+    ppCache.SetJournal(pJournal);
+}
+
+size_t CCacheWrapper::Savepoint() {
+    // the sub-caches may have been copied from another wrapper, attach them to our journal again
+    if (!journal.IsActive())
+        SetJournal(&journal);
+
+    return journal.Savepoint();
+}
+
+void CCacheWrapper::ReleaseSavepoint() { journal.ReleaseSavepoint(); }
+
+void CCacheWrapper::RollbackTo(size_t savepoint) { journal.RollbackTo(savepoint); }
+
 UndoDataFuncMap CCacheWrapper::GetUndoDataFuncMap() {
     UndoDataFuncMap undoDataFuncMap;
     sysParamCache.RegisterUndoFunc(undoDataFuncMap);
@@ -170,6 +219,12 @@ CCacheDBManager::CCacheDBManager(bool fReIndex, bool fMemory) {
     pReceiptDb      = new CDBAccess(dbDir, DBNameType::RECEIPT, false, fReIndex);
     pReceiptCache   = new CTxReceiptDBCache(pReceiptDb);
 
+    // keep the hot accounts, cdps and dex operators resident over the flushes of the top level caches
+    size_t stateCacheSize = std::max<int64_t>(0, SysCfg().GetArg("-statecache", DEFAULT_STATE_CACHE)) << 20;
+    pAccountCache->EnableCleanCache(stateCacheSize * 5 / 8);
+    pCdpCache->EnableCleanCache(stateCacheSize * 2 / 8);
+    pDexCache->EnableCleanCache(stateCacheSize * 1 / 8);
+
     // memory-only cache
     pTxCache        = new CTxMemCache();
     pPpCache        = new CPricePointMemCache();
@@ -239,3 +294,8 @@ bool CCacheDBManager::Flush() {
 
     return true;
 }
+
+vector<CDBAccess*> CCacheDBManager::GetDbAccessList() const {
+    return {pSysParamDb, pAccountDb, pAssetDb, pContractDb, pDelegateDb, pCdpDb,
+            pClosedCdpDb, pDexDb, pBlockDb, pLogDb, pReceiptDb};
+}
@@ -50,14 +50,59 @@ public:
     void CopyFrom(CCacheDBManager* pCdMan);
 
     void Flush();
+    // flush the db caches only, the tx and price point mem caches are left in this wrapper
+    void FlushDbCaches();
 
     UndoDataFuncMap GetUndoDataFuncMap();
 
     void SetDbOpLogMap(CDBOpLogMap *pDbOpLogMap);
+
+    // record the keys accessed through the db caches, see CCacheAccessSet
+    void SetAccessSet(CCacheAccessSet *pAccessSet);
+
+    /**
+     * Savepoints of the in-memory changes, the per-tx sandbox without a child CCacheWrapper: nothing
+     * to construct or flush when the tx succeeds, only a journal rewind when it fails.
+     * Savepoints can be nested, and must not Flush() while any savepoint is active.
+     */
+    size_t Savepoint();
+    // keep the changes after the latest savepoint
+    void ReleaseSavepoint();
+    // undo the changes after the savepoint and release it
+    void RollbackTo(size_t savepoint);
 private:
     CCacheWrapper(const CCacheWrapper&) = delete;
     CCacheWrapper& operator=(const CCacheWrapper&) = delete;
 
+    void SetJournal(CCacheJournal *pJournal);
+
+    CCacheJournal journal;
+};
+
+// rollback the changes of the cache wrapper made in the scope unless released
+class CCacheSavepoint {
+public:
+    explicit CCacheSavepoint(CCacheWrapper &cwIn) : cw(cwIn), savepoint(cwIn.Savepoint()) {}
+
+    ~CCacheSavepoint() {
+        if (!released)
+            cw.RollbackTo(savepoint);
+    }
+
+    void Release() {
+        if (!released) {
+            cw.ReleaseSavepoint();
+            released = true;
+        }
+    }
+
+private:
+    CCacheSavepoint(const CCacheSavepoint&) = delete;
+    CCacheSavepoint& operator=(const CCacheSavepoint&) = delete;
+
+    CCacheWrapper &cw;
+    size_t savepoint;
+    bool released = false;
 };
 
 class CCacheDBManager {
@@ -106,6 +151,8 @@ public:
     ~CCacheDBManager();
 
     bool Flush();
+
+    vector<CDBAccess*> GetDbAccessList() const;
 };  // CCacheDBManager
 
 #endif //PERSIST_CACHEWRAPPER_H
\ No newline at end of file
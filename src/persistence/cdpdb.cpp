@@ -137,7 +137,13 @@ bool CCdpDBCache::GetCdpListByCollateralRatio(const uint64_t collateralRatio, co
     string heightStr      = strprintf("%016x", 0);
     RatioCDPIdCache::KeyType endKey(strRatio, heightStr, uint256());
 
-    return ratioCDPIdCache.GetAllElements(endKey, userCdps);
+    CDBIterator<RatioCDPIdCache> it(ratioCDPIdCache);
+    for (it.First(); it.IsValid(); it.Next()) {
+        if (endKey < it.GetKey())
+            break;
+        userCdps.emplace(it.GetKey(), it.GetValue());
+    }
+    return true;
 }
 
 uint64_t CCdpDBCache::GetGlobalStakedBcoins() const {
@@ -187,6 +193,22 @@ void CCdpDBCache::SetDbOpLogMap(CDBOpLogMap *pDbOpLogMapIn) {
     ratioCDPIdCache.SetDbOpLogMap(pDbOpLogMapIn);
 }
 
+void CCdpDBCache::SetJournal(CCacheJournal *pJournalIn) {
+    globalStakedBcoinsCache.SetJournal(pJournalIn);
+    globalOwedScoinsCache.SetJournal(pJournalIn);
+    cdpCache.SetJournal(pJournalIn);
+    regId2CDPCache.SetJournal(pJournalIn);
+    ratioCDPIdCache.SetJournal(pJournalIn);
+}
+
+void CCdpDBCache::SetAccessSet(CCacheAccessSet *pAccessSetIn) {
+    globalStakedBcoinsCache.SetAccessSet(pAccessSetIn);
+    globalOwedScoinsCache.SetAccessSet(pAccessSetIn);
+    cdpCache.SetAccessSet(pAccessSetIn);
+    regId2CDPCache.SetAccessSet(pAccessSetIn);
+    ratioCDPIdCache.SetAccessSet(pAccessSetIn);
+}
+
 uint32_t CCdpDBCache::GetCacheSize() const {
     return globalStakedBcoinsCache.GetCacheSize() + globalOwedScoinsCache.GetCacheSize() + cdpCache.GetCacheSize() +
            regId2CDPCache.GetCacheSize() + ratioCDPIdCache.GetCacheSize();
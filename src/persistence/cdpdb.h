@@ -9,6 +9,7 @@
 #include "commons/uint256.h"
 #include "entities/cdp.h"
 #include "dbaccess.h"
+#include "dbiterator.h"
 
 #include <map>
 #include <set>
@@ -51,6 +52,8 @@ public:
 
     void SetBaseViewPtr(CCdpDBCache *pBaseIn);
     void SetDbOpLogMap(CDBOpLogMap * pDbOpLogMapIn);
+    void SetJournal(CCacheJournal *pJournalIn);
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn);
 
     void RegisterUndoFunc(UndoDataFuncMap &undoDataFuncMap) {
         globalStakedBcoinsCache.RegisterUndoFunc(undoDataFuncMap);
@@ -63,6 +66,11 @@ public:
     uint32_t GetCacheSize() const;
     bool Flush();
 
+    void EnableCleanCache(size_t maxUsage) {
+        cdpCache.EnableCleanCache(maxUsage * 3 / 4);
+        regId2CDPCache.EnableCleanCache(maxUsage / 4);
+    }
+
 private:
     bool SaveCDPToDB(const CUserCDP &cdp);
     bool EraseCDPFromDB(const CUserCDP &cdp);
@@ -80,7 +88,7 @@ private:
     /*  CCompositeKVCache     prefixType     key                            value             variable  */
     /*  ----------------   --------------   ------------                --------------    ----- --------*/
     // cdp{$cdpid} -> CUserCDP
-    CCompositeKVCache<      dbk::CDP,       uint256,                    CUserCDP>           cdpCache;
+    CHashKVCache<           dbk::CDP,       uint256,                    CUserCDP>           cdpCache;
     // rcdp${CRegID} -> set<cdpid>
     CCompositeKVCache<      dbk::REGID_CDP, string,                     set<uint256>>       regId2CDPCache;
     // cdpr{Ratio}{$cdpid} -> CUserCDP
@@ -138,6 +146,16 @@ public:
         closedTxCdpCache.SetDbOpLogMap(pDbOpLogMapIn);
     }
 
+    void SetJournal(CCacheJournal *pJournalIn) {
+        closedCdpTxCache.SetJournal(pJournalIn);
+        closedTxCdpCache.SetJournal(pJournalIn);
+    }
+
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn) {
+        closedCdpTxCache.SetAccessSet(pAccessSetIn);
+        closedTxCdpCache.SetAccessSet(pAccessSetIn);
+    }
+
     void RegisterUndoFunc(UndoDataFuncMap &undoDataFuncMap) {
         closedCdpTxCache.RegisterUndoFunc(undoDataFuncMap);
         closedTxCdpCache.RegisterUndoFunc(undoDataFuncMap);
@@ -146,9 +164,9 @@ private:
     /*  CCompositeKVCache     prefixType     key               value             variable  */
     /*  ----------------   --------------   ------------   --------------    ----- --------*/
     // ccdp${closed_cdpid} -> <closedCdpTxId, closeType>
-    CCompositeKVCache< dbk::CLOSED_CDP_TX, uint256, std::pair<uint256, uint8_t> > closedCdpTxCache;
+    CHashKVCache<      dbk::CLOSED_CDP_TX, uint256, std::pair<uint256, uint8_t> > closedCdpTxCache;
     // ctx${$closed_cdp_txid} -> <closedCdpId, closeType> (no-force-liquidation)
-    CCompositeKVCache< dbk::CLOSED_TX_CDP, uint256, std::pair<uint256, uint8_t> > closedTxCdpCache;
+    CHashKVCache<      dbk::CLOSED_TX_CDP, uint256, std::pair<uint256, uint8_t> > closedTxCdpCache;
 };
 
 #endif  // PERSIST_CDPDB_H
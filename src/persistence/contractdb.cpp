@@ -39,7 +39,15 @@ bool CContractDBCache::GetContract(const CRegID &contractRegId, CUniversalContra
 }
 
 bool CContractDBCache::GetContracts(map<string, CUniversalContract> &contracts) {
-    return contractCache.GetAllElements(contracts);
+    CDBIterator<decltype(contractCache)> it(contractCache);
+    for (it.First(); it.IsValid(); it.Next()) {
+        contracts.emplace(it.GetKey(), it.GetValue());
+    }
+    return true;
+}
+
+const CUniversalContract *CContractDBCache::GetContractPtr(const CRegID &contractRegId) {
+    return contractCache.GetDataPtr(contractRegId.ToRawString());
 }
 
 bool CContractDBCache::SaveContract(const CRegID &contractRegId, const CUniversalContract &contract) {
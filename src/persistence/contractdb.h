@@ -83,6 +83,8 @@ public:
 
     bool GetContract(const CRegID &contractRegId, CUniversalContract &contract);
     bool GetContracts(map<string, CUniversalContract> &contracts);
+    // the contract kept by the cache, not copied. nullptr if not found, valid until the cache is changed
+    const CUniversalContract *GetContractPtr(const CRegID &contractRegId);
     bool SaveContract(const CRegID &contractRegId, const CUniversalContract &contract);
     bool HaveContract(const CRegID &contractRegId);
     bool EraseContract(const CRegID &contractRegId);
@@ -112,6 +114,20 @@ public:
         contractTracesCache.SetDbOpLogMap(pDbOpLogMapIn);
     }
 
+    void SetJournal(CCacheJournal *pJournalIn) {
+        contractCache.SetJournal(pJournalIn);
+        contractDataCache.SetJournal(pJournalIn);
+        contractAccountCache.SetJournal(pJournalIn);
+        contractTracesCache.SetJournal(pJournalIn);
+    }
+
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn) {
+        contractCache.SetAccessSet(pAccessSetIn);
+        contractDataCache.SetAccessSet(pAccessSetIn);
+        contractAccountCache.SetAccessSet(pAccessSetIn);
+        contractTracesCache.SetAccessSet(pAccessSetIn);
+    }
+
     void RegisterUndoFunc(UndoDataFuncMap &undoDataFuncMap) {
         contractCache.RegisterUndoFunc(undoDataFuncMap);
         contractDataCache.RegisterUndoFunc(undoDataFuncMap);
@@ -127,12 +143,12 @@ private:
 /*  ----------------   -------------------------   -----------------------  ------------------   ------------------------ */
     /////////// ContractDB
     // contract $RegId.ToRawString() -> Contract
-    CCompositeKVCache< dbk::CONTRACT_DEF,         string,                   CUniversalContract >   contractCache;
+    CHashKVCache<      dbk::CONTRACT_DEF,         string,                   CUniversalContract >   contractCache;
 
     // pair<contractRegId, contractKey> -> contractData
     DBContractDataCache contractDataCache;
     // pair<contractRegId, accountKey> -> appUserAccount
-    CCompositeKVCache< dbk::CONTRACT_ACCOUNT,     pair<string, string>,     CAppUserAccount >      contractAccountCache;
+    CHashKVCache<      dbk::CONTRACT_ACCOUNT,     pair<string, string>,     CAppUserAccount >      contractAccountCache;
     // txid -> contract_traces
     CCompositeKVCache< dbk::CONTRACT_ACCOUNT,     uint256,                  string >      contractTracesCache;
 };
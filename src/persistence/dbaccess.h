@@ -6,12 +6,18 @@
 #ifndef PERSIST_DB_ACCESS_H
 #define PERSIST_DB_ACCESS_H
 
+#include "commons/clockcache.h"
+#include "commons/openhashmap.h"
+#include "commons/random.h"
 #include "commons/uint256.h"
+#include "crypto/siphash.h"
 #include "dbconf.h"
 #include "leveldbwrapper.h"
 
+#include <mutex>
 #include <string>
 #include <tuple>
+#include <unordered_set>
 #include <vector>
 
 using namespace std;
@@ -136,6 +142,151 @@ namespace db_util {
         T value; SetEmpty(value);
         return value;
     }
+
+    // hash functions for the keys of the hash-based caches, see CHashKVCache. The keys may be chosen
+    // by the users, e.g. the app user ids of the contracts, so they are SipHashed with a random salt of
+    // the process, or they could be crafted to make long probe sequences in the open addressing maps
+    struct CKeyHasher {
+        CKeyHasher() : k0(GetSalt().GetUint64(0)), k1(GetSalt().GetUint64(1)) {}
+
+        size_t operator()(const uint256 &key) const { return SipHashUint256(k0, k1, key); }
+
+        size_t operator()(const uint160 &key) const {
+            return CSipHasher(k0, k1).Write(key.begin(), key.size()).Finalize();
+        }
+
+        size_t operator()(const string &key) const {
+            return CSipHasher(k0, k1).Write((const unsigned char *)key.data(), key.size()).Finalize();
+        }
+
+        template<typename T1, typename T2>
+        size_t operator()(const std::pair<T1, T2> &key) const {
+            size_t hash = operator()(key.first);
+            return hash ^ (operator()(key.second) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+        }
+
+    private:
+        static const uint256 &GetSalt() {
+            static const uint256 salt = GetRandHash();
+            return salt;
+        }
+
+        uint64_t k0;
+        uint64_t k1;
+    };
+};
+
+// lookup stats of the top level cache of every prefix
+struct CDBCacheStats {
+    uint64_t hits          = 0; // found in the map data
+    uint64_t clean_hits    = 0; // found in the clean cache
+    uint64_t db_reads      = 0; // read from db
+    uint64_t clean_entries = 0;
+    uint64_t clean_usage   = 0;
+
+    bool IsEmpty() const { return hits == 0 && clean_hits == 0 && db_reads == 0 && clean_entries == 0; }
+
+    Object ToJsonObj() const {
+        uint64_t lookups = hits + clean_hits + db_reads;
+        Object obj;
+        obj.push_back(Pair("hits",          (int64_t)hits));
+        obj.push_back(Pair("clean_hits",    (int64_t)clean_hits));
+        obj.push_back(Pair("db_reads",      (int64_t)db_reads));
+        obj.push_back(Pair("hit_rate",      lookups == 0 ? 0.0 : double(hits + clean_hits) / lookups));
+        obj.push_back(Pair("clean_entries", (int64_t)clean_entries));
+        obj.push_back(Pair("clean_usage",   (int64_t)clean_usage));
+        return obj;
+    }
+};
+
+inline CDBCacheStats& GetDbCacheStats(dbk::PrefixType prefixType) {
+    static CDBCacheStats stats[dbk::PREFIX_COUNT + 1];
+    return stats[prefixType];
+}
+
+/**
+ * Journal of the in-memory changes of the caches made after the savepoints. The caches record a
+ * restore function with the old value of every change while a savepoint is active, so rolling back
+ * to a savepoint is just a rewind of the journal in reverse order, and releasing the outermost
+ * savepoint only drops the journal. Savepoints can be nested.
+ */
+class CCacheJournal {
+public:
+    typedef std::function<void()> RestoreFunc;
+
+    bool IsActive() const { return depth > 0; }
+
+    // return the mark of the new savepoint
+    size_t Savepoint() {
+        ++depth;
+        return restoreFuncs.size();
+    }
+
+    // keep the changes after the savepoint, the enclosing savepoint can still roll them back
+    void ReleaseSavepoint() {
+        assert(depth > 0);
+        if (--depth == 0)
+            restoreFuncs.clear();
+    }
+
+    // undo the changes after the savepoint and release it
+    void RollbackTo(size_t savepoint) {
+        assert(depth > 0 && savepoint <= restoreFuncs.size());
+        while (restoreFuncs.size() > savepoint) {
+            restoreFuncs.back()();
+            restoreFuncs.pop_back();
+        }
+        ReleaseSavepoint();
+    }
+
+    void AddRestoreFunc(RestoreFunc &&func) { restoreFuncs.push_back(std::move(func)); }
+
+private:
+    std::vector<RestoreFunc> restoreFuncs;
+    uint32_t depth = 0;
+};
+
+/**
+ * Keys read and written through the caches of one wrapper, in db key form with the prefix, for the
+ * validation of a tx executed speculatively. The read keys are recorded when they are looked up in
+ * the base caches, so every key in the wrapper, found or not, is a read key. The range reads and the
+ * writes of the simple caches can't be validated by keys, they mark the set untracked instead.
+ * The base caches are read under pBaseMutex if set, for the wrappers reading the same base from
+ * several threads.
+ */
+class CCacheAccessSet {
+public:
+    explicit CCacheAccessSet(std::mutex *pBaseMutexIn = nullptr) : pBaseMutex(pBaseMutexIn) {}
+
+    void AddRead(std::string &&key) { readKeys.insert(std::move(key)); }
+    void AddWrite(std::string &&key) { writeKeys.insert(std::move(key)); }
+    void SetUntracked() { untracked = true; }
+
+    bool IsUntracked() const { return untracked; }
+    const std::unordered_set<std::string> &GetWriteKeys() const { return writeKeys; }
+
+    // whether any key read or written is in the keys written by others
+    bool IsConflict(const std::unordered_set<std::string> &writtenKeys) const {
+        for (const auto &key : readKeys) {
+            if (writtenKeys.count(key))
+                return true;
+        }
+        for (const auto &key : writeKeys) {
+            if (writtenKeys.count(key))
+                return true;
+        }
+        return false;
+    }
+
+    std::unique_lock<std::mutex> LockBase() const {
+        return pBaseMutex != nullptr ? std::unique_lock<std::mutex>(*pBaseMutex) : std::unique_lock<std::mutex>();
+    }
+
+private:
+    std::mutex *pBaseMutex;
+    std::unordered_set<std::string> readKeys;
+    std::unordered_set<std::string> writeKeys;
+    bool untracked = false;
 };
 
 typedef void(UndoDataFunc)(const CDbOpLogs &pDbOpLogs);
@@ -202,134 +353,16 @@ public:
         return true;
     }
 
-    template <typename KeyType, typename ValueType>
-    bool GetAllElements(const dbk::PrefixType prefixType, map<KeyType, ValueType> &elements) {
-        KeyType key;
-        ValueType value;
-        shared_ptr<leveldb::Iterator> pCursor = NewIterator();
-
-        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
-        const string &prefix = dbk::GetKeyPrefix(prefixType);
-        ssKey.write(prefix.c_str(), prefix.size());
-        pCursor->Seek(ssKey.str());
-
-        for (; pCursor->Valid(); pCursor->Next()) {
-            boost::this_thread::interruption_point();
-
-            try {
-                const auto &slKey = pCursor->key();
-                if (!dbk::ParseDbKey(slKey, prefixType, key)) {
-                    break;
-                }
-
-                // Got an valid element.
-                const auto &slValue = pCursor->value();
-                CDataStream ds(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
-                ds >> value;
-                auto ret = elements.emplace(key, value);
-                if (!ret.second)
-                    throw runtime_error(strprintf("%s :  %s, alloc new cache item failed", __FUNCTION__, __LINE__));
-            } catch (std::exception &e) {
-                return ERRORMSG("%s : Deserialize or I/O error - %s", __FUNCTION__, e.what());
-            }
-        }
-
-        return true;
-    }
-
-    // GetAllElements
-    // support input end key
-    template <typename KeyType, typename ValueType>
-    bool GetAllElements(const dbk::PrefixType prefixType, const KeyType &endKey,
-                        map<KeyType, ValueType> &elements, set<KeyType> &expiredKeys) {
-
-        KeyType key;
-        ValueType value;
-        shared_ptr<leveldb::Iterator> pCursor = NewIterator();
-        const string &prefixStr = dbk::GetKeyPrefix(prefixType);
-
-        for (pCursor->Seek(prefixStr); pCursor->Valid(); pCursor->Next()) {
-            boost::this_thread::interruption_point();
-
-            try {
-                leveldb::Slice slKey = pCursor->key();
-                if (!dbk::ParseDbKey(slKey, prefixType, key)) { // the rest key is other prefix type
-                    break;
-                }
-
-                if (endKey < key)
-                    break;
-
-                if (expiredKeys.count(key) || elements.count(key)) // key exists in cache
-                    continue;
-
-                // Got an valid element.
-                leveldb::Slice slValue = pCursor->value();
-                CDataStream ds(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
-                ds >> value;
-                auto ret = elements.emplace(key, value);
-                if (!ret.second)
-                    throw runtime_error(strprintf("%s :  %s, alloc new cache item failed", __FUNCTION__, __LINE__));
-
-            } catch (std::exception &e) {
-                return ERRORMSG("%s : Deserialize or I/O error - %s", __FUNCTION__, e.what());
-            }
-        }
-
-        return true;
-    }
-
-    template <typename KeyType, typename ValueType>
-    bool GetAllElements(const dbk::PrefixType prefixType, set<KeyType> &expiredKeys,
-                        map<KeyType, ValueType> &elements) {
-        KeyType key;
-        ValueType value;
-        shared_ptr<leveldb::Iterator> pCursor = NewIterator();
-        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
-        const string &prefix = dbk::GetKeyPrefix(prefixType);
-        ssKey.write(prefix.c_str(), prefix.size());
-        pCursor->Seek(ssKey.str());
-
-        for (; pCursor->Valid(); pCursor->Next()) {
-            boost::this_thread::interruption_point();
-
-            try {
-                leveldb::Slice slKey = pCursor->key();
-                if (!dbk::ParseDbKey(slKey, prefixType, key)) {
-                    break;
-                }
-
-                if (expiredKeys.count(key)) {
-                    continue;
-                } else if (elements.count(key)) {
-                    // skip it if the element existed in memory cache(upper level cache)
-                    continue;
-                } else {
-                    // Got an valid element.
-                    leveldb::Slice slValue = pCursor->value();
-                    CDataStream ds(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
-                    ds >> value;
-                    auto ret = elements.emplace(key, value);
-                    if (!ret.second)
-                        throw runtime_error(strprintf("%s :  %s, alloc new cache item failed", __FUNCTION__, __LINE__));
-                }
-            } catch (std::exception &e) {
-                return ERRORMSG("%s : Deserialize or I/O error - %s", __FUNCTION__, e.what());
-            }
-        }
-
-        return true;
-    }
-
     template<typename KeyType, typename ValueType>
     bool HaveData(const dbk::PrefixType prefixType, const KeyType &key) const {
         string keyStr = dbk::GenDbKey(prefixType, key);
         return db.Exists(keyStr);
     }
 
-    template<typename KeyType, typename ValueType>
-    void BatchWrite(const dbk::PrefixType prefixType, const map<KeyType, ValueType> &mapData) {        CLevelDBBatch batch;
-        for (auto item : mapData) {
+    template<typename KeyType, typename ValueType, typename MapType = map<KeyType, ValueType>>
+    void BatchWrite(const dbk::PrefixType prefixType, const MapType &mapData) {
+        CLevelDBBatch batch;
+        for (const auto &item : mapData) {
             string key = dbk::GenDbKey(prefixType, item.first);
             if (db_util::IsEmpty(item.second)) {
                 batch.Erase(key);
@@ -355,6 +388,25 @@ public:
 
     DBNameType GetDbNameType() const { return dbNameType; }
 
+    // leveldb stats and approximate on-disk size of every prefix stored in this db
+    Object ToJsonObj() const {
+        Object obj = db.ToJsonObj();
+        Object prefixSizes;
+        Object cacheStats;
+        for (int32_t i = dbk::EMPTY + 1; i < dbk::PREFIX_COUNT; i++) {
+            if (dbk::kDbPrefix2DbName[i] != dbNameType) continue;
+
+            const string &prefix = dbk::GetKeyPrefix((dbk::PrefixType)i);
+            prefixSizes.push_back(Pair(prefix, (int64_t)db.GetApproximateSize(prefix, prefix + "\xff")));
+            const CDBCacheStats &stats = GetDbCacheStats((dbk::PrefixType)i);
+            if (!stats.IsEmpty())
+                cacheStats.push_back(Pair(prefix, stats.ToJsonObj()));
+        }
+        obj.push_back(Pair("prefix_sizes", prefixSizes));
+        obj.push_back(Pair("cache_stats", cacheStats));
+        return obj;
+    }
+
     std::shared_ptr<leveldb::Iterator> NewIterator() {
         return std::shared_ptr<leveldb::Iterator>(db.NewIterator());
     }
@@ -363,15 +415,33 @@ private:
     mutable CLevelDBWrapper db; // // TODO: remove the mutable declare
 };
 
-template<int32_t PREFIX_TYPE_VALUE, typename __KeyType, typename __ValueType>
+/**
+ * The __MapType of the cache is std::map by default, which keeps the keys in order as needed by
+ * GetTopNElements(). The db iterators sort the keys of each layer by themselves, so caches not
+ * used by GetTopNElements() could be declared as CHashKVCache for faster point lookups.
+ * The top level cache could keep a clean cache of the flushed entries, see EnableCleanCache().
+ */
+template<int32_t PREFIX_TYPE_VALUE, typename __KeyType, typename __ValueType,
+         typename __MapType = std::map<__KeyType, __ValueType>>
 class CCompositeKVCache {
 public:
     static const dbk::PrefixType PREFIX_TYPE = (dbk::PrefixType)PREFIX_TYPE_VALUE;
 public:
     typedef __KeyType   KeyType;
     typedef __ValueType ValueType;
+    typedef __MapType   MapType;
     typedef typename std::map<KeyType, ValueType> Map;
-    typedef typename std::map<KeyType, ValueType>::iterator Iterator;
+    typedef typename MapType::iterator Iterator;
+    typedef typename std::conditional<std::is_same<MapType, Map>::value, std::map<KeyType, size_t>,
+        openhashmap<KeyType, size_t, db_util::CKeyHasher>>::type CleanIndexMap;
+    typedef clockcache<KeyType, ValueType, CleanIndexMap> CleanCache;
+
+    // estimated memory usage of an entry, the serialized size plus the overhead of the map node
+    static size_t GetEntryUsage(const KeyType &key, const ValueType &value) {
+        return sizeof(std::pair<KeyType, ValueType>) + 4 * sizeof(void*) +
+               ::GetSerializeSize(key, SER_DISK, CLIENT_VERSION) +
+               ::GetSerializeSize(value, SER_DISK, CLIENT_VERSION);
+    }
 
 public:
     /**
@@ -400,11 +470,40 @@ public:
         pDbOpLogMap = pDbOpLogMapIn;
     }
 
+    void SetJournal(CCacheJournal *pJournalIn) {
+        pJournal = pJournalIn;
+    }
+
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn) {
+        pAccessSet = pAccessSetIn;
+    }
+
+    // estimated memory usage of the map data, the clean cache is not included
     uint32_t GetCacheSize() const {
-        return ::GetSerializeSize(mapData, SER_DISK, CLIENT_VERSION);
+        return data_usage;
+    }
+
+    /**
+     * Keep the flushed entries of the top level cache in a clean cache bounded by maxUsage bytes,
+     * so that the hot entries survive the flushes instead of being read from db again.
+     */
+    void EnableCleanCache(size_t maxUsage) {
+        assert(pDbAccess != nullptr && "only support top level cache");
+        if (spCleanCache == nullptr)
+            spCleanCache = make_shared<CleanCache>(maxUsage);
+        else
+            spCleanCache->set_max_usage(maxUsage);
+        UpdateCleanStats();
+    }
+
+    size_t GetCleanCacheUsage() const {
+        return spCleanCache != nullptr ? spCleanCache->usage() : 0;
     }
 
     bool GetTopNElements(const uint32_t maxNum, set<KeyType> &keys) {
+        if (pAccessSet != nullptr)
+            pAccessSet->SetUntracked();
+
         // 1. Get all candidate elements.
         set<KeyType> expiredKeys;
         set<KeyType> candidateKeys;
@@ -425,27 +524,6 @@ public:
         return keys.size() == maxNum;
     }
 
-    // map<string, ValueType>
-    bool GetAllElements(const KeyType &endKey, Map &elements) {
-        set<KeyType> expiredKeys;
-        if (!GetAllElements(endKey, elements, expiredKeys)) {
-            // TODO: log
-            return false;
-        }
-
-        return true;
-    }
-
-    bool GetAllElements(map<KeyType, ValueType> &elements) {
-        set<KeyType> expiredKeys;
-        if (!GetAllElements(expiredKeys, elements)) {
-            // TODO: log
-            return false;
-        }
-
-        return true;
-    }
-
     bool GetData(const KeyType &key, ValueType &value) const {
         if (db_util::IsEmpty(key)) {
             return false;
@@ -458,11 +536,26 @@ public:
         return false;
     }
 
+    // the value kept by this cache without copying it, nullptr if not found. It is only valid until
+    // the cache is changed
+    const ValueType *GetDataPtr(const KeyType &key) const {
+        if (db_util::IsEmpty(key)) {
+            return nullptr;
+        }
+        auto it = GetDataIt(key);
+        if (it != mapData.end() && !db_util::IsEmpty(it->second))
+            return &it->second;
+
+        return nullptr;
+    }
+
     bool SetData(const KeyType &key, const ValueType &value) {
         if (db_util::IsEmpty(key)) {
             return false;
         }
         auto it = GetDataIt(key);
+        if (pAccessSet != nullptr)
+            pAccessSet->AddWrite(dbk::GenDbKey(PREFIX_TYPE, key));
         if (it == mapData.end()) {
             auto emptyValue = db_util::MakeEmptyValue<ValueType>();
             auto newRet = mapData.emplace(key, *emptyValue); // create new empty value
@@ -470,8 +563,11 @@ public:
                 throw runtime_error(strprintf("%s :  %s, alloc new cache item failed", __FUNCTION__, __LINE__));
 
             it = newRet.first;
+            data_usage += GetEntryUsage(key, it->second);
         }
         AddOpLog(key, it->second);
+        AddJournal(key, it->second);
+        data_usage += GetEntryUsage(key, value) - GetEntryUsage(key, it->second);
         it->second = value;
         return true;
     }
@@ -490,26 +586,41 @@ public:
         }
         Iterator it = GetDataIt(key);
         if (it != mapData.end() && !db_util::IsEmpty(it->second)) {
+            if (pAccessSet != nullptr)
+                pAccessSet->AddWrite(dbk::GenDbKey(PREFIX_TYPE, key));
             AddOpLog(key, it->second);
+            AddJournal(key, it->second);
+            data_usage -= GetEntryUsage(key, it->second);
             db_util::SetEmpty(it->second);
+            data_usage += GetEntryUsage(key, it->second);
         }
         return true;
     }
 
     void Clear() {
         mapData.clear();
+        data_usage = 0;
     }
 
     void Flush() {
         assert(pBase != nullptr || pDbAccess != nullptr);
         if (pBase != nullptr) {
             assert(pDbAccess == nullptr);
-            for (auto it : mapData) {
-                pBase->mapData[it.first] = it.second;
+            for (const auto &item : mapData) {
+                pBase->SetRawData(item.first, item.second);
             }
         } else if (pDbAccess != nullptr) {
             assert(pBase == nullptr);
             pDbAccess->BatchWrite<KeyType, ValueType>(PREFIX_TYPE, mapData);
+            if (spCleanCache != nullptr) {
+                for (const auto &item : mapData) {
+                    if (db_util::IsEmpty(item.second))
+                        spCleanCache->erase(item.first);
+                    else
+                        spCleanCache->insert(item.first, item.second, GetEntryUsage(item.first, item.second));
+                }
+                UpdateCleanStats();
+            }
         }
 
         Clear();
@@ -519,7 +630,7 @@ public:
         KeyType key;
         ValueType value;
         dbOpLog.Get(key, value);
-        mapData[key] = value;
+        SetRawData(key, value);
     }
 
     void UndoDataList(const CDbOpLogs &dbOpLogs) {
@@ -542,40 +653,76 @@ public:
         return pRet;
     }
 
-    CCompositeKVCache<PREFIX_TYPE, KeyType, ValueType>* GetBasePtr() { return pBase; }
+    CCompositeKVCache* GetBasePtr() { return pBase; }
 
-    map<KeyType, ValueType>& GetMapData() { return mapData; };
+    MapType& GetMapData() {
+        if (pAccessSet != nullptr)
+            pAccessSet->SetUntracked();
+        return mapData;
+    };
 private:
     Iterator GetDataIt(const KeyType &key) const {
         Iterator it = mapData.find(key);
         if (it != mapData.end()) {
+            if (pDbAccess != nullptr)
+                GetDbCacheStats(PREFIX_TYPE).hits++;
             return it;
         } else if (pBase != nullptr) {
+            std::unique_lock<std::mutex> baseLock;
+            if (pAccessSet != nullptr) {
+                pAccessSet->AddRead(dbk::GenDbKey(PREFIX_TYPE, key));
+                baseLock = pAccessSet->LockBase();
+            }
             // find key-value at base cache
             auto baseIt = pBase->GetDataIt(key);
             if (baseIt != pBase->mapData.end()) {
                 // the found key-value add to current mapData
-                auto newRet = mapData.emplace(key, baseIt->second);
-                if (!newRet.second)
-                    throw runtime_error(strprintf("%s :  %s, alloc new cache item failed", __FUNCTION__, __LINE__));
-
-                return newRet.first;
+                return AddData(key, baseIt->second);
             }
         } else if (pDbAccess != NULL) {
+            const ValueType *pCleanValue = spCleanCache != nullptr ? spCleanCache->find(key) : nullptr;
+            if (pCleanValue != nullptr) {
+                GetDbCacheStats(PREFIX_TYPE).clean_hits++;
+                return AddData(key, *pCleanValue);
+            }
+
             // TODO: need to save the empty value to mapData for search performance?
+            GetDbCacheStats(PREFIX_TYPE).db_reads++;
             auto pDbValue = db_util::MakeEmptyValue<ValueType>();
             if (pDbAccess->GetData(PREFIX_TYPE, key, *pDbValue)) {
-                auto newRet = mapData.emplace(key, *pDbValue);
-                if (!newRet.second)
-                    throw runtime_error(strprintf("%s :  %s, alloc new cache item failed", __FUNCTION__, __LINE__));
-
-                return newRet.first;
+                return AddData(key, *pDbValue);
             }
         }
 
         return mapData.end();
     }
 
+    Iterator AddData(const KeyType &key, const ValueType &value) const {
+        auto newRet = mapData.emplace(key, value);
+        if (!newRet.second)
+            throw runtime_error(strprintf("%s :  %s, alloc new cache item failed", __FUNCTION__, __LINE__));
+
+        data_usage += GetEntryUsage(key, value);
+        return newRet.first;
+    }
+
+    // set data without op log
+    void SetRawData(const KeyType &key, const ValueType &value) {
+        auto it = mapData.find(key);
+        if (it == mapData.end()) {
+            AddData(key, value);
+        } else {
+            data_usage += GetEntryUsage(key, value) - GetEntryUsage(key, it->second);
+            it->second = value;
+        }
+    }
+
+    void UpdateCleanStats() {
+        CDBCacheStats &stats = GetDbCacheStats(PREFIX_TYPE);
+        stats.clean_entries  = spCleanCache->size();
+        stats.clean_usage    = spCleanCache->usage();
+    }
+
     bool GetTopNElements(const uint32_t maxNum, set<KeyType> &expiredKeys, set<KeyType> &keys) {
         if (!mapData.empty()) {
             uint32_t count = 0;
@@ -605,53 +752,6 @@ private:
         return true;
     }
 
-    // map<string, ValueType>
-    bool GetAllElements(const KeyType &endKey, Map &mapDataOut, set<KeyType> &expiredKeys) {
-        if (!mapData.empty()) {
-            for (auto iter = mapData.begin(); iter != mapData.end() && iter->first < endKey; iter++) {
-                if (!expiredKeys.count(iter->first) && !mapDataOut.count(iter->first)) { // check not got
-                    if (db_util::IsEmpty(iter->second)) { // empty, will be deleted
-                        expiredKeys.insert(iter->first);
-                    } else { // Got a valid element.
-                        mapDataOut.emplace(iter->first, iter->second);
-                    }
-                }
-            }
-        }
-
-        if (pBase != nullptr) {
-            return pBase->GetAllElements(endKey, mapDataOut, expiredKeys);
-        } else if (pDbAccess != nullptr) {
-            return pDbAccess->GetAllElements(PREFIX_TYPE, endKey, mapDataOut, expiredKeys);
-        }
-
-        return true;
-    }
-
-    bool GetAllElements(set<KeyType> &expiredKeys, map<KeyType, ValueType> &elements) {
-        if (!mapData.empty()) {
-            for (auto iter : mapData) {
-                if (db_util::IsEmpty(iter.second)) {
-                    expiredKeys.insert(iter.first);
-                } else if (expiredKeys.count(iter.first) || elements.count(iter.first)) {
-                    // TODO: log
-                    continue;
-                } else {
-                    // Got a valid element.
-                    elements.insert(iter);
-                }
-            }
-        }
-
-        if (pBase != nullptr) {
-            return pBase->GetAllElements(expiredKeys, elements);
-        } else if (pDbAccess != nullptr) {
-            return pDbAccess->GetAllElements(PREFIX_TYPE, expiredKeys, elements);
-        }
-
-        return true;
-    }
-
     inline void AddOpLog(const KeyType &key, const ValueType &oldValue) {
         if (pDbOpLogMap != nullptr) {
             CDbOpLog dbOpLog;
@@ -660,13 +760,26 @@ private:
         }
 
     }
+
+    inline void AddJournal(const KeyType &key, const ValueType &oldValue) {
+        if (pJournal != nullptr && pJournal->IsActive()) {
+            pJournal->AddRestoreFunc([this, key, oldValue]() { SetRawData(key, oldValue); });
+        }
+    }
 private:
-    mutable CCompositeKVCache<PREFIX_TYPE, KeyType, ValueType> *pBase;
+    mutable CCompositeKVCache *pBase;
     CDBAccess *pDbAccess;
-    mutable map<KeyType, ValueType> mapData;
+    mutable MapType mapData;
+    mutable size_t data_usage = 0;
+    shared_ptr<CleanCache> spCleanCache = nullptr; // top level cache only
     CDBOpLogMap *pDbOpLogMap = nullptr;
+    CCacheJournal *pJournal = nullptr;
+    CCacheAccessSet *pAccessSet = nullptr;
 };
 
+template<int32_t PREFIX_TYPE_VALUE, typename KeyType, typename ValueType>
+using CHashKVCache = CCompositeKVCache<PREFIX_TYPE_VALUE, KeyType, ValueType,
+                                       openhashmap<KeyType, ValueType, db_util::CKeyHasher>>;
 
 template<int32_t PREFIX_TYPE_VALUE, typename __ValueType>
 class CSimpleKVCache {
@@ -703,6 +816,8 @@ public:
             ptrData = make_shared<ValueType>(*other.ptrData);
         }
         pDbOpLogMap = other.pDbOpLogMap;
+        pJournal = other.pJournal;
+        pAccessSet = other.pAccessSet;
         return *this;
     }
 
@@ -716,6 +831,14 @@ public:
         pDbOpLogMap = pDbOpLogMapIn;
     }
 
+    void SetJournal(CCacheJournal *pJournalIn) {
+        pJournal = pJournalIn;
+    }
+
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn) {
+        pAccessSet = pAccessSetIn;
+    }
+
     uint32_t GetCacheSize() const {
         if (!ptrData) {
             return 0;
@@ -734,6 +857,12 @@ public:
     }
 
     bool SetData(const ValueType &value) {
+        // the old value in the op log depends on whether this layer has loaded it
+        if (pAccessSet != nullptr) {
+            pAccessSet->AddWrite(string(dbk::GetKeyPrefix(PREFIX_TYPE)));
+            pAccessSet->SetUntracked();
+        }
+        AddJournal();
         if (!ptrData) {
             ptrData = db_util::MakeEmptyValue<ValueType>();
         }
@@ -750,7 +879,12 @@ public:
     bool EraseData() {
         auto ptr = GetDataPtr();
         if (ptr && !db_util::IsEmpty(*ptr)) {
+            if (pAccessSet != nullptr) {
+                pAccessSet->AddWrite(string(dbk::GetKeyPrefix(PREFIX_TYPE)));
+                pAccessSet->SetUntracked();
+            }
             AddOpLog(*ptr);
+            AddJournal();
             db_util::SetEmpty(*ptr);
         }
         return true;
@@ -798,6 +932,11 @@ private:
         if (ptrData) {
             return ptrData;
         } else if (pBase != nullptr){
+            std::unique_lock<std::mutex> baseLock;
+            if (pAccessSet != nullptr) {
+                pAccessSet->AddRead(string(dbk::GetKeyPrefix(PREFIX_TYPE)));
+                baseLock = pAccessSet->LockBase();
+            }
             auto ptr = pBase->GetDataPtr();
             if (ptr) {
                 ptrData = std::make_shared<ValueType>(*ptr);
@@ -823,11 +962,21 @@ private:
         }
 
     }
+
+    // restore the exact old state, including the unloaded one
+    inline void AddJournal() {
+        if (pJournal != nullptr && pJournal->IsActive()) {
+            auto oldData = ptrData ? std::make_shared<ValueType>(*ptrData) : nullptr;
+            pJournal->AddRestoreFunc([this, oldData]() { ptrData = oldData; });
+        }
+    }
 private:
     mutable CSimpleKVCache<PREFIX_TYPE, ValueType> *pBase;
     CDBAccess *pDbAccess;
     mutable std::shared_ptr<ValueType> ptrData = nullptr;
     CDBOpLogMap *pDbOpLogMap = nullptr;
+    CCacheJournal *pJournal = nullptr;
+    CCacheAccessSet *pAccessSet = nullptr;
 };
 
 #endif  // PERSIST_DB_ACCESS_H
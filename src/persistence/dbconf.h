@@ -58,7 +58,6 @@ inline const std::string& GetDbName(DBNameType dbNameType) {
 
 namespace dbk {
 
-
     //                 type        name(prefix)  db name             description
     //               ----------    ------------ -------------  -----------------------------------
     #define DBK_PREFIX_LIST(DEFINE) \
@@ -78,6 +77,8 @@ namespace dbk {
         DEFINE( FLAG,                 "flag",   BLOCK )         /* [prefix] --> $Flag = 1 | 0 */ \
         DEFINE( BEST_BLOCKHASH,       "bbkh",   BLOCK )         /* [prefix] --> $BestBlockHash */ \
         DEFINE( TXID_DISKINDEX,       "tidx",   BLOCK )      /* tidx{$txid} --> $DiskTxPos */ \
+        DEFINE( KEYID_TXID_INDEX,     "ktix",   BLOCK )         /* ktix{$KeyId}{MAX - $height}{MAX - $index} --> $txid */ \
+        DEFINE( ADDR_INDEX_CATCHUP,   "aicu",   BLOCK )         /* [prefix] --> $height, the blocks below are not address indexed yet */ \
         /**** account db                                                                      */ \
         DEFINE( REGID_KEYID,          "rkey",   ACCOUNT )       /* rkey{$RegID} --> $KeyId */ \
         DEFINE( NICKID_KEYID,         "nkey",   ACCOUNT )       /* nkey{$NickID} --> $KeyId */ \
@@ -8,6 +8,12 @@
 
 #include "dbaccess.h"
 
+#include <algorithm>
+
+/**
+ * All the iterators walk the keys in the order of the serialized db keys, the same order as leveldb,
+ * so that the cache layers and the db can be merged lazily without materializing the elements.
+ */
 template<typename CacheType>
 class CDBBaseIterator {
 public:
@@ -17,6 +23,7 @@ public:
     CacheType &db_cache;
     shared_ptr<KeyType> sp_key = nullptr;
     shared_ptr<ValueType> sp_value = nullptr;
+    shared_ptr<string> sp_db_key = nullptr; // serialized key with prefix, used to merge the layers
     bool is_valid = false;
 
 public:
@@ -24,6 +31,7 @@ public:
         : db_cache(dbCache),
           sp_key(make_shared<KeyType>()),
           sp_value(make_shared<ValueType>()),
+          sp_db_key(make_shared<string>()),
           is_valid(false) {}
 
     virtual bool First() = 0;
@@ -101,12 +109,14 @@ private:
         } catch(std::exception &e) {
             throw runtime_error(strprintf("CDBAccessIterator::ProcessData db value error! %s", HexStr(slValue.ToString())));
         }
+        this->sp_db_key->assign(slKey.data(), slKey.size());
         this->is_valid = true;
         return true;
     }
 };
 
-//CMapPrefixIterator
+// iterate the map data of one cache layer in the db key order. The keys are sorted on seeking,
+// so it works for both the ordered and the hash map caches, and survives the rehash of hash map.
 template<typename CacheType>
 class CCacheMapIterator: public CDBBaseIterator<CacheType> {
 public:
@@ -114,36 +124,61 @@ public:
     typedef typename CacheType::KeyType KeyType;
     typedef typename CacheType::ValueType ValueType;
 private:
-    typename CacheType::Iterator map_it;
+    typedef std::pair<string, KeyType> DbKeyItem; // db key -> key
+    vector<DbKeyItem> sorted_keys;
+    size_t pos = 0;
 public:
-    CCacheMapIterator(CacheType &dbCache) : Base(dbCache), map_it(dbCache.GetMapData().end()) {}
+    CCacheMapIterator(CacheType &dbCache) : Base(dbCache) {}
 
     virtual bool First() {
-        map_it = this->db_cache.GetMapData().begin();
+        SortKeys();
+        pos = 0;
         return ProcessData();
     }
 
     bool SeekUpper(const KeyType *pKey) {
         if (pKey == nullptr || db_util::IsEmpty(*pKey))
             return First();
-        map_it = this->db_cache.GetMapData().upper_bound(*pKey);
+        SortKeys();
+        const string dbKey = dbk::GenDbKey(CacheType::PREFIX_TYPE, *pKey);
+        auto it = std::upper_bound(sorted_keys.begin(), sorted_keys.end(), dbKey,
+            [](const string &key, const DbKeyItem &item) { return key < item.first; });
+        pos = it - sorted_keys.begin();
         return ProcessData();
     }
 
     bool Next() {
         assert(this->IsValid());
-        map_it++;
+        pos++;
         return ProcessData();
     }
 
 private:
+    void SortKeys() {
+        const auto &mapData = this->db_cache.GetMapData();
+        sorted_keys.clear();
+        sorted_keys.reserve(mapData.size());
+        for (const auto &item : mapData) {
+            sorted_keys.emplace_back(dbk::GenDbKey(CacheType::PREFIX_TYPE, item.first), item.first);
+        }
+        std::sort(sorted_keys.begin(), sorted_keys.end(),
+            [](const DbKeyItem &a, const DbKeyItem &b) { return a.first < b.first; });
+    }
+
     inline bool ProcessData() {
         this->is_valid = false;
-        if (map_it == this->db_cache.GetMapData().end())  return false;
-        *this->sp_key = map_it->first;
-        *this->sp_value = map_it->second;
-        this->is_valid = true;
-        return true;
+        auto &mapData = this->db_cache.GetMapData();
+        for (; pos < sorted_keys.size(); pos++) {
+            auto it = mapData.find(sorted_keys[pos].second);
+            if (it == mapData.end()) continue; // erased after sorting
+
+            *this->sp_db_key = sorted_keys[pos].first;
+            *this->sp_key = it->first;
+            *this->sp_value = it->second;
+            this->is_valid = true;
+            return true;
+        }
+        return false;
     }
 };
 
@@ -243,9 +278,9 @@ private:
         is_map_data = true;
         is_same_key = false;
         if (sp_map_it->IsValid() && sp_base_it->IsValid()) {
-            if (*sp_base_it->sp_key < *sp_map_it->sp_key) {
+            if (*sp_base_it->sp_db_key < *sp_map_it->sp_db_key) {
                 is_map_data = false;
-            } else if (*sp_map_it->sp_key < *sp_base_it->sp_key) { // dbIt.key >= sp_map_it->key
+            } else if (*sp_map_it->sp_db_key < *sp_base_it->sp_db_key) { // dbIt.key >= sp_map_it->key
                 is_map_data = true;
             } else {// dbIt.key == sp_map_it->key
                 is_map_data = true;
@@ -260,9 +295,11 @@ private:
         if (is_map_data) {
             this->sp_key = sp_map_it->sp_key;
             this->sp_value = sp_map_it->sp_value;
+            this->sp_db_key = sp_map_it->sp_db_key;
         } else { // is db data
             this->sp_key = sp_base_it->sp_key;
             this->sp_value = sp_base_it->sp_value;
+            this->sp_db_key = sp_base_it->sp_db_key;
         }
     }
 };
@@ -318,7 +355,7 @@ struct CommonPrefixMatcher {
     // 1/2: make 2 pair key object by 1 prefix
     template<typename T1, typename T2>
     static void MakeKeyByPrefix(const T1 &prefix, std::pair<T1, T2> &keyObj) {
-        keyObj = make_pair<T1, T2>(prefix, db_util::MakeEmpty<T2>());
+        keyObj = std::make_pair(prefix, db_util::MakeEmpty<T2>());
     }
 
     // 2/2: make 2 pair key object by 2 prefix, the 2nd prefix must support partial match
@@ -330,13 +367,13 @@ struct CommonPrefixMatcher {
     // 1/3: make 3 tuple key object by 1 prefix
     template<typename T1, typename T2, typename T3>
     static void MakeKeyByPrefix(const T1 &prefix, std::tuple<T1, T2, T3> &keyObj) {
-        keyObj = make_tuple<T1, T2, T3>(prefix, db_util::MakeEmpty<T2>(), db_util::MakeEmpty<T3>());
+        keyObj = std::make_tuple(prefix, db_util::MakeEmpty<T2>(), db_util::MakeEmpty<T3>());
     }
 
     // 2/3: make 3 tuple key object by 2 pair prefix
     template<typename T1, typename T2, typename T3>
     static void MakeKeyByPrefix(const std::pair<T1, T2> &prefix, std::tuple<T1, T2, T3> &keyObj) {
-        keyObj = make_tuple<T1, T2, T3>(prefix.first, prefix.second, db_util::MakeEmpty<T3>());
+        keyObj = std::make_tuple(prefix.first, prefix.second, db_util::MakeEmpty<T3>());
     }
 
     // empty prefix, will match all keys
@@ -119,7 +119,11 @@ bool CDelegateDBCache::GetCandidateVotes(const CRegID &regId, vector<CCandidateR
 }
 
 bool CDelegateDBCache::GetVoterList(map<string/* CRegID */, vector<CCandidateReceivedVote>> &regId2Vote) {
-    return regId2VoteCache.GetAllElements(regId2Vote);
+    CDBIterator<decltype(regId2VoteCache)> it(regId2VoteCache);
+    for (it.First(); it.IsValid(); it.Next()) {
+        regId2Vote.emplace(it.GetKey(), it.GetValue());
+    }
+    return true;
 }
 
 bool CDelegateDBCache::Flush() {
@@ -11,6 +11,7 @@
 #include "entities/vote.h"
 #include "commons/serialize.h"
 #include "dbaccess.h"
+#include "dbiterator.h"
 #include "dbconf.h"
 
 #include <map>
@@ -78,6 +79,22 @@ public:
         active_delegates_cache.SetDbOpLogMap(pDbOpLogMapIn);
     }
 
+    void SetJournal(CCacheJournal *pJournalIn) {
+        voteRegIdCache.SetJournal(pJournalIn);
+        regId2VoteCache.SetJournal(pJournalIn);
+        last_vote_height_cache.SetJournal(pJournalIn);
+        pending_delegates_cache.SetJournal(pJournalIn);
+        active_delegates_cache.SetJournal(pJournalIn);
+    }
+
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn) {
+        voteRegIdCache.SetAccessSet(pAccessSetIn);
+        regId2VoteCache.SetAccessSet(pAccessSetIn);
+        last_vote_height_cache.SetAccessSet(pAccessSetIn);
+        pending_delegates_cache.SetAccessSet(pAccessSetIn);
+        active_delegates_cache.SetAccessSet(pAccessSetIn);
+    }
+
     void RegisterUndoFunc(UndoDataFuncMap &undoDataFuncMap) {
         voteRegIdCache.RegisterUndoFunc(undoDataFuncMap);
         regId2VoteCache.RegisterUndoFunc(undoDataFuncMap);
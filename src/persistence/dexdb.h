@@ -13,6 +13,7 @@
 #include "commons/serialize.h"
 #include "commons/leb128.h"
 #include "persistence/dbaccess.h"
+#include "persistence/dbiterator.h"
 #include "entities/account.h"
 #include "entities/dexorder.h"
 
@@ -61,11 +62,8 @@ public:
     DEX_DB::BlockOrders orders;             // the returned orders
 private:
     DEXBlockOrdersCache &db_cache;
-    CDBAccess &db_access;
 public:
-    CDEXOrdersGetter(DEXBlockOrdersCache &dbCache)
-        : db_cache(dbCache), db_access(*dbCache.GetDbAccessPtr()) {
-    }
+    CDEXOrdersGetter(DEXBlockOrdersCache &dbCache): db_cache(dbCache) {}
 
     bool Execute(uint32_t fromHeight, uint32_t toHeight, uint32_t maxCount, const DEXBlockOrdersCache::KeyType &lastPosInfo);
     void ToJson(Object &obj);
@@ -77,11 +75,8 @@ public:
     DEX_DB::BlockOrders orders; // exec result
 private:
     DEXBlockOrdersCache &db_cache;
-    CDBAccess &db_access;
 public:
-    CDEXSysOrdersGetter(DEXBlockOrdersCache &dbCache)
-        : db_cache(dbCache), db_access(*dbCache.GetDbAccessPtr()) {
-    }
+    CDEXSysOrdersGetter(DEXBlockOrdersCache &dbCache): db_cache(dbCache) {}
     bool Execute(uint32_t height);
 
     void ToJson(Object &obj);
@@ -123,6 +118,11 @@ public:
         return true;
     }
 
+    void EnableCleanCache(size_t maxUsage) {
+        operator_detail_cache.EnableCleanCache(maxUsage / 2);
+        operator_owner_map_cache.EnableCleanCache(maxUsage / 2);
+    }
+
     uint32_t GetCacheSize() const {
         return activeOrderCache.GetCacheSize() +
             blockOrdersCache.GetCacheSize() +
@@ -146,6 +146,22 @@ public:
         operator_last_id_cache.SetDbOpLogMap(pDbOpLogMapIn);
     }
 
+    void SetJournal(CCacheJournal *pJournalIn) {
+        activeOrderCache.SetJournal(pJournalIn);
+        blockOrdersCache.SetJournal(pJournalIn);
+        operator_detail_cache.SetJournal(pJournalIn);
+        operator_owner_map_cache.SetJournal(pJournalIn);
+        operator_last_id_cache.SetJournal(pJournalIn);
+    }
+
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn) {
+        activeOrderCache.SetAccessSet(pAccessSetIn);
+        blockOrdersCache.SetAccessSet(pAccessSetIn);
+        operator_detail_cache.SetAccessSet(pAccessSetIn);
+        operator_owner_map_cache.SetAccessSet(pAccessSetIn);
+        operator_last_id_cache.SetAccessSet(pAccessSetIn);
+    }
+
     void RegisterUndoFunc(UndoDataFuncMap &undoDataFuncMap) {
         activeOrderCache.RegisterUndoFunc(undoDataFuncMap);
         blockOrdersCache.RegisterUndoFunc(undoDataFuncMap);
@@ -155,12 +171,10 @@ public:
     }
 
     shared_ptr<CDEXOrdersGetter> CreateOrdersGetter() {
-        assert(blockOrdersCache.GetBasePtr() == nullptr && "only support top level cache");
         return make_shared<CDEXOrdersGetter>(blockOrdersCache);
     }
 
     shared_ptr<CDEXSysOrdersGetter> CreateSysOrdersGetter() {
-        assert(blockOrdersCache.GetBasePtr() == nullptr && "only support top level cache");
         return make_shared<CDEXSysOrdersGetter>(blockOrdersCache);
     }
 private:
@@ -172,7 +186,7 @@ private:
 /*  ----------------   -----------------------------  ---------------------------  ------------------   ------------------------ */
     /////////// DexDB
     // order tx id -> active order
-    CCompositeKVCache< dbk::DEX_ACTIVE_ORDER,          uint256,                     CDEXOrderDetail >     activeOrderCache;
+    CHashKVCache<      dbk::DEX_ACTIVE_ORDER,          uint256,                     CDEXOrderDetail >     activeOrderCache;
     DEXBlockOrdersCache    blockOrdersCache;
     CCompositeKVCache< dbk::DEX_OPERATOR_DETAIL,       CFixedLeb128<DexID>, DexOperatorDetail >   operator_detail_cache;
     CCompositeKVCache< dbk::DEX_OPERATOR_OWNER_MAP,    string,                     DexID >       operator_owner_map_cache;
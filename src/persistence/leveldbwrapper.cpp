@@ -6,6 +6,7 @@
 #include "leveldbwrapper.h"
 
 #include "commons/util/util.h"
+#include "config/chainparams.h"
 
 #include <leveldb/cache.h>
 #include <leveldb/env.h>
@@ -40,23 +41,72 @@ std::string CDBOpLogMap::ToString() const {
     return str;
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize) {
+// -<option>.<dbname> overrides -<option> which overrides the built-in default
+static int64_t GetDbArg(const string &option, const string &dbName, int64_t nDefault) {
+    return SysCfg().GetArg(strprintf("-%s.%s", option, dbName), SysCfg().GetArg("-" + option, nDefault));
+}
+
+static bool GetDbBoolArg(const string &option, const string &dbName, bool fDefault) {
+    return SysCfg().GetBoolArg(strprintf("-%s.%s", option, dbName), SysCfg().GetBoolArg("-" + option, fDefault));
+}
+
+CDBProfile GetDbProfile(const string &dbName, size_t nCacheSize) {
+    CDBProfile profile;
+    profile.name            = dbName;
+    profile.compression     = GetDbBoolArg("dbcompression", dbName, false);
+    profile.blockSize       = std::max<int64_t>(GetDbArg("dbblocksize", dbName, 4 << 10), 1 << 10);
+    // up to two write buffers may be held in memory simultaneously
+    profile.writeBufferSize = std::max<int64_t>(GetDbArg("dbwritebuffer", dbName, nCacheSize / 4), 64 << 10);
+    profile.maxOpenFiles    = std::max<int64_t>(GetDbArg("dbmaxopenfiles", dbName, 64), 20);
+    profile.bloomBits       = std::max<int64_t>(GetDbArg("dbbloombits", dbName, 10), 0);
+    return profile;
+}
+
+Object CDBProfile::ToJsonObj() const {
+    Object obj;
+    obj.push_back(Pair("compression",       compression));
+    obj.push_back(Pair("block_size",        (int64_t)blockSize));
+    obj.push_back(Pair("write_buffer_size", (int64_t)writeBufferSize));
+    obj.push_back(Pair("max_open_files",    maxOpenFiles));
+    obj.push_back(Pair("bloom_bits",        bloomBits));
+    return obj;
+}
+
+size_t GetSharedBlockCacheSize() {
+    int64_t nCacheMB = SysCfg().GetArg("-dbcache", DEFAULT_DB_CACHE);
+    nCacheMB         = std::min(std::max(nCacheMB, MIN_DB_CACHE), MAX_DB_CACHE);
+    return (size_t)nCacheMB << 20;
+}
+
+leveldb::Cache *GetSharedBlockCache() {
+    // never freed before the process exits, the databases are always closed earlier
+    static std::unique_ptr<leveldb::Cache> pCache(leveldb::NewLRUCache(GetSharedBlockCacheSize()));
+    return pCache.get();
+}
+
+static leveldb::Options GetOptions(const CDBProfile &profile) {
     leveldb::Options options;
-    options.block_cache       = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4;  // up to two write buffers may be held in memory simultaneously
-    options.filter_policy     = leveldb::NewBloomFilterPolicy(10);
-    options.compression       = leveldb::kNoCompression;
-    options.max_open_files    = 64;
+    options.block_cache       = GetSharedBlockCache();
+    options.block_size        = profile.blockSize;
+    options.write_buffer_size = profile.writeBufferSize;
+    options.filter_policy     = profile.bloomBits > 0 ? leveldb::NewBloomFilterPolicy(profile.bloomBits) : nullptr;
+    options.compression       = profile.compression ? leveldb::kSnappyCompression : leveldb::kNoCompression;
+    options.max_open_files    = profile.maxOpenFiles;
     return options;
 }
 
-CLevelDBWrapper::CLevelDBWrapper(const boost::filesystem::path &path, size_t nCacheSize, bool fMemory, bool fWipe) {
+CLevelDBWrapper::CLevelDBWrapper(const boost::filesystem::path &path, size_t nCacheSize, bool fMemory, bool fWipe)
+    : CLevelDBWrapper(path, GetDbProfile(path.filename().string(), nCacheSize), fMemory, fWipe) {}
+
+CLevelDBWrapper::CLevelDBWrapper(const boost::filesystem::path &path, const CDBProfile &profileIn, bool fMemory,
+                                 bool fWipe)
+    : profile(profileIn) {
     penv                         = nullptr;
     readoptions.verify_checksums = true;
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache       = false;
     syncoptions.sync             = true;
-    options                      = GetOptions(nCacheSize);
+    options                      = GetOptions(profile);
     options.create_if_missing    = true;
     if (fMemory) {
         penv        = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -71,7 +121,9 @@ CLevelDBWrapper::CLevelDBWrapper(const boost::filesystem::path &path, size_t nCa
     }
     leveldb::Status status = leveldb::DB::Open(options, path.string(), &pdb);
     ThrowError(status);
-    LogPrint(BCLog::INFO, "Opened LevelDB successfully\n");
+    LogPrint(BCLog::INFO, "Opened LevelDB successfully, compression=%d, block_size=%u, write_buffer=%u, "
+             "max_open_files=%d, bloom_bits=%d\n", profile.compression, profile.blockSize, profile.writeBufferSize,
+             profile.maxOpenFiles, profile.bloomBits);
 }
 
 CLevelDBWrapper::~CLevelDBWrapper() {
@@ -79,8 +131,7 @@ CLevelDBWrapper::~CLevelDBWrapper() {
     pdb = nullptr;
     delete options.filter_policy;
     options.filter_policy = nullptr;
-    delete options.block_cache;
-    options.block_cache = nullptr;
+    options.block_cache = nullptr; // shared, see GetSharedBlockCache()
     delete penv;
     options.env = nullptr;
 }
@@ -117,3 +168,23 @@ int64_t CLevelDBWrapper::GetDbCount() {
 
     return ret;
 }
+
+uint64_t CLevelDBWrapper::GetApproximateSize(const string &beginKey, const string &endKey) const {
+    leveldb::Range range(beginKey, endKey);
+    uint64_t size = 0;
+    pdb->GetApproximateSizes(&range, 1, &size);
+    return size;
+}
+
+Object CLevelDBWrapper::ToJsonObj() const {
+    Object obj;
+    obj.push_back(Pair("name",    profile.name));
+    obj.push_back(Pair("profile", profile.ToJsonObj()));
+
+    string value;
+    if (GetProperty("leveldb.stats", value))
+        obj.push_back(Pair("stats", value));
+
+    obj.push_back(Pair("approximate_size", (int64_t)GetApproximateSize("", "\xff\xff\xff\xff")));
+    return obj;
+}
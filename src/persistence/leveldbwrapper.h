@@ -86,6 +86,7 @@ typedef vector<CDbOpLog> CDbOpLogs;
 class CDBOpLogMap {
 public:
     map<string, CDbOpLogs>& GetMap() { return mapDbOpLogs; }
+    const map<string, CDbOpLogs>& GetMap() const { return mapDbOpLogs; }
 
     const CDbOpLogs* GetDbOpLogsPtr(dbk::PrefixType prefixType) const {
         assert(prefixType != dbk::EMPTY);
@@ -146,6 +147,26 @@ public:
 
  };
 
+// Tunable options of one leveldb database, built by GetDbProfile() from the
+// -db<option> / -db<option>.<dbname> startup args.
+struct CDBProfile {
+    string   name;              // db name, e.g. "accounts"
+    bool     compression;       // snappy compression if leveldb was built with it
+    uint32_t blockSize;         // approximate size of user data packed per block
+    uint32_t writeBufferSize;   // memtable size before converting to a sorted on-disk file
+    int32_t  maxOpenFiles;
+    int32_t  bloomBits;         // bits per key of bloom filter, 0 = no filter
+
+    Object ToJsonObj() const;
+};
+
+// nCacheSize is the legacy per-db cache size, the write buffer default is derived from it
+CDBProfile GetDbProfile(const string &dbName, size_t nCacheSize);
+
+// block cache shared by all the leveldb databases, sized by -dbcache
+leveldb::Cache *GetSharedBlockCache();
+size_t GetSharedBlockCacheSize();
+
 class CLevelDBWrapper {
 private:
     // custom environment this database is using (may be NULL in case of default environment)
@@ -169,8 +190,11 @@ private:
     // the database itself
     leveldb::DB *pdb;
 
+    CDBProfile profile;
+
 public:
     CLevelDBWrapper(const boost::filesystem::path &path, size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+    CLevelDBWrapper(const boost::filesystem::path &path, const CDBProfile &profileIn, bool fMemory = false, bool fWipe = false);
     ~CLevelDBWrapper();
 
     template<typename V>
@@ -237,7 +261,17 @@ public:
         return pdb->NewIterator(iteroptions);
     }
     int64_t GetDbCount();
-   // Object ToJsonObj();
+
+    const CDBProfile& GetProfile() const { return profile; }
+
+    bool GetProperty(const string &property, string &value) const {
+        return pdb->GetProperty(property, &value);
+    }
+
+    // approximate file system space used by keys in [beginKey, endKey)
+    uint64_t GetApproximateSize(const string &beginKey, const string &endKey) const;
+
+    Object ToJsonObj() const;
 };
 
 #endif // PERSIST_LEVELDBWRAPPER_H
@@ -18,16 +18,20 @@ bool CLogDBCache::GetExecuteFail(const int32_t blockHeight, vector<std::tuple<ui
     if (!SysCfg().IsLogFailures())
         return true;
 
-    map<string, std::pair<uint8_t, string> > elements;
-    if (!executeFailCache.GetAllElements(std::to_string(blockHeight) + "_", elements)) {
-        return false;
-    }
+    // the db keys are ordered by the string length first, all the keys of the height have the same
+    // length of "$height_$txid", so seek from the smallest txid of the height
+    const string prefix = std::to_string(blockHeight) + "_";
+    const string startKey = prefix + uint256().GetHex();
+    CDBIterator<decltype(executeFailCache)> it(executeFailCache);
+    for (it.SeekUpper(&startKey); it.IsValid(); it.Next()) {
+        const string &key = it.GetKey();
+        if (key.compare(0, prefix.size(), prefix) != 0)
+            break;
 
-    size_t prefixLen = string(std::to_string(blockHeight) + "_").size();
-    for (const auto &item : elements) {
-        result.push_back(std::make_tuple(uint256S(item.first.substr(prefixLen)) /* txid */,
-                                         std::get<0>(item.second) /* error code */,
-                                         std::get<1>(item.second) /* error message */));
+        const auto &value = it.GetValue();
+        result.push_back(std::make_tuple(uint256S(key.substr(prefix.size())) /* txid */,
+                                         std::get<0>(value) /* error code */,
+                                         std::get<1>(value) /* error message */));
     }
 
     return true;
@@ -10,6 +10,7 @@
 #include "entities/id.h"
 #include "commons/serialize.h"
 #include "dbaccess.h"
+#include "dbiterator.h"
 #include "dbconf.h"
 
 #include <map>
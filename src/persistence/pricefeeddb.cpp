@@ -6,6 +6,7 @@
 #include "pricefeeddb.h"
 
 #include "config/scoin.h"
+#include "dbaccess.h"
 #include "main.h"
 #include "tx/pricefeedtx.h"
 
@@ -27,6 +28,11 @@ bool CConsecutiveBlockPrice::ExistBlockUserPrice(const int32_t blockHeight, cons
 
 void CPricePointMemCache::SetLatestBlockMedianPricePoints(
     const map<CoinPricePair, uint64_t> &latestBlockMedianPricePointsIn) {
+    if (pJournal != nullptr && pJournal->IsActive()) {
+        map<CoinPricePair, uint64_t> oldValue = latestBlockMedianPricePoints;
+        pJournal->AddRestoreFunc([this, oldValue]() { latestBlockMedianPricePoints = oldValue; });
+    }
+
     latestBlockMedianPricePoints = latestBlockMedianPricePointsIn;
     string prices;
     for (const auto &item : latestBlockMedianPricePointsIn) {
@@ -47,6 +53,7 @@ bool CPricePointMemCache::AddBlockPricePointInBatch(const int32_t blockHeight, c
             return false;
         }
 
+        AddJournal(pp.GetCoinPricePair());
         CConsecutiveBlockPrice &cbp = mapCoinPricePointCache[pp.GetCoinPricePair()];
         cbp.AddUserPrice(blockHeight, regId, pp.GetPrice());
         LogPrint(BCLog::PRICEFEED,
@@ -142,6 +149,19 @@ void CPricePointMemCache::Flush() {
     latestBlockMedianPricePoints.clear();
 }
 
+void CPricePointMemCache::AddJournal(const CoinPricePair &coinPricePair) {
+    if (pJournal == nullptr || !pJournal->IsActive())
+        return;
+
+    auto it = mapCoinPricePointCache.find(coinPricePair);
+    if (it == mapCoinPricePointCache.end()) {
+        pJournal->AddRestoreFunc([this, coinPricePair]() { mapCoinPricePointCache.erase(coinPricePair); });
+    } else {
+        CConsecutiveBlockPrice oldValue = it->second;
+        pJournal->AddRestoreFunc([this, coinPricePair, oldValue]() { mapCoinPricePointCache[coinPricePair] = oldValue; });
+    }
+}
+
 void CPricePointMemCache::Reset() {
     pBase = nullptr;
     latestBlockMedianPricePoints.clear();
@@ -19,6 +19,7 @@
 
 using namespace std;
 
+class CCacheJournal;
 class CConsecutiveBlockPrice;
 
 typedef map<int32_t /* block height */, map<CRegID, uint64_t /* price */>> BlockUserPriceMap;
@@ -58,6 +59,7 @@ public:
                                    map<CoinPricePair, uint64_t> &mapMedianPricePoints);
 
     void SetBaseViewPtr(CPricePointMemCache *pBaseIn);
+    void SetJournal(CCacheJournal *pJournalIn) { pJournal = pJournalIn; }
     void Flush();
     void Reset();
 
@@ -75,9 +77,12 @@ private:
                                      const BlockUserPriceMap &blockUserPrices);
     static uint64_t ComputeMedianNumber(vector<uint64_t> &numbers);
 
+    void AddJournal(const CoinPricePair &coinPricePair);
+
 private:
     CoinPricePointMap mapCoinPricePointCache;  // coinPriceType -> consecutiveBlockPrice
     CPricePointMemCache *pBase;
+    CCacheJournal *pJournal = nullptr;
 };
 
 #endif  // PERSIST_PRICEFEED_H
\ No newline at end of file
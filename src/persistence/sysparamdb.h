@@ -43,6 +43,8 @@ public:
     void SetBaseViewPtr(CSysParamDBCache *pBaseIn) { sysParamCache.SetBase(&pBaseIn->sysParamCache); }
 
     void SetDbOpLogMap(CDBOpLogMap *pDbOpLogMapIn) { sysParamCache.SetDbOpLogMap(pDbOpLogMapIn); }
+    void SetJournal(CCacheJournal *pJournalIn) { sysParamCache.SetJournal(pJournalIn); }
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn) { sysParamCache.SetAccessSet(pAccessSetIn); }
 
     void RegisterUndoFunc(UndoDataFuncMap &undoDataFuncMap) {
         sysParamCache.RegisterUndoFunc(undoDataFuncMap);
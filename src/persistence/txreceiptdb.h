@@ -34,6 +34,8 @@ public:
     void SetBaseViewPtr(CTxReceiptDBCache *pBaseIn) { txReceiptCache.SetBase(&pBaseIn->txReceiptCache); }
 
     void SetDbOpLogMap(CDBOpLogMap *pDbOpLogMapIn) { txReceiptCache.SetDbOpLogMap(pDbOpLogMapIn); }
+    void SetJournal(CCacheJournal *pJournalIn) { txReceiptCache.SetJournal(pJournalIn); }
+    void SetAccessSet(CCacheAccessSet *pAccessSetIn) { txReceiptCache.SetAccessSet(pAccessSetIn); }
 
     void RegisterUndoFunc(UndoDataFuncMap &undoDataFuncMap) {
         txReceiptCache.RegisterUndoFunc(undoDataFuncMap);
@@ -43,7 +45,7 @@ private:
 /*  ----------------   -------------------------   -----------------------  ------------------   ------------------------ */
     /////////// SysParamDB
     // txid -> vector<CReceipt>
-    CCompositeKVCache< dbk::TX_RECEIPT,            TxID,                   vector<CReceipt> >     txReceiptCache;
+    CHashKVCache<      dbk::TX_RECEIPT,            TxID,                   vector<CReceipt> >     txReceiptCache;
 };
 
 #endif // PERSIST_RECEIPTDB_H
\ No newline at end of file
@@ -214,6 +214,10 @@ Array RPCConvertValues(const string &strMethod, const vector<string> &strParams)
 
     /* vm functions work in vm simulator */
     if (strMethod == "vmexecutescript"          && n > 3) ConvertTo<int64_t>(params[3]);
+    if (strMethod == "vmexecutescript"          && n > 5) ConvertTo<bool>(params[5]);
+
+    /* for wasm */
+    if (strMethod == "submitwasmcontractcalltx" && n > 5) ConvertTo<bool>(params[5]);
 
 
     return params;
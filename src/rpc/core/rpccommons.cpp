@@ -270,55 +270,59 @@ Object GetTxDetailJSON(const uint256& txid) {
     {
         std::shared_ptr<CBaseTx> pBaseTx;
 
-        LOCK(cs_main);
-        if (SysCfg().IsTxIndex()) {
-            CDiskTxPos postx;
-            if (pCdMan->pBlockCache->ReadTxIndex(txid, postx)) {
-                CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
-                CBlockHeader header;
-
-                try {
-                    file >> header;
-                    fseek(file, postx.nTxOffset, SEEK_CUR);
-                    file >> pBaseTx;
-                    //obj = pBaseTx->IsMultiSignSupport()?pBaseTx->ToJsonMultiSign(*database):pBaseTx->ToJson(*pCdMan->pAccountCache);
-                    obj = pBaseTx->ToJson(*pCdMan->pAccountCache);
-
-                    obj.push_back(Pair("confirmations",     chainActive.Height() - (int32_t)header.GetHeight()));
-                    obj.push_back(Pair("confirmed_height",  (int32_t)header.GetHeight()));
-                    obj.push_back(Pair("confirmed_time",    (int32_t)header.GetTime()));
-                    obj.push_back(Pair("block_hash",        header.GetHash().GetHex()));
-
-                    if (SysCfg().IsGenReceipt()) {
-                        vector<CReceipt> receipts;
-                        pCdMan->pReceiptCache->GetTxReceipts(txid, receipts);
-                        obj.push_back(Pair("receipts", JSON::ToJson(*pCdMan->pAccountCache, receipts)));
-                    }
-
-                    CDataStream ds(SER_DISK, CLIENT_VERSION);
-                    ds << pBaseTx;
-                    obj.push_back(Pair("rawtx", HexStr(ds.begin(), ds.end())));
-
-                    string trace;
-                    auto database = std::make_shared<CCacheWrapper>(pCdMan);
-                    auto resolver = make_resolver(database);
-                    if(database->contractCache.GetContractTraces(txid, trace)){
-
-                        json_spirit::Value value_json;
-                        std::vector<char>  trace_bytes = std::vector<char>(trace.begin(), trace.end());
-                        transaction_trace  trace       = wasm::unpack<transaction_trace>(trace_bytes);
-                        to_variant(trace, value_json, resolver);
-                        obj.push_back(Pair("tx_trace", value_json));
-                     }
-
-                } catch (std::exception &e) {
-                    throw runtime_error(tfm::format("%s : Deserialize or I/O error - %s", __func__, e.what()).c_str());
+        CDiskTxPos postx;
+        bool fIndexed;
+        {
+            LOCK(cs_main);
+            fIndexed = SysCfg().IsTxIndex() && pCdMan->pBlockCache->ReadTxIndex(txid, postx);
+        }
+
+        if (fIndexed) {
+            // the block files are read without cs_main
+            CBlockHeader header;
+            if (!ReadTxFromDisk(postx, header, pBaseTx))
+                throw runtime_error(tfm::format("%s : Deserialize or I/O error of tx %s", __func__, txid.GetHex()));
+
+            LOCK(cs_main);
+            try {
+                //obj = pBaseTx->IsMultiSignSupport()?pBaseTx->ToJsonMultiSign(*database):pBaseTx->ToJson(*pCdMan->pAccountCache);
+                obj = pBaseTx->ToJson(*pCdMan->pAccountCache);
+
+                obj.push_back(Pair("confirmations",     chainActive.Height() - (int32_t)header.GetHeight()));
+                obj.push_back(Pair("confirmed_height",  (int32_t)header.GetHeight()));
+                obj.push_back(Pair("confirmed_time",    (int32_t)header.GetTime()));
+                obj.push_back(Pair("block_hash",        header.GetHash().GetHex()));
+
+                if (SysCfg().IsGenReceipt()) {
+                    vector<CReceipt> receipts;
+                    pCdMan->pReceiptCache->GetTxReceipts(txid, receipts);
+                    obj.push_back(Pair("receipts", JSON::ToJson(*pCdMan->pAccountCache, receipts)));
                 }
 
-                return obj;
+                CDataStream ds(SER_DISK, CLIENT_VERSION);
+                ds << pBaseTx;
+                obj.push_back(Pair("rawtx", HexStr(ds.begin(), ds.end())));
+
+                string trace;
+                auto database = std::make_shared<CCacheWrapper>(pCdMan);
+                auto resolver = make_resolver(database);
+                if(database->contractCache.GetContractTraces(txid, trace)){
+
+                    json_spirit::Value value_json;
+                    std::vector<char>  trace_bytes = std::vector<char>(trace.begin(), trace.end());
+                    transaction_trace  trace       = wasm::unpack<transaction_trace>(trace_bytes);
+                    to_variant(trace, value_json, resolver);
+                    obj.push_back(Pair("tx_trace", value_json));
+                 }
+
+            } catch (std::exception &e) {
+                throw runtime_error(tfm::format("%s : Deserialize or I/O error - %s", __func__, e.what()).c_str());
             }
+
+            return obj;
         }
 
+        LOCK(cs_main);
         {
             pBaseTx = mempool.Lookup(txid);
             if (pBaseTx.get()) {
@@ -249,6 +249,7 @@ static const CRPCCommand vRPCCommands[] =
     { "getaddednodeinfo",       &getaddednodeinfo,       true,      true,       false },
     { "getconnectioncount",     &getconnectioncount,     true,      false,      false },
     { "getnettotals",           &getnettotals,           true,      true,       false },
+    { "getcmpctblockstats",     &getcmpctblockstats,     true,      true,       false },
     { "getpeerinfo",            &getpeerinfo,            true,      false,      false },
     { "ping",                   &ping,                   true,      false,      false },
     { "getchaininfo",           &getchaininfo,           true,      false,      false },
@@ -262,6 +263,9 @@ static const CRPCCommand vRPCCommands[] =
 
     { "gettotalcoins",          &gettotalcoins,          true,      false,      false },
     { "invalidateblock",        &invalidateblock,        true,      true,       false },
+    { "getdbstats",             &getdbstats,             true,      true,       false },
+    { "getblockfilestats",      &getblockfilestats,      true,      true,       false },
+    { "getblockindexmemory",    &getblockindexmemory,    true,      true,       false },
     { "reconsiderblock",        &reconsiderblock,        true,      true,       false },
 
     /* Mining */
@@ -277,7 +281,7 @@ static const CRPCCommand vRPCCommands[] =
     { "addmulsigaddr",          &addmulsigaddr,          false,     false,      true },
     { "getaccountinfo",         &getaccountinfo,         true,      false,      true },
     { "getnewaddr",             &getnewaddr,             false,     false,      true },
-    { "gettxdetail",            &gettxdetail,            true,      false,      true },
+    { "gettxdetail",            &gettxdetail,            true,      true,       true },
     { "getclosedcdp",           &getclosedcdp,           true,      false,      true },
     { "getwalletinfo",          &getwalletinfo,          true,      false,      true },
 
@@ -295,6 +299,7 @@ static const CRPCCommand vRPCCommands[] =
 
     { "listaddr",               &listaddr,               true,      false,      true },
     { "listtx",                 &listtx,                 true,      false,      true },
+    { "listaddrtx",             &listaddrtx,             true,      false,      false },
     { "setgenerate",            &setgenerate,            true,      true,       false },
     { "listcontracts",          &listcontracts,          true,      false,      true },
     { "getcontractinfo",        &getcontractinfo,        true,      false,      true },
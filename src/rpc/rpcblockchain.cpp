@@ -13,6 +13,7 @@
 #include "init.h"
 #include "commons/json/json_spirit_value.h"
 #include "main.h"
+#include "persistence/blockfilereader.h"
 #include "rpc/core/rpcserver.h"
 #include "sync.h"
 #include "tx/merkletx.h"
@@ -711,3 +712,125 @@ Value getblockfailures(const Array& params, bool fHelp) {
 
     return obj;
 }
+
+Value getdbstats(const Array& params, bool fHelp) {
+    if (fHelp || params.size() > 1) {
+        throw runtime_error(
+            "getdbstats ( \"db name\" )\n"
+            "\nGet leveldb profiles, stats and approximate sizes for capacity planning.\n"
+            "\nArguments:\n"
+            "1.\"db name\"   (string, optional) only report the given db, e.g. accounts, index\n"
+            "\nResult:\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getdbstats", "\"accounts\"") +
+            "\nAs json rpc call\n" +
+            HelpExampleRpc("getdbstats", "\"accounts\""));
+    }
+
+    string dbName = params.size() > 0 ? params[0].get_str() : "";
+
+    Array dbs;
+    for (const auto pDbAccess : pCdMan->GetDbAccessList()) {
+        if (dbName.empty() || dbName == GetDbName(pDbAccess->GetDbNameType()))
+            dbs.push_back(pDbAccess->ToJsonObj());
+    }
+    if (dbName.empty() || dbName == pCdMan->pBlockIndexDb->GetProfile().name)
+        dbs.push_back(pCdMan->pBlockIndexDb->ToJsonObj());
+
+    if (dbs.empty())
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Unknown db name: %s", dbName));
+
+    Object obj;
+    obj.push_back(Pair("block_cache_size", (int64_t)GetSharedBlockCacheSize()));
+    obj.push_back(Pair("dbs",              dbs));
+
+    return obj;
+}
+
+Value getblockfilestats(const Array& params, bool fHelp) {
+    if (fHelp || params.size() != 0) {
+        throw runtime_error(
+            "getblockfilestats\n"
+            "\nGet the reads of the stored blocks and txs per block file, and the open read handles.\n"
+            "\nArguments:\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"open_handles\": n,         (numeric) the block files open for reading\n"
+            "  \"max_open_handles\": n,     (numeric) the block files kept open at most\n"
+            "  \"files\": [                 (array) the files read since the start\n"
+            "    {\n"
+            "      \"file\": \"xxx\",        (string) the name of the block file\n"
+            "      \"reads\": n,            (numeric) the reads of the file\n"
+            "      \"read_bytes\": n        (numeric) the bytes read from the file\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getblockfilestats", "") +
+            "\nAs json rpc call\n" +
+            HelpExampleRpc("getblockfilestats", ""));
+    }
+
+    CBlockFileReader &reader = GetBlockFileReader();
+
+    Array files;
+    for (const auto &item : reader.GetStats()) {
+        Object file;
+        file.push_back(Pair("file",       strprintf("blk%05u.dat", item.first)));
+        file.push_back(Pair("reads",      item.second.reads));
+        file.push_back(Pair("read_bytes", item.second.bytes));
+        files.push_back(file);
+    }
+
+    Object obj;
+    obj.push_back(Pair("open_handles",     (int64_t)reader.GetOpenCount()));
+    obj.push_back(Pair("max_open_handles", (int64_t)MAX_BLOCK_FILE_READ_HANDLES));
+    obj.push_back(Pair("files",            files));
+
+    return obj;
+}
+
+Value getblockindexmemory(const Array& params, bool fHelp) {
+    if (fHelp || params.size() != 0) {
+        throw runtime_error(
+            "getblockindexmemory\n"
+            "\nGet the memory used by the block indexes.\n"
+            "\nArguments:\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"block_indexes\": n,       (numeric) the block indexes in memory\n"
+            "  \"index_size\": n,          (numeric) the bytes of a block index\n"
+            "  \"arena_slabs\": n,         (numeric) the slabs allocated for the block indexes\n"
+            "  \"arena_allocated\": n,     (numeric) the block indexes allocated from the slabs\n"
+            "  \"arena_bytes\": n,         (numeric) the bytes of the slabs\n"
+            "  \"map_buckets\": n,         (numeric) the buckets of the hash table of the block indexes\n"
+            "  \"map_bytes\": n,           (numeric) the bytes of the hash table\n"
+            "  \"signature_bytes\": n      (numeric) the bytes of the block signatures kept by the block indexes\n"
+            "}\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getblockindexmemory", "") +
+            "\nAs json rpc call\n" +
+            HelpExampleRpc("getblockindexmemory", ""));
+    }
+
+    LOCK(cs_main);
+
+    int64_t signatureBytes = 0;
+    for (const auto &item : mapBlockIndex)
+        signatureBytes += item.second->vSignature.capacity();
+
+    // a bucket holds the hash of the key and the key value pair
+    size_t bucketSize = sizeof(size_t) + sizeof(BlockMap::value_type);
+
+    Object obj;
+    obj.push_back(Pair("block_indexes",   (int64_t)mapBlockIndex.size()));
+    obj.push_back(Pair("index_size",      (int64_t)sizeof(CBlockIndex)));
+    obj.push_back(Pair("arena_slabs",     (int64_t)blockIndexArena.GetSlabCount()));
+    obj.push_back(Pair("arena_allocated", (int64_t)blockIndexArena.GetAllocatedCount()));
+    obj.push_back(Pair("arena_bytes",     (int64_t)blockIndexArena.GetMemoryUsage()));
+    obj.push_back(Pair("map_buckets",     (int64_t)mapBlockIndex.bucket_count()));
+    obj.push_back(Pair("map_bytes",       (int64_t)(mapBlockIndex.bucket_count() * bucketSize)));
+    obj.push_back(Pair("signature_bytes", signatureBytes));
+
+    return obj;
+}
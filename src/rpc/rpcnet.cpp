@@ -8,6 +8,7 @@
 #include "main.h"
 #include "net.h"
 #include "netbase.h"
+#include "p2p/blockencodings.h"
 #include "p2p/protocol.h"
 #include "sync.h"
 #include "commons/util/util.h"
@@ -322,6 +323,44 @@ Value getnettotals(const Array& params, bool fHelp) {
     return obj;
 }
 
+Value getcmpctblockstats(const Array& params, bool fHelp) {
+    if (fHelp || params.size() != 0)
+        throw runtime_error(
+            "getcmpctblockstats\n"
+            "\nReturns the relay and the propagation latency of the compact blocks since the start.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"sent\": n,                  (numeric) the compact blocks sent\n"
+            "  \"received\": n,              (numeric) the compact blocks received\n"
+            "  \"rebuilt_from_mempool\": n,  (numeric) the blocks rebuilt from the mempool alone\n"
+            "  \"rebuilt_with_blocktxn\": n, (numeric) the blocks rebuilt after getting the missing txs\n"
+            "  \"missing_txs\": n,           (numeric) the txs missing in the mempool\n"
+            "  \"full_blocks\": n,           (numeric) the full blocks requested instead\n"
+            "  \"avg_rebuild_us\": n,        (numeric) the average micros from receiving to rebuilding a block\n"
+            "  \"max_rebuild_us\": n,        (numeric) the max micros from receiving to rebuilding a block\n"
+            "  \"avg_delay_ms\": n,          (numeric) the average millis from the block time to rebuilding a block\n"
+            "  \"last_delay_ms\": n          (numeric) the millis from the block time to rebuilding the last block\n"
+            "}\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getcmpctblockstats", "") + "\nAs json rpc\n" + HelpExampleRpc("getcmpctblockstats", ""));
+
+    CCmpctBlockCounters counters = GetCmpctBlockStats().Get();
+    uint64_t rebuilt             = counters.fromMempool + counters.withBlockTxn;
+
+    Object obj;
+    obj.push_back(Pair("sent",                  counters.sent));
+    obj.push_back(Pair("received",              counters.received));
+    obj.push_back(Pair("rebuilt_from_mempool",  counters.fromMempool));
+    obj.push_back(Pair("rebuilt_with_blocktxn", counters.withBlockTxn));
+    obj.push_back(Pair("missing_txs",           counters.missingTxs));
+    obj.push_back(Pair("full_blocks",           counters.fallbacks));
+    obj.push_back(Pair("avg_rebuild_us",        rebuilt > 0 ? counters.rebuildMicros / (int64_t)rebuilt : 0));
+    obj.push_back(Pair("max_rebuild_us",        counters.maxRebuildMicros));
+    obj.push_back(Pair("avg_delay_ms",          rebuilt > 0 ? counters.delayMillis / (int64_t)rebuilt : 0));
+    obj.push_back(Pair("last_delay_ms",         counters.lastDelayMillis));
+    return obj;
+}
+
 Value getnetworkinfo(const Array& params, bool fHelp) {
     if (fHelp || params.size() != 0)
         throw runtime_error(
@@ -13,6 +13,7 @@
 #include "wallet/wallet.h"
 #include "wallet/walletdb.h"
 #include "persistence/blockdb.h"
+#include "persistence/blockprefetcher.h"
 #include "persistence/txdb.h"
 #include "config/configuration.h"
 #include "miner/miner.h"
@@ -582,6 +583,95 @@ if (fHelp || params.size() > 2) {
     return retObj;
 }
 
+Value listaddrtx(const Array& params, bool fHelp) {
+    if (fHelp || params.size() < 1 || params.size() > 3) {
+        throw runtime_error(
+            "listaddrtx \"addr\" [\"max_count\"] [\"last_pos_info\"]\n"
+            "\nget the confirmed transactions involving an address from the newest to the oldest, requires -addrindex.\n"
+            "\nArguments:\n"
+            "1.\"addr\":            (string, required) the address, regid or nickid\n"
+            "2.\"max_count\":       (numeric, optional) the max transaction count to get, default is 100\n"
+            "3.\"last_pos_info\":   (string, optional) the last position info to get more transactions, default is empty\n"
+            "\nResult:\n"
+            "\"address\"            (string) the address.\n"
+            "\"catching_up\"        (bool) the blocks before -addrindex was switched on are still being indexed.\n"
+            "\"has_more\"           (bool) has more transactions in db.\n"
+            "\"last_pos_info\"      (string) the last position info to get more transactions.\n"
+            "\"count\"              (numeric) the count of returned transactions.\n"
+            "\"txs\"                (array) the txid, height and index in block of the transactions.\n"
+            "\nExamples:\n"
+            + HelpExampleCli("listaddrtx", "\"WT52jPi8DhHUC85MPYK8y8Ajs8J7CshgaB\" 100")
+            + "\nAs json rpc call\n"
+            + HelpExampleRpc("listaddrtx", "\"WT52jPi8DhHUC85MPYK8y8Ajs8J7CshgaB\", 100")
+        );
+    }
+
+    if (!SysCfg().IsAddrIndex())
+        throw JSONRPCError(RPC_MISC_ERROR, "The address index is disabled, restart with -addrindex");
+
+    CKeyID keyId;
+    if (!GetKeyId(params[0].get_str(), keyId))
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+
+    int64_t maxCount = 100;
+    if (params.size() > 1) {
+        maxCount = params[1].get_int64();
+        if (maxCount < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMS, strprintf("max_count=%d must >= 0", maxCount));
+    }
+
+    AddrTxIndexCache::KeyType lastKey;
+    if (params.size() > 2) {
+        string lastPosInfo = RPC_PARAM::GetBinStrFromHex(params[2], "last_pos_info");
+        auto err = ADDR_TX_INDEX::ParseLastPos(lastPosInfo, lastKey);
+        if (err)
+            throw JSONRPCError(RPC_INVALID_PARAMS, strprintf("Invalid last_pos_info! %s", *err));
+        if (std::get<0>(lastKey) != keyId)
+            throw JSONRPCError(RPC_INVALID_PARAMS, "Invalid last_pos_info! it is of another address");
+    }
+
+    auto pGetter = pCdMan->pBlockCache->CreateAddrTxGetter();
+    if (!pGetter->Execute(keyId, maxCount, lastKey))
+        throw JSONRPCError(RPC_INVALID_PARAMS, strprintf("get the txs of address error! addr=%s", keyId.ToAddress()));
+
+    string newLastPosInfo;
+    if (pGetter->has_more) {
+        auto err = ADDR_TX_INDEX::MakeLastPos(pGetter->last_key, newLastPosInfo);
+        if (err)
+            throw JSONRPCError(RPC_INVALID_PARAMS, strprintf("Make new last_pos_info error! %s", *err));
+    }
+
+    Array txArray;
+    for (const auto &item : pGetter->txs) {
+        uint32_t height = ADDR_TX_INDEX::GetHeight(item.first);
+        CBlockIndex *pIndex = chainActive[height];
+        if (pIndex == nullptr)
+            continue;
+
+        // skip the txs of the blocks reorganized while -addrindex was off
+        CDiskTxPos txPos;
+        if (SysCfg().IsTxIndex() && pCdMan->pBlockCache->ReadTxIndex(item.second, txPos) &&
+            (txPos.nFile != pIndex->nFile || txPos.nPos != pIndex->nDataPos))
+            continue;
+
+        Object txObj;
+        txObj.push_back(Pair("txid", item.second.GetHex()));
+        txObj.push_back(Pair("height", (int64_t)height));
+        txObj.push_back(Pair("index", (int64_t)ADDR_TX_INDEX::GetIndex(item.first)));
+        txObj.push_back(Pair("block_time", (int64_t)pIndex->GetBlockTime()));
+        txArray.push_back(txObj);
+    }
+
+    Object obj;
+    obj.push_back(Pair("address", keyId.ToAddress()));
+    obj.push_back(Pair("catching_up", pCdMan->pBlockCache->GetAddrIndexCatchUpHeight() > 0));
+    obj.push_back(Pair("has_more", pGetter->has_more));
+    obj.push_back(Pair("last_pos_info", HexStr(newLastPosInfo)));
+    obj.push_back(Pair("count", (int64_t)txArray.size()));
+    obj.push_back(Pair("txs", txArray));
+    return obj;
+}
+
 Value getaccountinfo(const Array& params, bool fHelp) {
     if (fHelp || params.size() != 1) {
         throw runtime_error(
@@ -689,15 +779,17 @@ static Value TestDisconnectBlock(int32_t number) {
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid number");
     }
     if (number > 0) {
+        std::shared_ptr<CBlock> spTipBlock;
         do {
             CBlockIndex * pTipIndex = chainActive.Tip();
-            if (!DisconnectBlockFromTip(state))
+            if (!DisconnectBlockFromTip(state, spTipBlock))
                 return false;
             chainMostWork.SetTip(pTipIndex->pprev);
             if (!EraseBlockIndexFromSet(pTipIndex))
                 return false;
             if (!pCdMan->pBlockIndexDb->EraseBlockIndex(pTipIndex->GetBlockHash()))
                 return false;
+            // the index stays allocated in blockIndexArena, it may still be pointed to
             mapBlockIndex.erase(pTipIndex->GetBlockHash());
         } while (--number);
     }
@@ -836,15 +928,17 @@ Value reloadtxcache(const Array& params, bool fHelp) {
         pIndex = chainActive.Genesis();
     }
 
-    CBlock block;
-    do {
-        if (!ReadBlockFromDisk(pIndex, block))
-            return ERRORMSG("reloadtxcache() : *** ReadBlockFromDisk failed at %d, hash=%s",
-                pIndex->height, pIndex->GetBlockHash().ToString());
+    vector<CBlockIndex *> vIndex;
+    for (; pIndex != nullptr; pIndex = chainActive.Next(pIndex))
+        vIndex.push_back(pIndex);
 
+    CBlockPrefetcher prefetcher(vIndex);
+    CBlock block;
+    while (prefetcher.Next(pIndex, block))
         pCdMan->pTxCache->AddBlockTx(block);
-        pIndex = chainActive.Next(pIndex);
-    } while (nullptr != pIndex);
+    if (pIndex != nullptr)
+        return ERRORMSG("reloadtxcache() : *** ReadBlockFromDisk failed at %d, hash=%s",
+            pIndex->height, pIndex->GetBlockHash().ToString());
 
     Object obj;
     obj.push_back(Pair("info", "reload tx cache succeed"));
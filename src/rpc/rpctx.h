@@ -44,6 +44,7 @@ extern Value getsignature(const Array& params, bool fHelp);
 
 extern Value listaddr(const Array& params, bool fHelp);
 extern Value listtx(const Array& params, bool fHelp);
+extern Value listaddrtx(const Array& params, bool fHelp);
 extern Value listcontractassets(const Array& params, bool fHelp);
 extern Value listcontracts(const Array& params, bool fHelp);
 extern Value listtxcache(const Array& params, bool fHelp);
@@ -17,6 +17,7 @@
 #include "config/configuration.h"
 #include "main.h"
 #include "vm/luavm/luavmrunenv.h"
+#include "vm/vmprofiler.h"
 #include <algorithm>
 
 #include "commons/json/json_spirit_utils.h"
@@ -46,9 +47,9 @@ static bool FindKeyId(CAccountDBCache *pAccountView, string const &addr, CKeyID
 }
 
 Value vmexecutescript(const Array& params, bool fHelp) {
-    if (fHelp || params.size() < 2 || params.size() > 5) {
+    if (fHelp || params.size() < 2 || params.size() > 6) {
         throw runtime_error(
-            "vmexecutescript \"addr\" \"script_path\" [\"arguments\"] [amount] [symbol:fee:unit]\n"
+            "vmexecutescript \"addr\" \"script_path\" [\"arguments\"] [amount] [symbol:fee:unit] [profile]\n"
             "\nexecutes the script in vm simulator, and then returns the executing status.\n"
             "\nthe execution include submitcontractdeploytx and submitcontractcalltx.\n"
             "\nArguments:\n"
@@ -57,6 +58,8 @@ Value vmexecutescript(const Array& params, bool fHelp) {
             "3.\"arguments\":           (string, optional) contract method invoke content (Hex encode required)\n"
             "4.\"amount\":              (numeric, optional) amount of WICC to send to app account\n"
             "5.\"symbol:fee:unit\":     (string:numeric:string, optional) fee paid for miner, default is WICC:110010000:sawi\n"
+            "6.\"profile\":             (bool, optional) profile the fuel and the time of the contract call by lua stacks and\n"
+            "                          lines, in the folded format of flamegraph.pl, default is false\n"
             "\nResult vm execute detail\n"
             "\nResult:\n"
             "\nExamples:\n"
@@ -205,6 +208,9 @@ Value vmexecutescript(const Array& params, bool fHelp) {
         arguments = ParseHex(params[2].get_str());
     }
 
+    bool profile = params.size() > 5 && params[5].get_bool();
+    CVmProfiler profiler;
+
     CLuaContractInvokeTx contractInvokeTx;
 
     {
@@ -226,6 +232,8 @@ Value vmexecutescript(const Array& params, bool fHelp) {
 
         CValidationState state;
         CTxExecuteContext context(chainActive.Height() + 1, 2, fuelRate, blockTime, prevBlockTime, spCW.get(), &state);
+        if (profile)
+            context.pProfiler = &profiler;
         if (!contractInvokeTx.ExecuteTx(context)) {
             throw JSONRPCError(RPC_TRANSACTION_ERROR, "Executetx contract failed");
         }
@@ -235,6 +243,9 @@ Value vmexecutescript(const Array& params, bool fHelp) {
 
     callContractTxObj.push_back(Pair("run_steps", contractInvokeTx.nRunStep));
     callContractTxObj.push_back(Pair("used_fuel", contractInvokeTx.GetFuel(newHeight, contractInvokeTx.nFuelRate)));
+    // the fuel of the profile is before the refunds of the released storage
+    if (profile)
+        callContractTxObj.push_back(Pair("profile", profiler.ToJson()));
 
     Object retObj;
     retObj.push_back(Pair("fuel_rate",              (int32_t)fuelRate));
@@ -16,6 +16,7 @@
 #include "config/configuration.h"
 #include "miner/miner.h"
 #include "main.h"
+#include "vm/vmprofiler.h"
 //#include "vm/vmrunenv.h"
 #include <stdint.h>
 #include <chrono>
@@ -31,6 +32,7 @@
 #include "datastream.hpp"
 #include "abi_serializer.hpp"
 #include "wasm_context.hpp"
+#include "wasm_code_cache.hpp"
 #include "exceptions.hpp"
 #include "types/name.hpp"
 #include "types/asset.hpp"
@@ -144,6 +146,28 @@ void get_contract(CAccountDBCache*   database_account,
     //JSON_RPC_ASSERT(contract_store.code.size() > 0,                                 RPC_WALLET_ERROR,  "contract lose code")
 }
 
+// the abi of a deployed contract is parsed once and cached along with its code
+std::shared_ptr<const wasm::abi_serializer> get_abi_serializer(CAccountDBCache*  database_account,
+                                                               CContractDBCache* database_contract,
+                                                               const wasm::name& contract_name){
+
+    std::vector<char>  abi;
+    CAccount           contract;
+    CUniversalContract contract_store;
+    bool               native = get_native_contract_abi(contract_name.value, abi);
+    if(!native){
+        get_contract(database_account, database_contract, contract_name, contract, contract_store );
+    }
+
+    try {
+        if(native){
+            return std::make_shared<wasm::abi_serializer>(wasm::unpack<wasm::abi_def>(abi), max_serialization_time);
+        }
+        return wasm::wasm_code_cache::instance().get(contract.regid, contract_store)->get_abi_serializer();
+    }
+    WASM_CAPTURE_AND_RETHROW("rpcwasm.get_abi_serializer, cannot parse abi of contract '%s'", contract_name.to_string().c_str())
+}
+
 // set code and abi
 Value submitwasmcontractdeploytx( const Array &params, bool fHelp ) {
 
@@ -202,8 +226,8 @@ Value submitwasmcontractdeploytx( const Array &params, bool fHelp ) {
 
 Value submitwasmcontractcalltx( const Array &params, bool fHelp ) {
 
-    RESPONSE_RPC_HELP( fHelp || params.size() < 4 || params.size() > 5 , wasm::rpc::submit_wasm_contract_call_tx_rpc_help_message)
-    RPCTypeCheck(params, list_of(str_type)(str_type)(str_type)(str_type)(str_type));
+    RESPONSE_RPC_HELP( fHelp || params.size() < 4 || params.size() > 6 , wasm::rpc::submit_wasm_contract_call_tx_rpc_help_message)
+    RPCTypeCheck(params, list_of(str_type)(str_type)(str_type)(str_type)(str_type)(bool_type));
 
     try {
         auto database_account  = pCdMan->pAccountCache;
@@ -211,14 +235,8 @@ Value submitwasmcontractcalltx( const Array &params, bool fHelp ) {
         auto wallet            = pWalletMain;
 
         //get abi
-        std::vector<char> abi;
-        wasm::name        contract_name = wasm::name(params[1].get_str());
-        if(!get_native_contract_abi(contract_name.value, abi)){
-            CAccount           contract;
-            CUniversalContract contract_store;
-            get_contract(database_account, database_contract, contract_name, contract, contract_store );
-            abi = std::vector<char>(contract_store.abi.begin(), contract_store.abi.end());
-        }
+        wasm::name contract_name = wasm::name(params[1].get_str());
+        auto       abis          = get_abi_serializer(database_account, database_contract, contract_name);
 
         EnsureWalletIsUnlocked();
         CWasmContractTx tx;
@@ -232,8 +250,7 @@ Value submitwasmcontractcalltx( const Array &params, bool fHelp ) {
             std::vector<char> action_data(params[3].get_str().begin(), params[3].get_str().end());
             JSON_RPC_ASSERT(!action_data.empty() && action_data.size() < MAX_CONTRACT_ARGUMENT_SIZE, RPC_WALLET_ERROR,
                             "rpcwasm.submitwasmcontractcalltx, arguments is empty or out of size range")
-            if( abi.size() > 0 ) 
-                action_data = wasm::abi_serializer::pack(abi, action.to_string(), params[3].get_str(), max_serialization_time);
+            action_data = wasm::abi_serializer::pack(*abis, action.to_string(), params[3].get_str(), max_serialization_time);
 
             ComboMoney fee  = RPC_PARAM::GetFee(params, 4, TxType::WASM_CONTRACT_TX);
 
@@ -252,10 +269,31 @@ Value submitwasmcontractcalltx( const Array &params, bool fHelp ) {
             tx.set_signature({payer_name.value, tx.signature});
         }
 
+        Object obj_return;
+        if (params.size() > 5 && params[5].get_bool()) {
+            //dry run against the tip, profiled and not committed
+            CBlockIndex *pTip      = chainActive.Tip();
+            uint32_t fuelRate      = GetElementForBurn(pTip);
+            uint32_t blockTime     = pTip->GetBlockTime();
+            uint32_t prevBlockTime = pTip->pprev != nullptr ? pTip->pprev->GetBlockTime() : pTip->GetBlockTime();
+
+            CCacheWrapper     cw(pCdMan);
+            CValidationState  state;
+            CVmProfiler       profiler;
+            CTxExecuteContext context(chainActive.Height() + 1, 1, fuelRate, blockTime, prevBlockTime, &cw, &state,
+                                      wasm::transaction_status_type::validating);
+            context.pProfiler = &profiler;
+            JSON_RPC_ASSERT(tx.ExecuteTx(context), RPC_TRANSACTION_ERROR, state.GetRejectReason())
+
+            json_spirit::Config::add(obj_return, "txid",     tx.GetHash().GetHex());
+            json_spirit::Config::add(obj_return, "run_steps", tx.nRunStep);
+            json_spirit::Config::add(obj_return, "profile",  profiler.ToJson());
+            return obj_return;
+        }
+
         std::tuple<bool, string> ret = wallet->CommitTx((CBaseTx * ) & tx);
         JSON_RPC_ASSERT(std::get<0>(ret), RPC_WALLET_ERROR, std::get<1>(ret))
 
-        Object obj_return;
         // json_spirit::Value value_json;
         // json_spirit::read_string(std::get<1>(ret), value_json);
         // json_spirit::Config::add(obj_return, "result",  value_json);
@@ -284,7 +322,6 @@ Value gettablewasm( const Array &params, bool fHelp ) {
         CAccount contract;
         CUniversalContract contract_store;
         get_contract(database_account, database_contract, contract_name, contract, contract_store );
-        std::vector<char> abi = std::vector<char>(contract_store.abi.begin(), contract_store.abi.end());
 
         uint64_t numbers = default_query_rows;
         if (params.size() > 2) numbers = std::atoi(params[2].get_str().data());
@@ -299,25 +336,29 @@ Value gettablewasm( const Array &params, bool fHelp ) {
 
         bool                hasMore = false;
         json_spirit::Object object_return;
-        json_spirit::Array  row_json;
+        std::vector<string> keys, values;
         for (pContractDataIt->SeekUpper(&start_key); pContractDataIt->IsValid(); pContractDataIt->Next()) {
             if (pContractDataIt->GotCount() > numbers) {
                 hasMore = true;
                 break;
             }
-            const string &key   = pContractDataIt->GetContractKey();
-            const string &value = pContractDataIt->GetValue();
+            keys.push_back(pContractDataIt->GetContractKey());
+            values.push_back(pContractDataIt->GetValue());
+        }
 
-            //unpack value in bytes to json
-            std::vector<char> value_bytes(value.begin(), value.end());
-            json_spirit::Value value_json    = wasm::abi_serializer::unpack(abi, contract_table.value, value_bytes, max_serialization_time);
-            json_spirit::Object &object_json = value_json.get_obj();
+        //unpack the values in bytes to json with the decoder compiled for the table
+        json_spirit::Array row_json;
+        if (!values.empty()) {
+            auto decoder = wasm::wasm_code_cache::instance().get(contract.regid, contract_store)->get_table_decoder(contract_table.value);
+            row_json     = decoder->decode_rows(values, max_serialization_time);
+        }
 
-            //append key and value
-            object_json.push_back(Pair("key",   ToHex(key, "")));
-            object_json.push_back(Pair("value", ToHex(value, "")));
+        for (size_t i = 0; i < row_json.size(); i++) {
+            json_spirit::Object &object_json = row_json[i].get_obj();
 
-            row_json.push_back(value_json);
+            //append key and value
+            object_json.push_back(Pair("key",   ToHex(keys[i], "")));
+            object_json.push_back(Pair("value", ToHex(values[i], "")));
         }
 
         object_return.push_back(Pair("rows", row_json));
@@ -340,20 +381,14 @@ Value jsontobinwasm( const Array &params, bool fHelp ) {
         auto contract_name     = wasm::name(params[0].get_str());
         auto contract_action   = wasm::name(params[1].get_str());
 
-        std::vector<char>  abi;
-        CAccount           contract;
-        CUniversalContract contract_store;
-        if(!get_native_contract_abi(contract_name.value, abi)){
-            get_contract(database_account, database_contract, contract_name, contract, contract_store );
-            abi = std::vector<char>(contract_store.abi.begin(), contract_store.abi.end());
-        }
+        auto abis = get_abi_serializer(database_account, database_contract, contract_name);
 
         string arguments = params[2].get_str();
         JSON_RPC_ASSERT(!arguments.empty() && arguments.size() < MAX_CONTRACT_ARGUMENT_SIZE,
                         RPC_INVALID_PARAMETER,
                         "rpcwasm.abijsontobinwasmcontracttx, arguments is empty or out of size range")
         std::vector<char> action_data(arguments.begin(), arguments.end() );
-        if( abi.size() > 0 ) action_data = wasm::abi_serializer::pack(abi, contract_action.to_string(), arguments, max_serialization_time);
+        action_data = wasm::abi_serializer::pack(*abis, contract_action.to_string(), arguments, max_serialization_time);
 
         json_spirit::Object object_return;
         object_return.push_back(Pair("data", wasm::ToHex(action_data,"")));
@@ -376,13 +411,7 @@ Value bintojsonwasm( const Array &params, bool fHelp ) {
         auto contract_name     = wasm::name(params[0].get_str());
         auto contract_action   = wasm::name(params[1].get_str());
 
-        std::vector<char>  abi;
-        CAccount           contract;
-        CUniversalContract contract_store;
-        if(!get_native_contract_abi(contract_name.value, abi)){
-            get_contract(database_account, database_contract, contract_name, contract, contract_store );
-            abi = std::vector<char>(contract_store.abi.begin(), contract_store.abi.end());
-        }
+        auto abis = get_abi_serializer(database_account, database_contract, contract_name);
 
         string arguments = FromHex(params[2].get_str());
         JSON_RPC_ASSERT(!arguments.empty() && arguments.size() < MAX_CONTRACT_ARGUMENT_SIZE,
@@ -391,7 +420,7 @@ Value bintojsonwasm( const Array &params, bool fHelp ) {
 
         json_spirit::Object object_return;
         std::vector<char>   action_data(arguments.begin(), arguments.end() );
-        json_spirit::Value  value = wasm::abi_serializer::unpack(abi, contract_action.to_string(), action_data, max_serialization_time);
+        json_spirit::Value  value = wasm::abi_serializer::unpack(*abis, contract_action.to_string(), action_data, max_serialization_time);
         object_return.push_back(Pair("data", value));
         return object_return;
 
@@ -0,0 +1,82 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <string>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "wasm/abi_decoder.hpp"
+#include "wasm/abi_serializer.hpp"
+#include "wasm/wasm_config.hpp"
+
+using namespace std;
+using namespace wasm;
+
+BOOST_AUTO_TEST_SUITE(abi_decoder_tests)
+
+static abi_def TestAbi() {
+    abi_def def;
+    def.version = "wasm::abi/1.1";
+    def.types   = {type_def("account_name", "name")};
+    def.structs = {
+        struct_def("child", "", {field_def("id", "uint32"), field_def("hash", "checksum256")}),
+        struct_def("base_row", "", {field_def("owner", "account_name"), field_def("balance", "asset")}),
+        struct_def("row", "base_row", {field_def("ids", "uint64[]"), field_def("memo", "string?"),
+                                       field_def("children", "child[]"), field_def("extra", "child"),
+                                       field_def("tag", "varuint32$")})};
+    def.tables  = {table_def("rows", "i64", {"owner"}, {"uint64"}, "row")};
+    return def;
+}
+
+static string ToJson(const json_spirit::Value &value) { return json_spirit::write(value); }
+
+static bytes PackRow(const abi_serializer &abis, const string &json) {
+    json_spirit::Value value;
+    json_spirit::read_string(json, value);
+    return abis.variant_to_binary("row", value, max_serialization_time);
+}
+
+BOOST_AUTO_TEST_CASE(abi_decoder_same_json_test)
+{
+    abi_serializer abis(TestAbi(), max_serialization_time);
+    abi_decoder decoder(abis, abis.get_table_type("rows"));
+
+    const string hash = string(64, 'a');
+    vector<string> jsons = {
+        R"({"owner":"alice","balance":"1.00000000 WICC","ids":[1,2,3],"memo":"hello",)"
+        R"("children":[{"id":1,"hash":")" + hash + R"("}],"extra":{"id":2,"hash":")" + hash + R"("},"tag":7})",
+        R"({"owner":"bob","balance":"0.00000001 WUSD","ids":[],"children":[],"extra":{"id":3,"hash":")" + hash + R"("},"tag":0})"};
+
+    vector<string> rows;
+    for (const auto &json : jsons) {
+        bytes binary = PackRow(abis, json);
+        BOOST_CHECK_EQUAL(ToJson(decoder.decode(binary, max_serialization_time)),
+                          ToJson(abis.binary_to_variant("row", binary, max_serialization_time)));
+        rows.emplace_back(binary.begin(), binary.end());
+    }
+
+    json_spirit::Array values = decoder.decode_rows(rows, max_serialization_time);
+    BOOST_CHECK_EQUAL(values.size(), rows.size());
+    for (size_t i = 0; i < rows.size(); i++) {
+        bytes binary(rows[i].begin(), rows[i].end());
+        BOOST_CHECK_EQUAL(ToJson(values[i]), ToJson(abis.binary_to_variant("row", binary, max_serialization_time)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(abi_decoder_error_test)
+{
+    abi_serializer abis(TestAbi(), max_serialization_time);
+
+    // an oversized array and an undefined type fail the same way as binary_to_variant
+    bytes oversized = {char(0x81), 0x08}; // varuint32 1025
+    BOOST_CHECK_THROW(abi_decoder(abis, "child[]").decode(oversized, max_serialization_time),
+                      array_size_exceeds_exception);
+    BOOST_CHECK_THROW(abis.binary_to_variant("child[]", oversized, max_serialization_time),
+                      array_size_exceeds_exception);
+
+    bytes data = {1, 2};
+    BOOST_CHECK_THROW(abi_decoder(abis, "undefined_type").decode(data, max_serialization_time), unpack_exception);
+    BOOST_CHECK_THROW(abis.binary_to_variant("undefined_type", data, max_serialization_time), unpack_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
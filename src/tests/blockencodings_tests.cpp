@@ -0,0 +1,127 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <memory>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "config/version.h"
+#include "p2p/blockencodings.h"
+#include "tx/txmempool.h"
+#include "tx/txserializer.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(blockencodings_tests)
+
+// a block reward tx and the transfer txs
+static CBlock MakeBlock(uint32_t txCount) {
+    CBlock block;
+    block.SetHeight(100);
+    block.SetTime(1577836800);
+    block.vptx.push_back(make_shared<CBlockRewardTx>(CRegID(1, 1).GetRegIdRaw(), 0, 100));
+    for (uint32_t i = 0; i < txCount; i++) {
+        block.vptx.push_back(make_shared<CBaseCoinTransferTx>(CUserID(CRegID(1, i + 1)), CUserID(CRegID(2, i + 1)),
+                                                             100, COIN + i, COIN / 10, ""));
+    }
+    block.SetMerkleRootHash(block.BuildMerkleTree());
+    return block;
+}
+
+static void AddToMempool(CTxMemPool &pool, const std::shared_ptr<CBaseTx> &pTx) {
+    pool.memPoolTxs[pTx->GetHash()] = CTxMemPoolEntry(pTx.get(), 0, 100);
+}
+
+BOOST_AUTO_TEST_CASE(cmpctblock_serialize) {
+    CBlock block = MakeBlock(20);
+    CBlockHeaderAndShortTxIDs cmpctBlock(block, 42);
+    BOOST_CHECK_EQUAL(cmpctBlock.shortTxIds.size(), 20);
+    BOOST_REQUIRE_EQUAL(cmpctBlock.prefilledTxs.size(), 1);
+    BOOST_CHECK_EQUAL(cmpctBlock.prefilledTxs[0].index, 0);
+
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << cmpctBlock;
+    BOOST_CHECK(ss.size() < ::GetSerializeSize(block, SER_NETWORK, PROTOCOL_VERSION));
+
+    CBlockHeaderAndShortTxIDs cmpctBlock2;
+    ss >> cmpctBlock2;
+    BOOST_CHECK(cmpctBlock2.header.GetHash() == block.GetHash());
+    BOOST_CHECK(cmpctBlock2.shortTxIds == cmpctBlock.shortTxIds);
+    BOOST_REQUIRE_EQUAL(cmpctBlock2.prefilledTxs.size(), 1);
+    BOOST_CHECK(cmpctBlock2.prefilledTxs[0].pTx->GetHash() == block.vptx[0]->GetHash());
+    for (uint32_t i = 1; i < block.vptx.size(); i++) {
+        uint64_t shortTxId = cmpctBlock2.GetShortTxId(block.vptx[i]->GetHash());
+        BOOST_CHECK_EQUAL(shortTxId, cmpctBlock.shortTxIds[i - 1]);
+        BOOST_CHECK(shortTxId <= 0xffffffffffffULL);
+    }
+
+    // the short txids are salted by the nonce
+    CBlockHeaderAndShortTxIDs cmpctBlock3(block, 43);
+    BOOST_CHECK(cmpctBlock3.shortTxIds != cmpctBlock.shortTxIds);
+}
+
+BOOST_AUTO_TEST_CASE(rebuild_from_mempool) {
+    CBlock block = MakeBlock(20);
+    CBlockHeaderAndShortTxIDs cmpctBlock(block, 7);
+
+    CTxMemPool pool;
+    for (uint32_t i = 1; i < block.vptx.size(); i++) {
+        if (i != 3 && i != 10 && i != 20)
+            AddToMempool(pool, block.vptx[i]);
+    }
+    AddToMempool(pool, make_shared<CBaseCoinTransferTx>(CUserID(CRegID(3, 1)), CUserID(CRegID(4, 1)), 100, COIN,
+                                                        COIN / 10, ""));  // out of the block
+
+    CPartialBlock partialBlock;
+    BOOST_REQUIRE(partialBlock.Init(cmpctBlock, pool) == CMPCT_READ_OK);
+    BOOST_CHECK_EQUAL(partialBlock.GetMempoolTxCount(), 17);
+    BOOST_CHECK(partialBlock.GetMissingTxIndexes() == vector<uint32_t>({3, 10, 20}));
+
+    CBlock rebuilt;
+    vector<std::shared_ptr<CBaseTx>> missingTxs = {block.vptx[3], block.vptx[10], block.vptx[20]};
+    BOOST_REQUIRE(partialBlock.FillBlock(rebuilt, missingTxs) == CMPCT_READ_OK);
+    BOOST_CHECK(rebuilt.GetHash() == block.GetHash());
+    BOOST_REQUIRE_EQUAL(rebuilt.vptx.size(), block.vptx.size());
+    for (uint32_t i = 0; i < block.vptx.size(); i++) {
+        BOOST_CHECK(rebuilt.vptx[i]->GetHash() == block.vptx[i]->GetHash());
+        BOOST_CHECK(rebuilt.vptx[i] != pool.Lookup(block.vptx[i]->GetHash()));  // not shared with the mempool
+    }
+
+    // wrong count of the missing txs
+    missingTxs.pop_back();
+    BOOST_CHECK(partialBlock.FillBlock(rebuilt, missingTxs) == CMPCT_READ_INVALID);
+    // wrong txs, the merkle root mismatches
+    missingTxs = {block.vptx[10], block.vptx[3], block.vptx[20]};
+    BOOST_CHECK(partialBlock.FillBlock(rebuilt, missingTxs) == CMPCT_READ_FAILED);
+
+    // all the txs in the mempool
+    AddToMempool(pool, block.vptx[3]);
+    AddToMempool(pool, block.vptx[10]);
+    AddToMempool(pool, block.vptx[20]);
+    CPartialBlock partialBlock2;
+    BOOST_REQUIRE(partialBlock2.Init(cmpctBlock, pool) == CMPCT_READ_OK);
+    BOOST_CHECK(partialBlock2.GetMissingTxIndexes().empty());
+    BOOST_CHECK(partialBlock2.FillBlock(rebuilt, {}) == CMPCT_READ_OK);
+    BOOST_CHECK(rebuilt.GetHash() == block.GetHash());
+}
+
+BOOST_AUTO_TEST_CASE(invalid_cmpctblock) {
+    CBlock block = MakeBlock(5);
+    CTxMemPool pool;
+
+    CBlockHeaderAndShortTxIDs outOfBlock(block, 1);
+    outOfBlock.prefilledTxs[0].index = 6;
+    CPartialBlock partialBlock;
+    BOOST_CHECK(partialBlock.Init(outOfBlock, pool) == CMPCT_READ_INVALID);
+
+    CBlockHeaderAndShortTxIDs noTx(block, 1);
+    noTx.prefilledTxs[0].pTx = nullptr;
+    BOOST_CHECK(partialBlock.Init(noTx, pool) == CMPCT_READ_INVALID);
+
+    // two txs of the block with the same short txid, the full block is needed
+    CBlockHeaderAndShortTxIDs collided(block, 1);
+    collided.shortTxIds[1] = collided.shortTxIds[0];
+    BOOST_CHECK(partialBlock.Init(collided, pool) == CMPCT_READ_FAILED);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "commons/serialize.h"
+#include "commons/util/util.h"
+#include "config/version.h"
+#include "persistence/blockfilereader.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(blockfilereader_tests)
+
+// a block file number far from the ones of the chain
+static const int32_t TEST_FILE = 99990;
+
+static boost::filesystem::path TestFilePath(int32_t nFile) {
+    return GetDataDir() / "blocks" / strprintf("blk%05u.dat", nFile);
+}
+
+static void AppendTestFile(int32_t nFile, const vector<char> &data) {
+    boost::filesystem::create_directories(GetDataDir() / "blocks");
+    FILE *file = fopen(TestFilePath(nFile).string().c_str(), "ab");
+    BOOST_REQUIRE(file != nullptr);
+    BOOST_REQUIRE_EQUAL(fwrite(data.data(), 1, data.size(), file), data.size());
+    fclose(file);
+}
+
+BOOST_AUTO_TEST_CASE(positional_reads) {
+    CBlockFileReader reader;
+    vector<char> data(10000);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (char)(i * 7);
+    AppendTestFile(TEST_FILE, data);
+
+    vector<char> buf(100);
+    BOOST_CHECK_EQUAL(reader.Read(TEST_FILE, 5000, buf.data(), buf.size()), 100);
+    BOOST_CHECK(equal(buf.begin(), buf.end(), data.begin() + 5000));
+    BOOST_CHECK_EQUAL(reader.Read(TEST_FILE, 9950, buf.data(), buf.size()), 50);  // up to the end of file
+    BOOST_CHECK_EQUAL(reader.Read(TEST_FILE, 20000, buf.data(), buf.size()), 0);
+    BOOST_CHECK_EQUAL(reader.Read(TEST_FILE + 1, 0, buf.data(), buf.size()), -1);  // no such file
+    BOOST_CHECK_EQUAL(reader.GetOpenCount(), 1);
+
+    // the kept handle sees the appended data
+    AppendTestFile(TEST_FILE, vector<char>(100, 'x'));
+    BOOST_CHECK_EQUAL(reader.Read(TEST_FILE, 10050, buf.data(), buf.size()), 50);
+    BOOST_CHECK_EQUAL(buf[0], 'x');
+
+    auto stats = reader.GetStats();
+    BOOST_CHECK_EQUAL(stats[TEST_FILE].reads, 4);
+    BOOST_CHECK_EQUAL(stats[TEST_FILE].bytes, 200);
+
+    reader.CloseAll();
+    BOOST_CHECK_EQUAL(reader.GetOpenCount(), 0);
+    boost::filesystem::remove(TestFilePath(TEST_FILE));
+}
+
+BOOST_AUTO_TEST_CASE(stream_reads) {
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    for (uint32_t i = 0; i < 3000; i++)
+        ss << i;
+    string str(5000, 's');
+    ss << str;
+    AppendTestFile(TEST_FILE, vector<char>(ss.begin(), ss.end()));
+
+    CBlockFileStream stream(CDiskBlockPos(TEST_FILE, 0), SER_DISK, CLIENT_VERSION);
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < 10; i++) {
+        stream >> n;
+        BOOST_CHECK_EQUAL(n, i);
+    }
+    stream.ignore(4);  // in the buffer
+    stream >> n;
+    BOOST_CHECK_EQUAL(n, 11);
+    stream.ignore(4 * 2000);  // past the buffer
+    stream >> n;
+    BOOST_CHECK_EQUAL(n, 2012);
+
+    stream.ReadAhead(4 * (3000 - 2013) + 3 + str.size());
+    for (uint32_t i = 2013; i < 3000; i++) {
+        stream >> n;
+        BOOST_CHECK_EQUAL(n, i);
+    }
+    string read;
+    stream >> read;
+    BOOST_CHECK(read == str);
+    BOOST_CHECK_THROW(stream >> n, ios_base::failure);
+
+    GetBlockFileReader().CloseAll();
+    boost::filesystem::remove(TestFilePath(TEST_FILE));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <set>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "commons/uint256.h"
+#include "crypto/hash.h"
+#include "persistence/block.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(blockindex_tests)
+
+BOOST_AUTO_TEST_CASE(arena_alloc_clear) {
+    CBlockIndexArena arena;
+    BOOST_CHECK_EQUAL(arena.GetSlabCount(), 0);
+
+    vector<CBlockIndex *> indexes;
+    for (size_t i = 0; i < BLOCK_INDEX_SLAB_SIZE + 10; i++) {
+        CBlockIndex *pIndex = arena.Alloc();
+        BOOST_CHECK(pIndex->pprev == nullptr && pIndex->height == 0);
+        pIndex->height = i;
+        indexes.push_back(pIndex);
+    }
+    BOOST_CHECK_EQUAL(arena.GetSlabCount(), 2);
+    BOOST_CHECK_EQUAL(arena.GetAllocatedCount(), BLOCK_INDEX_SLAB_SIZE + 10);
+    BOOST_CHECK_EQUAL(arena.GetMemoryUsage(), 2 * BLOCK_INDEX_SLAB_SIZE * sizeof(CBlockIndex));
+    BOOST_CHECK_EQUAL(set<CBlockIndex *>(indexes.begin(), indexes.end()).size(), indexes.size());
+    for (size_t i = 0; i < indexes.size(); i++)
+        BOOST_CHECK_EQUAL(indexes[i]->height, (int32_t)i);
+
+    arena.Clear();
+    BOOST_CHECK_EQUAL(arena.GetSlabCount(), 0);
+    BOOST_CHECK_EQUAL(arena.GetAllocatedCount(), 0);
+    arena.Alloc();
+    BOOST_CHECK_EQUAL(arena.GetSlabCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(block_map) {
+    CBlockIndexArena arena;
+    BlockMap blockMap;
+    vector<uint256> hashes;
+    for (uint32_t i = 0; i < 10000; i++) {
+        uint256 hash = Hash(BEGIN(i), END(i));
+        CBlockIndex *pIndex = arena.Alloc();
+        pIndex->blockHash   = hash;
+        pIndex->height      = i;
+        pIndex->pprev       = i > 0 ? blockMap[hashes.back()] : nullptr;
+        BOOST_CHECK(blockMap.insert(make_pair(hash, pIndex)).second);
+        hashes.push_back(hash);
+    }
+    BOOST_CHECK_EQUAL(blockMap.size(), 10000);
+
+    // the hashes are kept by the indexes across the rehashes of the map
+    for (uint32_t i = 0; i < hashes.size(); i++) {
+        BlockMap::iterator it = blockMap.find(hashes[i]);
+        BOOST_REQUIRE(it != blockMap.end());
+        BOOST_CHECK(it->second->GetBlockHash() == hashes[i]);
+        BOOST_CHECK_EQUAL(it->second->height, (int32_t)i);
+        if (i > 0)
+            BOOST_CHECK(it->second->pprev->GetBlockHash() == hashes[i - 1]);
+    }
+
+    BOOST_CHECK_EQUAL(blockMap.erase(hashes[0]), 1);
+    BOOST_CHECK(blockMap.find(hashes[0]) == blockMap.end());
+    BOOST_CHECK_EQUAL(blockMap.count(hashes[1]), 1);
+}
+
+BOOST_AUTO_TEST_CASE(block_map_hasher) {
+    // salted, the buckets are not chosen by the block hashes themselves
+    CBlockHashHasher hasher;
+    size_t cheapHashes = 0;
+    for (uint32_t i = 0; i < 100; i++) {
+        uint256 hash = Hash(BEGIN(i), END(i));
+        BOOST_CHECK_EQUAL(hasher(hash), CBlockHashHasher()(hash));
+        if (hasher(hash) == hash.GetCheapHash())
+            cheapHashes++;
+    }
+    BOOST_CHECK_EQUAL(cheapHashes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(erased_index_kept) {
+    CBlockIndexArena arena;
+    BlockMap blockMap;
+    vector<CBlockIndex *> indexes;
+    for (uint32_t i = 0; i < 100; i++) {
+        CBlockIndex *pIndex = arena.Alloc();
+        pIndex->blockHash   = Hash(BEGIN(i), END(i));
+        pIndex->height      = i;
+        pIndex->pprev       = i > 0 ? indexes.back() : nullptr;
+        pIndex->vSignature.assign(64, (unsigned char)i);
+        blockMap.insert(make_pair(pIndex->blockHash, pIndex));
+        indexes.push_back(pIndex);
+    }
+
+    // the erased indexes may still be pointed to by pprev, they are not reused by the arena
+    for (uint32_t i = 0; i < 50; i++)
+        BOOST_CHECK_EQUAL(blockMap.erase(indexes[i]->GetBlockHash()), 1);
+    set<CBlockIndex *> allocated(indexes.begin(), indexes.end());
+    for (uint32_t i = 0; i < 50; i++)
+        BOOST_CHECK(allocated.insert(arena.Alloc()).second);
+    BOOST_CHECK_EQUAL(arena.GetAllocatedCount(), 150);
+
+    CBlockIndex *pIndex = indexes.back();
+    for (int32_t height = 99; height >= 0; height--, pIndex = pIndex->pprev) {
+        BOOST_REQUIRE(pIndex != nullptr);
+        BOOST_CHECK_EQUAL(pIndex->height, height);
+        BOOST_CHECK(pIndex->GetBlockHash() == Hash(BEGIN(height), END(height)));
+        BOOST_CHECK(pIndex->GetBlockHeader().GetSignature() == vector<unsigned char>(64, (unsigned char)height));
+    }
+    BOOST_CHECK(pIndex == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
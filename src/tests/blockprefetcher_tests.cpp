@@ -0,0 +1,127 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <memory>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "commons/util/util.h"
+#include "config/version.h"
+#include "persistence/blockfilereader.h"
+#include "persistence/blockprefetcher.h"
+#include "tx/blockrewardtx.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(blockprefetcher_tests)
+
+// a block file number far from the ones of the chain
+static const int32_t TEST_FILE = 99991;
+
+static boost::filesystem::path TestFilePath(int32_t nFile) {
+    return GetDataDir() / "blocks" / strprintf("blk%05u.dat", nFile);
+}
+
+// write the blocks to the test file as WriteBlockToDisk() does, return their indexes
+static vector<CBlockIndex> WriteTestBlocks(uint32_t count) {
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    vector<CBlockIndex> indexes;
+    for (uint32_t i = 0; i < count; i++) {
+        CBlock block;
+        block.SetHeight(i + 1);
+        block.SetTime(1577836800 + i);
+        block.vptx.push_back(make_shared<CBlockRewardTx>(CRegID(1, 1).GetRegIdRaw(), i, i + 1));
+        block.SetMerkleRootHash(block.BuildMerkleTree());
+
+        ss << FLATDATA(SysCfg().MessageStart()) << (uint32_t)::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+        CBlockIndex index(block);
+        index.height   = i + 1;
+        index.nFile    = TEST_FILE;
+        index.nDataPos = ss.size();
+        index.nStatus  = BLOCK_HAVE_DATA;
+        indexes.push_back(index);
+        ss << block;
+    }
+
+    boost::filesystem::create_directories(GetDataDir() / "blocks");
+    FILE *file = fopen(TestFilePath(TEST_FILE).string().c_str(), "wb");
+    BOOST_REQUIRE(file != nullptr);
+    BOOST_REQUIRE_EQUAL(fwrite(&ss[0], 1, ss.size(), file), ss.size());
+    fclose(file);
+    return indexes;
+}
+
+static void RemoveTestFile() {
+    GetBlockFileReader().CloseAll();
+    boost::filesystem::remove(TestFilePath(TEST_FILE));
+}
+
+BOOST_AUTO_TEST_CASE(read_in_order) {
+    vector<CBlockIndex> indexes = WriteTestBlocks(100);
+    vector<CBlockIndex *> vIndex;
+    for (auto &index : indexes)
+        vIndex.push_back(&index);
+
+    CBlockPrefetcher prefetcher(vIndex, 4);
+    CBlockIndex *pIndex;
+    CBlock block;
+    uint32_t count = 0;
+    while (prefetcher.Next(pIndex, block)) {
+        BOOST_CHECK(pIndex == vIndex[count]);
+        BOOST_CHECK(block.GetHash() == pIndex->GetBlockHash());
+        count++;
+    }
+    BOOST_CHECK(pIndex == nullptr);
+    BOOST_CHECK_EQUAL(count, 100);
+    BOOST_CHECK(!prefetcher.Next(pIndex, block));
+
+    // from the last block down, as from the tip
+    vector<CBlockIndex *> vReversed(vIndex.rbegin(), vIndex.rend());
+    CBlockPrefetcher reversedPrefetcher(vReversed);
+    count = 0;
+    while (reversedPrefetcher.Next(pIndex, block)) {
+        BOOST_CHECK(pIndex == vReversed[count]);
+        BOOST_CHECK(block.GetHash() == pIndex->GetBlockHash());
+        count++;
+    }
+    BOOST_CHECK(pIndex == nullptr);
+    BOOST_CHECK_EQUAL(count, 100);
+
+    RemoveTestFile();
+}
+
+BOOST_AUTO_TEST_CASE(read_failed) {
+    vector<CBlockIndex> indexes = WriteTestBlocks(20);
+    vector<CBlockIndex *> vIndex;
+    for (auto &index : indexes)
+        vIndex.push_back(&index);
+    indexes[10].nDataPos += 1;  // not the position of a block
+
+    CBlockPrefetcher prefetcher(vIndex, 2);
+    CBlockIndex *pIndex;
+    CBlock block;
+    uint32_t count = 0;
+    while (prefetcher.Next(pIndex, block))
+        count++;
+    BOOST_CHECK_EQUAL(count, 10);
+    BOOST_CHECK(pIndex == vIndex[10]);
+    BOOST_CHECK(!prefetcher.Next(pIndex, block));
+    BOOST_CHECK(pIndex == nullptr);
+
+    // stopped by the reader before the end
+    {
+        CBlockPrefetcher stopped(vIndex, 2);
+        BOOST_CHECK(stopped.Next(pIndex, block));
+        BOOST_CHECK(pIndex == vIndex[0]);
+    }
+    CBlockPrefetcher empty({});
+    BOOST_CHECK(!empty.Next(pIndex, block));
+    BOOST_CHECK(pIndex == nullptr);
+
+    RemoveTestFile();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
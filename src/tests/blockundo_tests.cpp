@@ -0,0 +1,127 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include "commons/arith_uint256.h"
+#include "commons/util/util.h"
+#include "config/version.h"
+#include "main.h"
+#include "persistence/blockfilereader.h"
+#include "persistence/blockundo.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(blockundo_tests)
+
+// an undo file number far from the ones of the chain
+static const int32_t TEST_FILE = 99990;
+
+static CBlockUndo MakeBlockUndo(uint32_t txCount) {
+    CBlockUndo blockUndo;
+    for (uint32_t i = 0; i < txCount; i++) {
+        CTxUndo txUndo(ArithToUint256(arith_uint256(i + 1)));
+        for (uint32_t j = 0; j <= i % 3; j++) {
+            CDbOpLog opLog;
+            opLog.Set(strprintf("key%u-%u", i, j), string(i * 10 + j, 'v'));
+            txUndo.dbOpLogMap.AddOpLog(j % 2 ? dbk::KEYID_ACCOUNT : dbk::CONTRACT_DATA, opLog);
+        }
+        blockUndo.vtxundo.push_back(txUndo);
+    }
+    return blockUndo;
+}
+
+static void CheckEqual(const CBlockUndo &a, const CBlockUndo &b) {
+    CDataStream ssA(SER_DISK, CLIENT_VERSION), ssB(SER_DISK, CLIENT_VERSION);
+    ssA << a;
+    ssB << b;
+    BOOST_CHECK(ssA.str() == ssB.str());
+}
+
+static void RemoveTestFile() {
+    GetUndoFileReader().CloseAll();
+    boost::filesystem::remove(GetDataDir() / "blocks" / strprintf("rev%05u.dat", TEST_FILE));
+}
+
+BOOST_AUTO_TEST_CASE(write_read) {
+    RemoveTestFile();
+    uint256 prevHash = ArithToUint256(arith_uint256(42));
+
+    // an undo record written as by the former releases, followed by two records of this release
+    CBlockUndo oldUndo = MakeBlockUndo(5);
+    CDiskBlockPos oldPos(TEST_FILE, 0);
+    {
+        CAutoFile fileout(OpenUndoFile(oldPos), SER_DISK, CLIENT_VERSION);
+        BOOST_REQUIRE(!!fileout);
+        fileout << FLATDATA(SysCfg().MessageStart()) << fileout.GetSerializeSize(oldUndo);
+        oldPos.nPos = ftell(fileout);
+        fileout << oldUndo;
+        CHashWriter hasher(SER_GETHASH, PROTOCOL_VERSION);
+        hasher << prevHash << oldUndo;
+        fileout << hasher.GetHash();
+    }
+
+    vector<CDiskBlockPos> positions;
+    vector<CBlockUndo> undos = {MakeBlockUndo(10), MakeBlockUndo(20)};
+    for (const auto &undo : undos) {
+        CDataStream ssUndo(SER_DISK, CLIENT_VERSION);
+        ssUndo << undo;
+        CDiskBlockPos pos(TEST_FILE, boost::filesystem::file_size(GetDataDir() / "blocks" /
+                                                                  strprintf("rev%05u.dat", TEST_FILE)));
+        BOOST_REQUIRE(CBlockUndo::WriteToDisk(pos, prevHash, ssUndo));
+        positions.push_back(pos);
+    }
+
+    CBlockUndo read;
+    BOOST_REQUIRE(read.ReadFromDisk(oldPos, prevHash));
+    CheckEqual(read, oldUndo);
+    for (int32_t i = positions.size() - 1; i >= 0; i--) {  // backwards as when disconnecting blocks
+        BOOST_REQUIRE(read.ReadFromDisk(positions[i], prevHash));
+        CheckEqual(read, undos[i]);
+    }
+
+    // the checksums cover the hash of the previous block
+    BOOST_CHECK(!read.ReadFromDisk(oldPos, uint256()));
+    BOOST_CHECK(!read.ReadFromDisk(positions[0], uint256()));
+    // not the position of a record
+    BOOST_CHECK(!read.ReadFromDisk(CDiskBlockPos(TEST_FILE, positions[0].nPos + 1), prevHash));
+
+    RemoveTestFile();
+}
+
+BOOST_AUTO_TEST_CASE(same_record_as_former_releases) {
+    RemoveTestFile();
+    uint256 prevHash = ArithToUint256(arith_uint256(42));
+    CBlockUndo undo  = MakeBlockUndo(10);
+
+    // the record of the former releases, the undo data serialized into the file and hashed again
+    CDataStream ssFormer(SER_DISK, CLIENT_VERSION);
+    {
+        CHashWriter hasher(SER_GETHASH, PROTOCOL_VERSION);
+        hasher << prevHash << undo;
+        uint32_t nSize = ::GetSerializeSize(undo, SER_DISK, CLIENT_VERSION);
+        ssFormer << FLATDATA(SysCfg().MessageStart()) << nSize << undo << hasher.GetHash();
+    }
+
+    CDataStream ssUndo(SER_DISK, CLIENT_VERSION);
+    ssUndo << undo;
+    CDiskBlockPos pos(TEST_FILE, 0);
+    BOOST_REQUIRE(CBlockUndo::WriteToDisk(pos, prevHash, ssUndo));
+    BOOST_CHECK_EQUAL(pos.nPos, MESSAGE_START_SIZE + sizeof(uint32_t));
+
+    boost::filesystem::path path = GetDataDir() / "blocks" / strprintf("rev%05u.dat", TEST_FILE);
+    BOOST_REQUIRE_EQUAL(boost::filesystem::file_size(path), ssFormer.size());
+    string written(ssFormer.size(), '\0');
+    FILE *file = fopen(path.string().c_str(), "rb");
+    BOOST_REQUIRE(file != nullptr);
+    BOOST_CHECK_EQUAL(fread(&written[0], 1, written.size(), file), written.size());
+    fclose(file);
+    BOOST_CHECK(written == ssFormer.str());
+
+    RemoveTestFile();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
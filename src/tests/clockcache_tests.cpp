@@ -0,0 +1,44 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include "commons/clockcache.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(clockcache_tests)
+
+BOOST_AUTO_TEST_CASE(clockcache_evict_test)
+{
+    clockcache<string, int32_t> cache(30);
+    for (int32_t i = 0; i < 3; i++)
+        cache.insert(to_string(i), i, 10);
+    BOOST_CHECK_EQUAL(cache.size(), 3U);
+    BOOST_CHECK_EQUAL(cache.usage(), 30U);
+
+    // "0" is referenced, so "1" is evicted instead
+    BOOST_CHECK(cache.find("0") != nullptr && *cache.find("0") == 0);
+    cache.insert("3", 3, 10);
+    BOOST_CHECK_EQUAL(cache.size(), 3U);
+    BOOST_CHECK(cache.find("1") == nullptr);
+    BOOST_CHECK(cache.find("0") != nullptr && cache.find("3") != nullptr);
+
+    // replace in place
+    cache.insert("3", 33, 5);
+    BOOST_CHECK_EQUAL(*cache.find("3"), 33);
+    BOOST_CHECK_EQUAL(cache.usage(), 25U);
+
+    // too large to cache
+    cache.insert("4", 4, 31);
+    BOOST_CHECK(cache.find("4") == nullptr);
+
+    BOOST_CHECK(cache.erase("0") && !cache.erase("0"));
+    BOOST_CHECK_EQUAL(cache.usage(), 15U);
+
+    cache.set_max_usage(0);
+    BOOST_CHECK(cache.empty() && cache.usage() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -9,6 +9,8 @@
 #include <map>
 #include <boost/test/unit_test.hpp>
 #include "persistence/dbaccess.h"
+#include "persistence/dbiterator.h"
+#include "persistence/pricefeeddb.h"
 
 using namespace std;
 
@@ -144,4 +146,197 @@ BOOST_AUTO_TEST_CASE(dbcache_scalar_value_Level3_test)
     BOOST_CHECK( value1 == "keyid-1" );
 }
 
+BOOST_AUTO_TEST_CASE(dbcache_iterator_test)
+{
+    const bool isWipe = true;
+    const dbk::PrefixType prefix = dbk::REGID_KEYID;
+    shared_ptr<CDBAccess> pDBAccess = make_shared<CDBAccess>(
+        db_dir, DBNameType::ACCOUNT, false, isWipe);
+
+    typedef CHashKVCache<prefix, string, string> HashCache;
+    auto pDBCache1 = make_shared<HashCache>(pDBAccess.get());
+    auto pDBCache2 = make_shared<HashCache>(pDBCache1.get());
+    auto pDBCache3 = make_shared<HashCache>(pDBCache2.get());
+    pDBCache1->SetData("a", "keyid-a");
+    pDBCache1->SetData("bb", "keyid-bb");
+    pDBCache1->SetData("ccc", "keyid-ccc");
+    pDBCache1->Flush();
+
+    pDBCache2->SetData("bb", "keyid-bb2");
+    pDBCache2->EraseData("ccc");
+    pDBCache3->SetData("c", "keyid-c");
+    pDBCache3->EraseData("a");
+
+    // merged in db key order, the shorter strings come first
+    vector<string> keys, values;
+    CDBIterator<HashCache> it(*pDBCache3);
+    for (it.First(); it.IsValid(); it.Next()) {
+        keys.push_back(it.GetKey());
+        values.push_back(it.GetValue());
+    }
+    BOOST_CHECK(keys == vector<string>({"c", "bb"}));
+    BOOST_CHECK(values == vector<string>({"keyid-c", "keyid-bb2"}));
+
+    const string lastKey = "c";
+    BOOST_CHECK(it.SeekUpper(&lastKey) && it.GetKey() == "bb");
+    BOOST_CHECK(!it.Next());
+}
+
+BOOST_AUTO_TEST_CASE(dbcache_addr_tx_index_test)
+{
+    const bool isWipe = true;
+    shared_ptr<CDBAccess> pDBAccess = make_shared<CDBAccess>(
+        db_dir, DBNameType::BLOCK, false, isWipe);
+
+    CBlockDBCache blockCache1(pDBAccess.get());
+    CBlockDBCache blockCache2;
+    blockCache2.SetBaseViewPtr(&blockCache1);
+
+    CKeyID keyId1(uint160(vector<unsigned char>(20, 1)));
+    CKeyID keyId2(uint160(vector<unsigned char>(20, 2)));
+    auto txid = [](uint32_t height, uint32_t index) { return ArithToUint256(arith_uint256(height * 1000 + index)); };
+
+    // the older blocks in db, the newer ones in the cache layer
+    for (uint32_t height : {1, 5, 200}) {
+        blockCache1.SetAddrTxIndex(keyId1, height, 1, txid(height, 1));
+        blockCache1.SetAddrTxIndex(keyId2, height, 2, txid(height, 2));
+    }
+    blockCache1.Flush();
+    for (uint32_t height : {201, 70000}) {
+        blockCache2.SetAddrTxIndex(keyId1, height, 0, txid(height, 0));
+        blockCache2.SetAddrTxIndex(keyId1, height, 3, txid(height, 3));
+    }
+
+    vector<uint256> expected = {txid(70000, 3), txid(70000, 0), txid(201, 3), txid(201, 0),
+                                txid(200, 1), txid(5, 1), txid(1, 1)};
+    vector<uint256> txids;
+    AddrTxIndexCache::KeyType lastKey;
+    bool hasMore = true;
+    while (hasMore) {  // paged by 3, from the newest to the oldest
+        auto pGetter = blockCache2.CreateAddrTxGetter();
+        BOOST_CHECK(pGetter->Execute(keyId1, 3, lastKey));
+        for (const auto &item : pGetter->txs) {
+            BOOST_CHECK(std::get<0>(item.first) == keyId1);
+            BOOST_CHECK(txid(ADDR_TX_INDEX::GetHeight(item.first), ADDR_TX_INDEX::GetIndex(item.first)) == item.second);
+            txids.push_back(item.second);
+        }
+        hasMore = pGetter->has_more;
+        lastKey = pGetter->last_key;
+    }
+    BOOST_CHECK(txids == expected);
+
+    auto pGetter = blockCache2.CreateAddrTxGetter();
+    BOOST_CHECK(pGetter->Execute(keyId2, 0, AddrTxIndexCache::KeyType()));
+    BOOST_CHECK_EQUAL(pGetter->txs.size(), 3);
+    BOOST_CHECK(!pGetter->has_more);
+
+    BOOST_CHECK_EQUAL(blockCache2.GetAddrIndexCatchUpHeight(), 0);
+    blockCache2.SetAddrIndexCatchUpHeight(100);
+    BOOST_CHECK_EQUAL(blockCache2.GetAddrIndexCatchUpHeight(), 100);
+    blockCache2.SetAddrIndexCatchUpHeight(0);
+    blockCache2.Flush();
+    BOOST_CHECK_EQUAL(blockCache1.GetAddrIndexCatchUpHeight(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(dbcache_savepoint_test)
+{
+    const bool isWipe = true;
+    const dbk::PrefixType prefix = dbk::REGID_KEYID;
+    shared_ptr<CDBAccess> pDBAccess = make_shared<CDBAccess>(
+        db_dir, DBNameType::ACCOUNT, false, isWipe);
+
+    auto pDBCache1 = make_shared< CCompositeKVCache<prefix, string, string> >(pDBAccess.get());
+    auto pDBCache2 = make_shared< CCompositeKVCache<prefix, string, string> >(pDBCache1.get());
+    CSimpleKVCache<dbk::SYS_PARAM, string> scalarCache(pDBAccess.get());
+    pDBCache1->SetData("regid-1", "keyid-1");
+    pDBCache1->Flush();
+
+    CCacheJournal journal;
+    pDBCache2->SetJournal(&journal);
+    scalarCache.SetJournal(&journal);
+
+    pDBCache2->SetData("regid-2", "keyid-2"); // no savepoint, not journaled
+    size_t outer = journal.Savepoint();
+    pDBCache2->SetData("regid-1", "keyid-1a");
+    scalarCache.SetData("value-a");
+
+    size_t inner = journal.Savepoint();
+    pDBCache2->EraseData("regid-2");
+    pDBCache2->SetData("regid-3", "keyid-3");
+    scalarCache.SetData("value-b");
+    journal.RollbackTo(inner);
+
+    string value;
+    BOOST_CHECK(pDBCache2->GetData(string("regid-2"), value) && value == "keyid-2");
+    BOOST_CHECK(!pDBCache2->HaveData(string("regid-3")));
+    BOOST_CHECK(scalarCache.GetData(value) && value == "value-a");
+
+    // the released inner changes are rolled back by the outer savepoint
+    journal.Savepoint();
+    pDBCache2->SetData("regid-3", "keyid-3");
+    journal.ReleaseSavepoint();
+    BOOST_CHECK(journal.IsActive());
+    journal.RollbackTo(outer);
+    BOOST_CHECK(!journal.IsActive());
+
+    BOOST_CHECK(pDBCache2->GetData(string("regid-1"), value) && value == "keyid-1");
+    BOOST_CHECK(!pDBCache2->HaveData(string("regid-3")));
+    BOOST_CHECK(!scalarCache.HaveData());
+
+    pDBCache2->Flush();
+    BOOST_CHECK(pDBCache1->GetData(string("regid-1"), value) && value == "keyid-1");
+    BOOST_CHECK(pDBCache1->GetData(string("regid-2"), value) && value == "keyid-2");
+}
+
+BOOST_AUTO_TEST_CASE(dbcache_data_ptr_test)
+{
+    const bool isWipe = true;
+    const dbk::PrefixType prefix = dbk::REGID_KEYID;
+    shared_ptr<CDBAccess> pDBAccess = make_shared<CDBAccess>(
+        db_dir, DBNameType::ACCOUNT, false, isWipe);
+
+    auto pDBCache1 = make_shared< CCompositeKVCache<prefix, string, string> >(pDBAccess.get());
+    auto pDBCache2 = make_shared< CCompositeKVCache<prefix, string, string> >(pDBCache1.get());
+    pDBCache1->SetData("regid-1", "keyid-1");
+    pDBCache1->Flush();
+
+    BOOST_CHECK(pDBCache2->GetDataPtr(string("regid-2")) == nullptr);
+    BOOST_CHECK(pDBCache2->GetDataPtr(string()) == nullptr);
+
+    // read through the base and the db, then kept by the top cache
+    const string *pValue = pDBCache2->GetDataPtr(string("regid-1"));
+    BOOST_REQUIRE(pValue != nullptr);
+    BOOST_CHECK_EQUAL(*pValue, "keyid-1");
+    BOOST_CHECK(pDBCache2->GetDataPtr(string("regid-1")) == pValue);
+
+    pDBCache2->SetData("regid-1", "keyid-1a");
+    BOOST_CHECK_EQUAL(*pDBCache2->GetDataPtr(string("regid-1")), "keyid-1a");
+    BOOST_CHECK_EQUAL(*pDBCache1->GetDataPtr(string("regid-1")), "keyid-1");
+
+    pDBCache2->EraseData("regid-1");
+    BOOST_CHECK(pDBCache2->GetDataPtr(string("regid-1")) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(pricecache_savepoint_test)
+{
+    CoinPricePair bcoinPricePair(SYMB::WICC, SYMB::USD);
+    CPricePointMemCache priceCache;
+    priceCache.SetLatestBlockMedianPricePoints({{bcoinPricePair, 100}});
+
+    CCacheJournal journal;
+    priceCache.SetJournal(&journal);
+
+    size_t outer = journal.Savepoint();
+    priceCache.SetLatestBlockMedianPricePoints({{bcoinPricePair, 200}});
+    size_t inner = journal.Savepoint();
+    priceCache.SetLatestBlockMedianPricePoints({{bcoinPricePair, 300}});
+    journal.RollbackTo(inner);
+    BOOST_CHECK_EQUAL(priceCache.latestBlockMedianPricePoints[bcoinPricePair], 200);
+
+    // the medians of a rolled back median price tx are not seen by the next txs
+    journal.RollbackTo(outer);
+    BOOST_CHECK_EQUAL(priceCache.latestBlockMedianPricePoints.size(), 1);
+    BOOST_CHECK_EQUAL(priceCache.latestBlockMedianPricePoints[bcoinPricePair], 100);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,68 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <string>
+#include <vector>
+#include <openssl/sha.h>
+#include <boost/test/unit_test.hpp>
+#include "crypto/hash.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(hash_tests)
+
+// sha256d by openssl, the implementation Hash() used before the in-tree backends
+static uint256 OpenSSLHash(const string &data) {
+    uint256 hash1;
+    SHA256((const uint8_t *)data.data(), data.size(), (uint8_t *)&hash1);
+    uint256 hash2;
+    SHA256((const uint8_t *)&hash1, sizeof(hash1), (uint8_t *)&hash2);
+    return hash2;
+}
+
+static string RandomData(size_t size, uint32_t seed) {
+    string data(size, '\0');
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = (char)(seed >> 16);
+    }
+    return data;
+}
+
+BOOST_AUTO_TEST_CASE(hash_vectors) {
+    BOOST_CHECK(Hash_InitSanityCheck());
+
+    string empty;
+    BOOST_CHECK_EQUAL(Hash(empty.begin(), empty.end()).GetHex(),
+                      "56944c5d3f98413ef45cf54545538103cc9f298e0575820ad3591376e2e0f65d");
+
+    string data = "abcdbcdecdefdefgefghfghighijhijkijkljklmjklmnklmnolmnopmnopnopq";
+    BOOST_CHECK_EQUAL(Hash(data.begin(), data.end()).GetHex(),
+                      "c5d6efb1aa309788d9051ed2bc3f47f97f52dbd10779ca275da9d7bbc360367f");
+
+    string million(1000000, 'a');
+    BOOST_CHECK_EQUAL(Hash(million.begin(), million.end()).GetHex(),
+                      "88661512a78701a68778d78b5e70e50748fe1a9f74b206521b3e56779418d180");
+}
+
+// every length over the block boundaries, written in one, two and three parts and through the writer
+BOOST_AUTO_TEST_CASE(hash_same_as_openssl) {
+    for (size_t size = 0; size < 300; size++) {
+        string data      = RandomData(size, size);
+        uint256 expected = OpenSSLHash(data);
+        size_t a = size / 3, b = size * 2 / 3;
+
+        BOOST_CHECK(Hash(data.begin(), data.end()) == expected);
+        BOOST_CHECK(Hash(data.begin(), data.begin() + a, data.begin() + a, data.end()) == expected);
+        BOOST_CHECK(Hash(data.begin(), data.begin() + a, data.begin() + a, data.begin() + b, data.begin() + b,
+                         data.end()) == expected);
+
+        CHashWriter ss(SER_GETHASH, 0);
+        for (size_t i = 0; i < size; i += 7)
+            ss.write(data.data() + i, min<size_t>(7, size - i));
+        BOOST_CHECK(ss.GetHash() == expected);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <memory>
+#include <set>
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include "vm/luavm/lua/lua.hpp"
+#include "vm/luavm/luastatepool.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(luastatepool_tests)
+
+// allocates strings and tables of the sizes given by the arguments, lots of garbage for the GC
+static const string SCRIPT =
+    "local t = {}\n"
+    "for i = 1, 300 * contract[1] do t[#t + 1] = 'k' .. (i % 97) .. contract[2] end\n"
+    "local m = {}\n"
+    "for i = 1, #contract do m[string.rep('x', contract[i] % 7 + 1)] = {i, tostring(i)} end\n"
+    "result = #table.concat(t, ',') + #t\n";
+
+static bool OpenLibs(lua_State *L) {
+    static const luaL_Reg libs[] = {{"base", luaopen_base}, {LUA_TABLIBNAME, luaopen_table},
+                                    {LUA_MATHLIBNAME, luaopen_math}, {LUA_STRLIBNAME, luaopen_string},
+                                    {NULL, NULL}};
+    for (const luaL_Reg *lib = libs; lib->func; lib++) {
+        luaL_requiref(L, lib->name, lib->func, 1);
+        lua_pop(L, 1);
+    }
+    return true;
+}
+
+static void PushArguments(lua_State *L, const string &arguments) {
+    lua_newtable(L);
+    for (size_t i = 0; i < arguments.size(); i++) {
+        lua_pushinteger(L, (uint8_t)arguments[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+    lua_setglobal(L, "contract");
+}
+
+static void SetArguments(lua_State *L, const string &arguments) {
+    lua_getglobal(L, "contract");
+    for (size_t i = 0; i < arguments.size(); i++) {
+        lua_pushinteger(L, (uint8_t)arguments[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+    lua_pop(L, 1);
+}
+
+static pair<uint64_t, int64_t> Execute(lua_State *L) {
+    BOOST_CHECK_EQUAL(lua_pcallk(L, 0, 0, 0, 0, NULL, BURN_VER_STEP_V1), LUA_OK);
+    lua_getglobal(L, "result");
+    int64_t result = lua_tointeger(L, -1);
+    lua_pop(L, 1);
+    return make_pair(lua_GetBurnedFuel(L), result);
+}
+
+static pair<uint64_t, int64_t> RunInNewState(const string &arguments, int version) {
+    std::unique_ptr<lua_State, decltype(&lua_close)> spState(luaL_newstate(), &lua_close);
+    lua_State *L = spState.get();
+    lua_StartBurner(L, nullptr, 100000000, version);
+    OpenLibs(L);
+    PushArguments(L, arguments);
+    BOOST_CHECK_EQUAL(luaL_loadbuffer(L, SCRIPT.c_str(), SCRIPT.size(), "line"), LUA_OK);
+    return Execute(L);
+}
+
+static pair<uint64_t, int64_t> RunInPooledState(CLuaStatePool &pool, const string &arguments, int version,
+                                                bool expectLoaded) {
+    auto spPooledState = pool.Acquire("script:" + to_string(arguments.size()));
+    BOOST_REQUIRE(spPooledState != nullptr);
+    BOOST_CHECK_EQUAL(spPooledState->IsLoaded(), expectLoaded);
+
+    lua_State *L = spPooledState->GetState();
+    if (spPooledState->IsLoaded()) {
+        SetArguments(L, arguments);
+    } else {
+        PushArguments(L, arguments);
+        BOOST_CHECK_EQUAL(luaL_loadbuffer(L, SCRIPT.c_str(), SCRIPT.size(), "line"), LUA_OK);
+        spPooledState->SaveSnapshot();
+    }
+    BOOST_REQUIRE(lua_RestartBurner(L, nullptr, 100000000, version));
+    return Execute(L);
+}
+
+BOOST_AUTO_TEST_CASE(luastatepool_fuel_test)
+{
+    CLuaStatePool pool(OpenLibs, 1);
+    const string arguments[] = {string("\x03\x41\x07\x10", 4), string("\x05\x42\x01\x02", 4), string("\x01\x43", 2)};
+
+    set<size_t> loadedSizes;
+    for (int version : {BURN_VER_R1, BURN_VER_R2}) {
+        for (uint32_t round = 0; round < 3; round++) {
+            for (const auto &args : arguments) {
+                bool expectLoaded = !loadedSizes.insert(args.size()).second;
+                auto expected     = RunInNewState(args, version);
+                auto actual       = RunInPooledState(pool, args, version, expectLoaded);
+                BOOST_CHECK_EQUAL(actual.first, expected.first);
+                BOOST_CHECK_EQUAL(actual.second, expected.second);
+            }
+        }
+    }
+
+    // all the states are busy
+    auto spPooledState = pool.Acquire("busy");
+    BOOST_CHECK(spPooledState != nullptr && pool.Acquire("busy") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(luastatepool_restart_burner_test)
+{
+    std::unique_ptr<lua_State, decltype(&lua_close)> spState(luaL_newstate(), &lua_close);
+    lua_State *L = spState.get();
+    // not started
+    BOOST_CHECK(!lua_RestartBurner(L, nullptr, 100000000, BURN_VER_R2));
+
+    // not started with the newest version
+    lua_StartBurner(L, nullptr, 100000000, BURN_VER_R1);
+    BOOST_CHECK(!lua_RestartBurner(L, nullptr, 100000000, BURN_VER_R2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
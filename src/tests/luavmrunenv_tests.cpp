@@ -0,0 +1,134 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include "config/configuration.h"
+#include "entities/account.h"
+#include "entities/contract.h"
+#include "persistence/cachewrapper.h"
+#include "persistence/contractdb.h"
+#include "persistence/dbaccess.h"
+#include "tx/contracttx.h"
+#include "vm/luavm/luavmrunenv.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(luavmrunenv_tests)
+
+static const CRegID CONTRACT_REGID(100, 1);
+
+// runs a lua contract on the contract data of an in memory db
+struct CLuaDataTestEnv {
+    CDBAccess dbAccess;
+    CContractDBCache baseCache;
+    CCacheWrapper cw;
+
+    CLuaDataTestEnv()
+        : dbAccess("/tmp/coind_unit_test/luavmrunenv_tests", DBNameType::CONTRACT, true, true),
+          baseCache(&dbAccess) {
+        cw.contractCache.SetBaseViewPtr(&baseCache);
+    }
+
+    // nullptr if the contract runs ok, else the error
+    std::shared_ptr<string> Execute(const string &code, uint32_t height) {
+        CUniversalContract contract(code, "");
+        CAccount userAccount, appAccount;
+        userAccount.regid = CRegID(100, 2);
+        appAccount.regid  = CONTRACT_REGID;
+        CLuaContractInvokeTx tx;
+        string arguments("\x01", 1);
+
+        CLuaVMContext context;
+        context.p_cw              = &cw;
+        context.height            = height;
+        context.p_base_tx         = &tx;
+        context.fuel_limit        = 10000000;
+        context.transfer_symbol   = SYMB::WICC;
+        context.p_tx_user_account = &userAccount;
+        context.p_app_account     = &appAccount;
+        context.p_contract        = &contract;
+        context.p_arguments       = &arguments;
+
+        CLuaVMRunEnv runEnv;
+        uint64_t runStep = 0;
+        return runEnv.ExecuteContract(&context, runStep);
+    }
+
+    bool GetData(const string &key, string &value) {
+        return cw.contractCache.GetContractData(CONTRACT_REGID, key, value);
+    }
+};
+
+static const string ITEM_FUNC =
+    "mylib = require 'mylib'\n"
+    "local function item(key, bytes) return {key = key, length = #bytes, value = bytes} end\n";
+
+BOOST_AUTO_TEST_CASE(contract_data_cache_test)
+{
+    CLuaDataTestEnv env;
+    BOOST_REQUIRE(env.cw.contractCache.SetContractData(CONTRACT_REGID, "old", string("\x09", 1)));
+
+    // the reads after the writes and the erases of the same execution see them
+    const string code = ITEM_FUNC +
+        "assert(mylib.ReadData('absent') == nil)\n"
+        "assert(mylib.ReadData('absent') == nil)\n"
+        "assert(mylib.ReadData('old') == 9)\n"
+        "assert(mylib.WriteData(item('absent', {1, 2, 3})))\n"
+        "local a, b, c = mylib.ReadData('absent')\n"
+        "assert(a == 1 and b == 2 and c == 3)\n"
+        "assert(mylib.DeleteData('old'))\n"
+        "assert(mylib.ReadData('old') == nil)\n"
+        "assert(mylib.WriteData(item('old', {8})))\n"
+        "assert(mylib.ReadData('old') == 8)\n";
+    auto spError = env.Execute(code, SysCfg().GetVer3ForkHeight());
+    BOOST_CHECK_MESSAGE(spError == nullptr, (spError ? *spError : string()));
+
+    string value;
+    BOOST_CHECK(env.GetData("absent", value) && value == string("\x01\x02\x03", 3));
+    BOOST_CHECK(env.GetData("old", value) && value == string("\x08", 1));
+}
+
+BOOST_AUTO_TEST_CASE(multi_data_test)
+{
+    CLuaDataTestEnv env;
+    BOOST_REQUIRE(env.cw.contractCache.SetContractData(CONTRACT_REGID, "erased", string("\x07", 1)));
+
+    const string code = ITEM_FUNC +
+        "assert(mylib.WriteMultiData({item('k1', {4}), item('k2', {5, 6})}))\n"
+        "assert(mylib.DeleteData('erased'))\n"
+        "local values = mylib.ReadMultiData({'k1', 'absent', 'k2', 'erased'})\n"
+        "assert(values[1][1] == 4 and #values[1] == 1)\n"
+        "assert(values[2] == false)\n"
+        "assert(values[3][1] == 5 and values[3][2] == 6 and #values[3] == 2)\n"
+        "assert(values[4] == false)\n";
+    auto spError = env.Execute(code, SysCfg().GetVer3ForkHeight());
+    BOOST_CHECK_MESSAGE(spError == nullptr, (spError ? *spError : string()));
+
+    string value;
+    BOOST_CHECK(env.GetData("k1", value) && value == string("\x04", 1));
+    BOOST_CHECK(env.GetData("k2", value) && value == string("\x05\x06", 2));
+    BOOST_CHECK(!env.GetData("erased", value));
+}
+
+BOOST_AUTO_TEST_CASE(multi_data_before_fork_test)
+{
+    // an error of the script, as on the nodes which do not know the functions, and nothing is written
+    CLuaDataTestEnv env;
+    uint32_t height = SysCfg().GetVer3ForkHeight() - 1;
+
+    auto spError = env.Execute(ITEM_FUNC + "mylib.WriteMultiData({item('k1', {4})})\n", height);
+    BOOST_REQUIRE(spError != nullptr);
+    BOOST_CHECK(spError->find("WriteMultiData is unsupported") != string::npos);
+    string value;
+    BOOST_CHECK(!env.GetData("k1", value));
+
+    spError = env.Execute(ITEM_FUNC + "mylib.ReadMultiData({'k1'})\n", height);
+    BOOST_REQUIRE(spError != nullptr);
+    BOOST_CHECK(spError->find("ReadMultiData is unsupported") != string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,93 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <memory>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "chain/merkletree.h"
+#include "crypto/hash.h"
+#include "persistence/block.h"
+#include "tx/cointransfertx.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(merkle_tests)
+
+static vector<uint256> RandomLeaves(size_t size, uint32_t seed) {
+    vector<uint256> leaves(size);
+    for (auto &leaf : leaves) {
+        for (auto it = leaf.begin(); it != leaf.end(); it++) {
+            seed = seed * 1103515245 + 12345;
+            *it  = (unsigned char)(seed >> 16);
+        }
+    }
+    return leaves;
+}
+
+// the tree as built before the levels were batched, one pair at a time
+static vector<uint256> PairwiseMerkleTree(const vector<uint256> &leaves) {
+    vector<uint256> tree(leaves);
+    int32_t j = 0;
+    for (int32_t nSize = leaves.size(); nSize > 1; nSize = (nSize + 1) / 2) {
+        for (int32_t i = 0; i < nSize; i += 2) {
+            int32_t i2 = min(i + 1, nSize - 1);
+            tree.push_back(Hash(BEGIN(tree[j + i]), END(tree[j + i]), BEGIN(tree[j + i2]), END(tree[j + i2])));
+        }
+        j += nSize;
+    }
+    return tree;
+}
+
+// all the shapes of the levels, the odd ones and the ones shorter than a batch of the 8-way kernel
+BOOST_AUTO_TEST_CASE(merkle_tree_same_as_pairwise) {
+    for (size_t size = 0; size <= 70; size++) {
+        vector<uint256> tree = RandomLeaves(size, size);
+        vector<uint256> expected = PairwiseMerkleTree(tree);
+
+        uint256 root = CBlock::ComputeMerkleTree(tree);
+        BOOST_CHECK(tree == expected);
+        BOOST_CHECK(root == (expected.empty() ? uint256() : expected.back()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(merkle_block_branches) {
+    CBlock block;
+    vector<uint256> txids;
+    for (uint32_t i = 0; i < 13; i++) {
+        auto spTx = make_shared<CBaseCoinTransferTx>(CUserID(CRegID(1, i + 1)), CUserID(CRegID(2, i + 1)), 100,
+                                                     COIN + i, COIN / 10, "");
+        block.vptx.push_back(spTx);
+        txids.push_back(spTx->GetHash());
+    }
+
+    uint256 root = block.BuildMerkleTree();
+    BOOST_CHECK(root == PairwiseMerkleTree(txids).back());
+    for (int32_t i = 0; i < (int32_t)txids.size(); i++) {
+        BOOST_CHECK(block.GetTxid(i) == txids[i]);
+        BOOST_CHECK(CBlock::CheckMerkleBranch(txids[i], block.GetMerkleBranch(i), i) == root);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(partial_merkle_tree) {
+    for (size_t size : {1, 2, 7, 64, 333}) {
+        vector<uint256> txids = RandomLeaves(size, size);
+        uint256 root = PairwiseMerkleTree(txids).back();
+
+        for (size_t step : {1, 3, 50}) {
+            vector<bool> vMatch(size, false);
+            vector<uint256> expected;
+            for (size_t i = 0; i < size; i += step) {
+                vMatch[i] = true;
+                expected.push_back(txids[i]);
+            }
+
+            CPartialMerkleTree tree(txids, vMatch);
+            vector<uint256> matched;
+            BOOST_CHECK(tree.ExtractMatches(matched) == root);
+            BOOST_CHECK(matched == expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
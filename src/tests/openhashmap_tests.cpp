@@ -0,0 +1,80 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <string.h>
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include "commons/openhashmap.h"
+#include "persistence/dbaccess.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(openhashmap_tests)
+
+static uint256 MakeTxid(uint64_t seed) {
+    // cheap deterministic pseudo random bytes, txids and keyids are uniformly distributed
+    uint256 txid;
+    uint64_t x = seed * 0x9e3779b97f4a7c15ULL + 1;
+    for (uint8_t *p = txid.begin(); p < txid.end(); p += sizeof(x)) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        memcpy(p, &x, sizeof(x));
+    }
+    return txid;
+}
+
+BOOST_AUTO_TEST_CASE(openhashmap_basic_test)
+{
+    openhashmap<string, int32_t, db_util::CKeyHasher> mapData;
+    BOOST_CHECK(mapData.empty());
+    BOOST_CHECK(mapData.find("a") == mapData.end());
+
+    for (int32_t i = 0; i < 1000; i++) {
+        auto ret = mapData.emplace(to_string(i), i);
+        BOOST_CHECK(ret.second && ret.first->second == i);
+    }
+    BOOST_CHECK(!mapData.emplace("10", 0).second);
+    BOOST_CHECK_EQUAL(mapData.size(), 1000U);
+
+    mapData["10"] = -10;
+    BOOST_CHECK_EQUAL(mapData.find("10")->second, -10);
+
+    // erase the odd ones, the even ones must still be reachable after backward shifting
+    for (int32_t i = 1; i < 1000; i += 2)
+        BOOST_CHECK_EQUAL(mapData.erase(to_string(i)), 1U);
+    BOOST_CHECK_EQUAL(mapData.erase("1"), 0U);
+    BOOST_CHECK_EQUAL(mapData.size(), 500U);
+    for (int32_t i = 0; i < 1000; i++)
+        BOOST_CHECK_EQUAL(mapData.count(to_string(i)), (size_t)(i % 2 == 0));
+
+    size_t iterated = 0;
+    for (const auto &item : mapData) {
+        BOOST_CHECK(item.first == to_string(item.second) || item.second == -10);
+        iterated++;
+    }
+    BOOST_CHECK_EQUAL(iterated, 500U);
+
+    mapData.clear();
+    BOOST_CHECK(mapData.empty() && mapData.begin() == mapData.end());
+}
+
+BOOST_AUTO_TEST_CASE(salted_key_hasher) {
+    db_util::CKeyHasher hasher, hasher2;
+    uint256 txid = MakeTxid(1);
+    uint160 keyId;
+    memcpy(keyId.begin(), txid.begin(), keyId.size());
+
+    // the salt is shared by the hashers of the process
+    BOOST_CHECK_EQUAL(hasher(txid), hasher2(txid));
+    BOOST_CHECK_EQUAL(hasher(keyId), hasher2(keyId));
+    BOOST_CHECK_EQUAL(hasher(string("0-1")), hasher2(string("0-1")));
+
+    // not derived from the key bytes alone
+    uint64_t keyIdPrefix;
+    memcpy(&keyIdPrefix, keyId.begin(), sizeof(keyIdPrefix));
+    BOOST_CHECK(hasher(keyId) != keyIdPrefix);
+    BOOST_CHECK(hasher(txid) != txid.GetCheapHash());
+    BOOST_CHECK(hasher(string("0-1")) != std::hash<string>()("0-1"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
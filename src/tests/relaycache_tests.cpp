@@ -0,0 +1,94 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <boost/test/unit_test.hpp>
+#include "commons/arith_uint256.h"
+#include "commons/bloom.h"
+#include "commons/util/util.h"
+#include "config/version.h"
+#include "p2p/relaycache.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(relaycache_tests)
+
+static CDataStream MakeData(uint32_t n) {
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << n;
+    return ss;
+}
+
+BOOST_AUTO_TEST_CASE(insert_find) {
+    CRelayCache cache(10, 60);
+    uint256 txid = ArithToUint256(arith_uint256(1));
+    BOOST_CHECK(cache.Find(txid) == nullptr);
+
+    cache.Insert(txid, MakeData(1));
+    cache.Insert(txid, MakeData(2));  // the first serialization is kept
+    auto spData = cache.Find(txid);
+    BOOST_REQUIRE(spData != nullptr);
+    BOOST_CHECK(spData->str() == MakeData(1).str());
+    BOOST_CHECK_EQUAL(cache.Size(), 1);
+
+    cache.Clear();
+    BOOST_CHECK(cache.Find(txid) == nullptr);
+    BOOST_CHECK(spData->str() == MakeData(1).str());  // a found entry outlives the cache
+}
+
+BOOST_AUTO_TEST_CASE(bounded_size) {
+    CRelayCache cache(10, 60);
+    for (uint32_t i = 0; i < 25; i++)
+        cache.Insert(ArithToUint256(arith_uint256(i)), MakeData(i));
+
+    BOOST_CHECK_EQUAL(cache.Size(), 10);
+    BOOST_CHECK(cache.Find(ArithToUint256(arith_uint256(14))) == nullptr);  // the oldest are dropped
+    for (uint32_t i = 15; i < 25; i++)
+        BOOST_CHECK(cache.Find(ArithToUint256(arith_uint256(i))) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(expiry) {
+    int64_t now = GetTime();
+    SetMockTime(now);
+    CRelayCache cache(10, 60);
+    cache.Insert(ArithToUint256(arith_uint256(1)), MakeData(1));
+    SetMockTime(now + 30);
+    cache.Insert(ArithToUint256(arith_uint256(2)), MakeData(2));
+
+    SetMockTime(now + 61);
+    BOOST_CHECK(cache.Find(ArithToUint256(arith_uint256(1))) == nullptr);
+    BOOST_CHECK(cache.Find(ArithToUint256(arith_uint256(2))) != nullptr);
+    BOOST_CHECK_EQUAL(cache.Size(), 2);  // dropped by the next insert
+
+    cache.Insert(ArithToUint256(arith_uint256(3)), MakeData(3));
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+    SetMockTime(0);
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom) {
+    CRollingBloomFilter filter(100, 0.01);
+    for (uint32_t i = 0; i < 100; i++) {
+        filter.insert(ArithToUint256(arith_uint256(i)));
+        BOOST_CHECK(filter.contains(ArithToUint256(arith_uint256(i))));
+    }
+    // the last 100 are always kept
+    for (uint32_t i = 100; i < 400; i++) {
+        filter.insert(ArithToUint256(arith_uint256(i)));
+        for (uint32_t j = i - 99; j <= i; j += 11)
+            BOOST_CHECK(filter.contains(ArithToUint256(arith_uint256(j))));
+    }
+
+    uint32_t falsePositives = 0;
+    for (uint32_t i = 0; i < 200; i++)
+        falsePositives += filter.contains(ArithToUint256(arith_uint256(i)));
+    BOOST_CHECK(falsePositives < 20);
+
+    filter.reset();
+    falsePositives = 0;
+    for (uint32_t i = 300; i < 400; i++)
+        falsePositives += filter.contains(ArithToUint256(arith_uint256(i)));
+    BOOST_CHECK_EQUAL(falsePositives, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
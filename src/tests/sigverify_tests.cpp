@@ -0,0 +1,95 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "entities/key.h"
+#include "main.h"
+
+using namespace std;
+
+struct CSigVerifySetup {
+    ECCVerifyHandle verifyHandle;
+
+    CSigVerifySetup() { ECC_Start(); }
+    ~CSigVerifySetup() {
+        ECC_Stop();
+        SysCfg().SetParSigVerifyThreads(1);
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(sigverify_tests, CSigVerifySetup)
+
+static uint256 MessageHash(uint32_t seed, uint32_t i) {
+    vector<uint32_t> data = {seed, i};
+    return Hash(data.begin(), data.end());
+}
+
+// a few signers signing many messages, as the price feeders and the dex operators do
+static vector<CSignatureCheck> SignMessages(uint32_t count, uint32_t seed) {
+    vector<CKey> keys(8);
+    for (auto &key : keys)
+        key.MakeNewKey(true);
+
+    vector<CSignatureCheck> checks;
+    for (uint32_t i = 0; i < count; i++) {
+        const CKey &key = keys[i % keys.size()];
+        CSignatureCheck check;
+        check.sigHash = MessageHash(seed, i);
+        check.pubKey  = key.GetPubKey();
+        BOOST_CHECK(key.Sign(check.sigHash, check.signature));
+        checks.push_back(check);
+    }
+    return checks;
+}
+
+BOOST_AUTO_TEST_CASE(parsed_pubkey) {
+    CKey key;
+    key.MakeNewKey(true);
+    CPubKey pubKey  = key.GetPubKey();
+    uint256 sigHash = MessageHash(0, 0);
+    vector<uint8_t> signature;
+    BOOST_CHECK(key.Sign(sigHash, signature));
+
+    secp256k1_pubkey parsed;
+    for (int32_t i = 0; i < 2; i++) {  // parsed, then cached
+        BOOST_CHECK(pubKey.Parse(parsed));
+        BOOST_CHECK(CPubKey::Verify(parsed, sigHash, signature));
+        BOOST_CHECK(!CPubKey::Verify(parsed, MessageHash(0, 1), signature));
+        BOOST_CHECK(pubKey.Verify(sigHash, signature));
+    }
+
+    BOOST_CHECK(!CPubKey().Parse(parsed));
+}
+
+BOOST_AUTO_TEST_CASE(batch_results) {
+    for (uint32_t threads : {1, 4}) {
+        SysCfg().SetParSigVerifyThreads(threads);
+
+        vector<CSignatureCheck> checks = SignMessages(100, threads);
+        checks[3].sigHash = MessageHash(threads, 4);         // signed another message
+        checks[50].pubKey = checks[51].pubKey;              // signed by another key
+        checks[97].signature.back() ^= 1;                   // damaged
+        checks[98].pubKey = CPubKey();                      // no key
+
+        vector<bool> valid;
+        BOOST_CHECK(!VerifySignatures(checks, valid));
+        BOOST_CHECK_EQUAL(valid.size(), checks.size());
+        for (uint32_t i = 0; i < checks.size(); i++) {
+            bool expected = (i != 3 && i != 50 && i != 97 && i != 98);
+            BOOST_CHECK_EQUAL(valid[i], expected);
+            BOOST_CHECK_EQUAL(VerifySignature(checks[i].sigHash, checks[i].signature, checks[i].pubKey), expected);
+        }
+
+        checks.erase(checks.begin() + 97, checks.begin() + 99);
+        checks.erase(checks.begin() + 50);
+        checks.erase(checks.begin() + 3);
+        BOOST_CHECK(VerifySignatures(checks, valid));  // all of them cached now
+        BOOST_CHECK(VerifySignatures(vector<CSignatureCheck>(), valid));
+        BOOST_CHECK(valid.empty());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
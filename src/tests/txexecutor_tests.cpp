@@ -0,0 +1,178 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "main.h"
+#include "persistence/blockundo.h"
+#include "persistence/cachewrapper.h"
+#include "tx/contracttx.h"
+#include "tx/cointransfertx.h"
+#include "tx/txexecutor.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(txexecutor_tests)
+
+static const int32_t HEIGHT      = 100;
+static const uint32_t FUEL_RATE  = 100;
+static const uint64_t FEES       = 0.1 * COIN;
+static const uint32_t USERS      = 64;
+static const uint32_t CONTRACTS  = 32;
+
+// burns some steps and counts its invocations in the contract data
+static const string SCRIPT =
+    "local n = 0\n"
+    "for i = 1, 2000 do n = n + i % 7 end\n"
+    "local old = mylib.ReadData('count')\n"
+    "local count = 1\n"
+    "if old then count = old + 1 end\n"
+    "mylib.WriteData({key = 'count', length = 1, value = {count % 256}})\n";
+
+static CKeyID UserKeyId(uint32_t i) {
+    vector<unsigned char> id(20, 0);
+    id[0] = (i + 1) & 0xff;
+    id[1] = (i + 1) >> 8;
+    return CKeyID(uint160(id));
+}
+
+static CRegID ContractRegId(uint32_t i) { return CRegID(1, i + 1); }
+
+// the accounts and the contracts of the block, in a wrapper without db
+static void InitState(CCacheWrapper &cw) {
+    for (uint32_t i = 0; i < USERS; i++) {
+        CAccount account(UserKeyId(i));
+        account.OperateBalance(SYMB::WICC, BalanceOpType::ADD_FREE, 1000 * COIN);
+        BOOST_CHECK(cw.accountCache.SetAccount(account.keyid, account));
+    }
+    for (uint32_t i = 0; i < CONTRACTS; i++) {
+        CAccount account(UserKeyId(USERS + i));
+        account.regid = ContractRegId(i);
+        BOOST_CHECK(cw.accountCache.SaveAccount(account));
+        BOOST_CHECK(cw.contractCache.SaveContract(account.regid, CUniversalContract(SCRIPT, "")));
+    }
+}
+
+static shared_ptr<CBaseTx> NewTransfer(uint32_t from, uint32_t to, uint64_t amount) {
+    return make_shared<CBaseCoinTransferTx>(CUserID(UserKeyId(from)), CUserID(UserKeyId(to)), HEIGHT, amount, FEES,
+                                            "");
+}
+
+static shared_ptr<CBaseTx> NewInvoke(uint32_t from, uint32_t contract) {
+    auto spTx = make_shared<CLuaContractInvokeTx>();
+    spTx->txUid        = CUserID(UserKeyId(from));
+    spTx->app_uid      = CUserID(ContractRegId(contract));
+    spTx->valid_height = HEIGHT;
+    spTx->llFees       = FEES;
+    spTx->coin_amount  = 0;
+    return spTx;
+}
+
+struct CBlockRunResult {
+    vector<string> undos;  // serialized tx undos
+    vector<uint64_t> runSteps;
+    vector<uint64_t> balances;
+    vector<string> counts;
+    uint32_t speculated = 0;
+};
+
+static CBlockRunResult ExecuteBlock(CCacheWrapper &root, const vector<shared_ptr<CBaseTx>> &vptx, uint32_t threads) {
+    CBlockRunResult result;
+    CCacheWrapper cw(&root);
+    CBlockUndo blockUndo;
+    CParallelTxExecutor txExecutor(vptx, cw, blockUndo, threads);
+
+    for (uint32_t i = 0; i < vptx.size(); i++) {
+        CValidationState state;
+        CTxExecuteContext context(HEIGHT, i, FUEL_RATE, 0, 0, &cw, &state);
+        BOOST_CHECK_MESSAGE(txExecutor.ExecuteTx(context), strprintf("tx %u: %s", i, state.GetRejectReason()));
+        result.runSteps.push_back(vptx[i]->nRunStep);
+    }
+    result.speculated = txExecutor.GetSpeculatedCount();
+
+    for (const auto &txUndo : blockUndo.vtxundo) {
+        CDataStream ss(SER_DISK, CLIENT_VERSION);
+        ss << txUndo;
+        result.undos.push_back(ss.str());
+    }
+    for (uint32_t i = 0; i < USERS; i++) {
+        CAccount account;
+        BOOST_CHECK(cw.accountCache.GetAccount(UserKeyId(i), account));
+        result.balances.push_back(account.GetToken(SYMB::WICC).free_amount);
+    }
+    for (uint32_t i = 0; i < CONTRACTS; i++) {
+        string count;
+        cw.contractCache.GetContractData(ContractRegId(i), "count", count);
+        result.counts.push_back(count);
+    }
+    return result;
+}
+
+static void CheckSameAsSerial(const vector<shared_ptr<CBaseTx>> &vptx) {
+    CCacheWrapper root;
+    InitState(root);
+
+    CBlockRunResult serial = ExecuteBlock(root, vptx, 1);
+    BOOST_CHECK_EQUAL(serial.speculated, 0U);
+
+    for (uint32_t threads : {2, 4, 8}) {
+        CBlockRunResult parallel = ExecuteBlock(root, vptx, threads);
+        BOOST_CHECK(parallel.undos == serial.undos);
+        BOOST_CHECK(parallel.runSteps == serial.runSteps);
+        BOOST_CHECK(parallel.balances == serial.balances);
+        BOOST_CHECK(parallel.counts == serial.counts);
+        BOOST_CHECK_EQUAL(parallel.speculated, vptx.size());
+    }
+}
+
+// every user either sends to a new account or invokes a contract of its own, once
+BOOST_AUTO_TEST_CASE(independent_txs) {
+    vector<shared_ptr<CBaseTx>> vptx;
+    for (uint32_t i = 0; i < USERS; i += 2) {
+        vptx.push_back(NewTransfer(i, USERS + CONTRACTS + i, COIN));
+        vptx.push_back(NewInvoke(i + 1, i / 2));
+    }
+    CheckSameAsSerial(vptx);
+}
+
+// the same senders, receivers and contracts over and over, most txs are executed again
+BOOST_AUTO_TEST_CASE(conflicting_txs) {
+    vector<shared_ptr<CBaseTx>> vptx;
+    for (uint32_t i = 0; i < USERS; i++) {
+        vptx.push_back(NewTransfer(i % 3, (i + 1) % 3, COIN + i));
+        vptx.push_back(NewInvoke(3 + i % 2, 0));
+    }
+    CheckSameAsSerial(vptx);
+}
+
+// a failing tx fails in the same place, the txs before it are committed as by the serial execution
+BOOST_AUTO_TEST_CASE(failing_tx) {
+    CCacheWrapper root;
+    InitState(root);
+
+    vector<shared_ptr<CBaseTx>> vptx;
+    vptx.push_back(NewTransfer(0, 1, COIN));
+    vptx.push_back(NewTransfer(2, 3, 2000 * COIN));  // insufficient funds
+    vptx.push_back(NewTransfer(4, 5, COIN));
+
+    CCacheWrapper cw(&root);
+    CBlockUndo blockUndo;
+    CParallelTxExecutor txExecutor(vptx, cw, blockUndo, 4);
+    for (uint32_t i = 0; i < 2; i++) {
+        CValidationState state;
+        CTxExecuteContext context(HEIGHT, i, FUEL_RATE, 0, 0, &cw, &state);
+        BOOST_CHECK_EQUAL(txExecutor.ExecuteTx(context), i == 0);
+    }
+    BOOST_CHECK_EQUAL(blockUndo.vtxundo.size(), 1U);
+    BOOST_CHECK_EQUAL(txExecutor.GetReexecutedCount(), 1U);
+
+    CAccount account;
+    BOOST_CHECK(cw.accountCache.GetAccount(UserKeyId(4), account));
+    BOOST_CHECK_EQUAL(account.GetToken(SYMB::WICC).free_amount, 1000 * COIN);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
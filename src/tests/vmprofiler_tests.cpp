@@ -0,0 +1,60 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include "vm/vmprofiler.h"
+#include "commons/json/json_spirit_utils.h"
+
+using namespace std;
+using namespace json_spirit;
+
+BOOST_AUTO_TEST_SUITE(vmprofiler_tests)
+
+static Array GetFuelStacks(const CVmProfiler &profiler) {
+    return find_value(profiler.ToJson(), "fuel_stacks").get_array();
+}
+
+BOOST_AUTO_TEST_CASE(sampled_stacks) {
+    CVmProfiler profiler;
+    profiler.Sample("load", 10);
+    profiler.Sample("main:1", 15);
+    profiler.Sample("main:1;f:3", 45);
+    profiler.Sample("main:1", 50);
+    profiler.Sample("main:1;f:3", 40);  // a refund is no sample
+    profiler.Sample("main:1;f:3", 60);
+    profiler.Sample("", 60);
+
+    Array stacks = GetFuelStacks(profiler);
+    BOOST_CHECK_EQUAL(stacks.size(), 3U);
+    BOOST_CHECK_EQUAL(stacks[0].get_str(), "load 10");
+    BOOST_CHECK_EQUAL(stacks[1].get_str(), "main:1 10");
+    BOOST_CHECK_EQUAL(stacks[2].get_str(), "main:1;f:3 40");
+    BOOST_CHECK_EQUAL(profiler.GetTotalFuel(), 60U);
+    BOOST_CHECK_EQUAL(find_value(profiler.ToJson(), "total_fuel").get_uint64(), 60U);
+}
+
+BOOST_AUTO_TEST_CASE(entered_frames) {
+    CVmProfiler profiler;
+    profiler.Sample("transaction", 100);
+    profiler.EnterFrame("token::transfer", 100);
+    profiler.EnterFrame("@token", 100);
+    profiler.EnterFrame("db_store", 100);
+    profiler.LeaveFrame(300);
+    profiler.EnterFrame("require_recipient", 300);
+    profiler.LeaveFrame(300);
+    profiler.LeaveFrame(300);
+    profiler.EnterFrame("@alice", 300);
+    profiler.LeaveFrame(10300);
+    profiler.LeaveFrame(10300);
+
+    Array stacks = GetFuelStacks(profiler);
+    BOOST_CHECK_EQUAL(stacks.size(), 3U);
+    BOOST_CHECK_EQUAL(stacks[0].get_str(), "token::transfer;@alice 10000");
+    BOOST_CHECK_EQUAL(stacks[1].get_str(), "token::transfer;@token;db_store 200");
+    BOOST_CHECK_EQUAL(stacks[2].get_str(), "transaction 100");
+    BOOST_CHECK_EQUAL(profiler.GetTotalFuel(), 10300U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,42 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include "crypto/hash.h"
+#include "entities/contract.h"
+#include "entities/id.h"
+#include "wasm/wasm_code_cache.hpp"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(wasm_code_cache_tests)
+
+BOOST_AUTO_TEST_CASE(wasm_code_cache_reuse_test)
+{
+    auto &cache = wasm::wasm_code_cache::instance();
+    CRegID regid(100, 1);
+    CUniversalContract contract(VMType::WASM_VM, false, string("\0asm\x01\0\0\0", 8), "memo", "abi-1");
+
+    auto spEntry = cache.get(regid, contract);
+    BOOST_CHECK(spEntry->code == contract.code && spEntry->abi == contract.abi);
+    BOOST_CHECK(spEntry->code_hash == Hash(contract.code.begin(), contract.code.end()));
+    BOOST_CHECK(cache.get(regid, contract) == spEntry);
+
+    // another db view with a different code or abi never gets the stale entry
+    CUniversalContract updated = contract;
+    updated.code.push_back('\x01');
+    auto spUpdated = cache.get(regid, updated);
+    BOOST_CHECK(spUpdated != spEntry && spUpdated->code == updated.code);
+
+    updated = contract;
+    updated.abi = "abi-2";
+    BOOST_CHECK(cache.get(regid, updated)->abi == "abi-2");
+    BOOST_CHECK(cache.get(regid, contract)->code_hash == spEntry->code_hash);
+
+    cache.erase(regid);
+    BOOST_CHECK(cache.get(regid, contract) != spEntry);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
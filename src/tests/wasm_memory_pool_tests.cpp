@@ -0,0 +1,92 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+#include <boost/test/unit_test.hpp>
+#include "wasm/wasm_memory_pool.hpp"
+#include "commons/util/util.h"
+
+using namespace std;
+using eosio::vm::page_size;
+using eosio::vm::wasm_allocator;
+
+BOOST_AUTO_TEST_SUITE(wasm_memory_pool_tests)
+
+static uint64_t GetResidentBytes() {
+    uint64_t size = 0, resident = 0;
+    ifstream statm("/proc/self/statm");
+    statm >> size >> resident;
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+// grow the memory and write the pages, like the start of an action and its stack and heap
+static void RunAction(wasm_allocator *p_alloc, uint32_t initialPages, uint32_t touchedPages) {
+    p_alloc->reset(initialPages);
+    p_alloc->alloc<char>(initialPages);
+    if (touchedPages > initialPages)
+        p_alloc->alloc<char>(touchedPages - initialPages);
+    for (uint32_t i = 0; i < touchedPages; i++)
+        memset(p_alloc->create_pointer<char>(i * page_size), 0x5a, 1024);
+}
+
+static bool IsZero(wasm_allocator *p_alloc, uint32_t pages) {
+    for (uint64_t i = 0; i < pages * page_size; i++) {
+        if (*p_alloc->create_pointer<char>(i) != 0)
+            return false;
+    }
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(wasm_memory_reuse_test)
+{
+    wasm_allocator *p_first = nullptr;
+    {
+        wasm::wasm_memory memory;
+        p_first = memory.get();
+        RunAction(p_first, 2, 16);
+        BOOST_CHECK(memory.is_in_range(p_first->create_pointer<char>(15 * page_size)));
+        BOOST_CHECK(!memory.is_in_range(p_first->create_pointer<char>(16 * page_size)));
+    }
+    BOOST_CHECK(wasm::wasm_memory_pool::instance().idle_size() > 0);
+
+    wasm::wasm_memory memory;
+    BOOST_CHECK(!memory.is_in_range(nullptr));
+    BOOST_CHECK_EQUAL(memory.get(), p_first);
+    BOOST_CHECK_EQUAL(p_first->get_current_page(), 0);
+
+    // the memory grows over the pages of the last action, all of them read as zero
+    p_first->reset(16);
+    p_first->alloc<char>(16);
+    BOOST_CHECK(IsZero(p_first, 16));
+
+    // the same within one memory, the pages freed by a shrink are zero when grown again
+    RunAction(p_first, 16, 16);
+    p_first->free<char>(8);
+    p_first->alloc<char>(8);
+    for (uint32_t i = 8; i < 16; i++)
+        BOOST_CHECK_EQUAL(*p_first->create_pointer<char>(i * page_size), 0);
+}
+
+BOOST_AUTO_TEST_CASE(wasm_memory_rss_test)
+{
+    const uint32_t touched = 256;  // 16mb
+
+    wasm::wasm_memory memory;
+    uint64_t before = GetResidentBytes();
+    RunAction(memory.get(), 2, touched);
+    memset(memory.get()->get_base_ptr<char>(), 0x5a, touched * page_size);
+    uint64_t touchedRss = GetResidentBytes();
+    memory.get()->reset(2);
+    uint64_t resetRss = GetResidentBytes();
+
+    // only the cleared first pages stay resident
+    BOOST_CHECK(touchedRss > before + (touched / 2) * page_size);
+    BOOST_CHECK(resetRss < before + (touched / 8) * page_size);
+    BOOST_TEST_MESSAGE(strprintf("rss: %llu kb, %u pages touched %llu kb, reset %llu kb", before / 1024, touched,
+                                 touchedRss / 1024, resetRss / 1024));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
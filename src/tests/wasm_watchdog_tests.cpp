@@ -0,0 +1,56 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "wasm/wasm_watchdog.hpp"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(wasm_watchdog_tests)
+
+BOOST_AUTO_TEST_CASE(wasm_watchdog_interrupt_test)
+{
+    atomic<bool> interrupted(false);
+    {
+        wasm::wasm_watchdog wd(chrono::milliseconds(20));
+        auto guard = wd.scoped_run([&]() { interrupted = true; });
+        this_thread::sleep_for(chrono::milliseconds(100));
+        BOOST_CHECK(interrupted);
+    }
+
+    interrupted = false;
+    {
+        wasm::wasm_watchdog wd(chrono::milliseconds(100));
+        auto guard = wd.scoped_run([&]() { interrupted = true; });
+    }
+    this_thread::sleep_for(chrono::milliseconds(150));
+    BOOST_CHECK(!interrupted);
+}
+
+BOOST_AUTO_TEST_CASE(wasm_watchdog_concurrent_test)
+{
+    // the deadlines of the executions in several threads are interleaved, only the late ones fire
+    atomic<uint32_t> interrupted(0);
+    vector<thread> threads;
+    for (uint32_t t = 0; t < 8; t++) {
+        threads.emplace_back([&, t]() {
+            for (uint32_t i = 0; i < 20; i++) {
+                bool late = (i + t) % 5 == 0;
+                wasm::wasm_watchdog wd(chrono::milliseconds(late ? 1 : 500));
+                auto guard = wd.scoped_run([&]() { interrupted++; });
+                if (late)
+                    this_thread::sleep_for(chrono::milliseconds(20));
+            }
+        });
+    }
+    for (auto &th : threads)
+        th.join();
+    BOOST_CHECK_EQUAL(interrupted.load(), 8U * 20U / 5U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
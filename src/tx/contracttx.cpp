@@ -250,6 +250,7 @@ bool CLuaContractInvokeTx::ExecuteTx(CTxExecuteContext &context) {
     luaContext.p_app_account     = &desAccount;
     luaContext.p_contract        = &contract;
     luaContext.p_arguments       = &arguments;
+    luaContext.p_profiler        = context.pProfiler;
 
     int64_t llTime = GetTimeMillis();
     auto pExecErr  = vmRunEnv.ExecuteContract(&luaContext, nRunStep);
@@ -544,6 +545,7 @@ bool CUniversalContractInvokeTx::ExecuteTx(CTxExecuteContext &context) {
     luaContext.p_app_account     = &desAccount;
     luaContext.p_contract        = &contract;
     luaContext.p_arguments       = &arguments;
+    luaContext.p_profiler        = context.pProfiler;
 
     int64_t llTime = GetTimeMillis();
     auto pExecErr  = vmRunEnv.ExecuteContract(&luaContext, nRunStep);
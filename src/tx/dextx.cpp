@@ -168,6 +168,18 @@ bool CDEXOrderBaseTx::CheckOrderOperator(CTxExecuteContext &context, const strin
     return true;
 }
 
+void CDEXOrderBaseTx::GetSignatureChecks(CCacheWrapper &cw, vector<CSignatureCheck> &checks) const {
+    CBaseTx::GetSignatureChecks(cw, checks);
+
+    if (mode != OrderOperatorMode::DEFAULT && operator_signature_pair &&
+        !operator_signature_pair.value().signature.empty()) {
+        CAccount operatorAccount;
+        if (cw.accountCache.GetAccount(operator_signature_pair.value().regid, operatorAccount) &&
+            operatorAccount.owner_pubkey.IsValid())
+            checks.emplace_back(GetHash(), operatorAccount.owner_pubkey, operator_signature_pair.value().signature);
+    }
+}
+
 bool CDEXOrderBaseTx::ProcessOrder(CTxExecuteContext &context, CAccount &txAccount, const string &title) {
     // shared_ptr<DexOperatorDetail> pOperatorDetail;
     // if (!GetDexOperator(context, dex_id, pOperatorDetail, ERROR_TITLE(GetTxTypeName()))) return false;
@@ -61,6 +61,8 @@ public:
     bool CheckOrderFeeRate(CTxExecuteContext &context, const string &title);
     bool CheckOrderOperator(CTxExecuteContext &context, const string &title);
 
+    virtual void GetSignatureChecks(CCacheWrapper &cw, vector<CSignatureCheck> &checks) const;
+
     bool ProcessOrder(CTxExecuteContext &context, CAccount &txAccount, const string &title);
     bool FreezeBalance(CTxExecuteContext &context, CAccount &account,
                        const TokenSymbol &tokenSymbol, const uint64_t &amount, const string &title);
@@ -307,4 +307,14 @@ bool CMulsigTx::GetInvolvedKeyIds(CCacheWrapper &cw, set<CKeyID> &keyIds) {
     }
 
     return true;
-}
\ No newline at end of file
+}
+
+void CMulsigTx::GetSignatureChecks(CCacheWrapper &cw, vector<CSignatureCheck> &checks) const {
+    uint256 sighash = ComputeSignatureHash();
+    CAccount account;
+    for (const auto &item : signaturePairs) {
+        if (!item.signature.empty() && cw.accountCache.GetAccount(item.regid, account) &&
+            account.owner_pubkey.IsValid())
+            checks.emplace_back(sighash, account.owner_pubkey, item.signature);
+    }
+}
@@ -137,6 +137,24 @@ bool CBaseTx::GetInvolvedKeyIds(CCacheWrapper &cw, set<CKeyID> &keyIds) {
     return AddInvolvedKeyIds({txUid}, cw, keyIds);
 }
 
+void CBaseTx::GetSignatureChecks(CCacheWrapper &cw, vector<CSignatureCheck> &checks) const {
+    if (signature.empty())
+        return;
+
+    CPubKey pubKey;
+    if (txUid.type() == typeid(CPubKey)) {
+        pubKey = txUid.get<CPubKey>();
+    } else {
+        CAccount account;
+        if (!cw.accountCache.GetAccount(txUid, account))
+            return;
+        pubKey = account.owner_pubkey;
+    }
+
+    if (pubKey.IsValid())
+        checks.emplace_back(ComputeSignatureHash(), pubKey, signature);
+}
+
 bool CBaseTx::AddInvolvedKeyIds(vector<CUserID> uids, CCacheWrapper &cw, set<CKeyID> &keyIds) {
     for (auto uid : uids) {
         CKeyID keyId;
@@ -35,6 +35,7 @@ namespace wasm{
 
 class CCacheWrapper;
 class CValidationState;
+class CVmProfiler;
 
 string GetTxType(const TxType txType);
 bool GetTxMinFee(const TxType nTxType, int height, const TokenSymbol &symbol, uint64_t &feeOut);
@@ -56,6 +57,7 @@ public:
     CCacheWrapper*                pCw;
     CValidationState*             pState;
     wasm::transaction_status_type transaction_status;
+    CVmProfiler*                  pProfiler;  // profiles the contract execution, the dry runs only
 
     CTxExecuteContext()
         : height(0),
@@ -65,7 +67,8 @@ public:
           prev_block_time(0),
           pCw(nullptr),
           pState(nullptr),
-          transaction_status(wasm::transaction_status_type::syncing){}
+          transaction_status(wasm::transaction_status_type::syncing),
+          pProfiler(nullptr){}
 
     CTxExecuteContext(const int32_t heightIn, const int32_t indexIn, const uint32_t fuelRateIn,
                       const uint32_t blockTimeIn, const uint32_t preBlockTimeIn,
@@ -77,7 +80,8 @@ public:
           prev_block_time(preBlockTimeIn),
           pCw(pCwIn),
           pState(pStateIn),
-          transaction_status(trx_status){}
+          transaction_status(trx_status),
+          pProfiler(nullptr){}
 };
 
 class CBaseTx {
@@ -133,6 +137,8 @@ public:
     virtual Object ToJson(const CAccountDBCache &accountCache) const;
 
     virtual bool GetInvolvedKeyIds(CCacheWrapper &cw, set<CKeyID> &keyIds);
+    // the signatures CheckTx will verify, for the batch verification ahead of it, the unknown signers are left out
+    virtual void GetSignatureChecks(CCacheWrapper &cw, vector<CSignatureCheck> &checks) const;
 
     virtual bool CheckTx(CTxExecuteContext &context)   = 0;
     virtual bool ExecuteTx(CTxExecuteContext &context) = 0;
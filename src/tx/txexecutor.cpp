@@ -0,0 +1,121 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "txexecutor.h"
+
+#include "commons/workerpool.h"
+#include "logging.h"
+#include "main.h"
+#include "tx/tx.h"
+
+namespace {
+
+// the blocks are connected under cs_main, one executor runs at a time
+CWorkerPool &GetTxExecWorkerPool(uint32_t workers) {
+    static std::unique_ptr<CWorkerPool> spPool;
+    if (spPool == nullptr || spPool->GetWorkerCount() != workers)
+        spPool.reset(new CWorkerPool(workers, "coin-txexec"));
+    return *spPool;
+}
+
+}  // namespace
+
+CParallelTxExecutor::CTxSpeculation::CTxSpeculation(CCacheWrapper &cw, const uint256 &txid, std::mutex *pBaseMutex)
+    : spCw(std::make_shared<CCacheWrapper>(&cw)), accessSet(pBaseMutex) {
+    txUndo.SetTxID(txid);
+    spCw->SetDbOpLogMap(&txUndo.dbOpLogMap);
+    spCw->SetAccessSet(&accessSet);
+}
+
+CParallelTxExecutor::CParallelTxExecutor(const vector<std::shared_ptr<CBaseTx>> &vptxIn, CCacheWrapper &cwIn,
+                                         CBlockUndo &blockUndoIn, uint32_t threadsIn)
+    : vptx(vptxIn), cw(cwIn), blockUndo(blockUndoIn), threads(threadsIn) {}
+
+bool CParallelTxExecutor::IsSpeculative(const CBaseTx &tx) {
+    switch (tx.nTxType) {
+        case BCOIN_TRANSFER_TX:
+        case UCOIN_TRANSFER_TX:
+        case LCONTRACT_INVOKE_TX:
+        case UCONTRACT_INVOKE_TX:
+            return true;
+        default:
+            // the wasm vm runs one module instance at a time, the others use the mem caches or
+            // scan the db caches by ranges
+            return false;
+    }
+}
+
+bool CParallelTxExecutor::ExecuteTx(CTxExecuteContext &context) {
+    assert(context.pCw == &cw);
+    int32_t index = context.index;
+    CBaseTx &tx   = *vptx[index];
+    if (threads <= 1 || !IsSpeculative(tx))
+        return ExecuteSerially(context);
+
+    if (index < runBegin || index >= runEnd) {
+        int32_t end       = index;
+        int32_t maxRunEnd = index + threads * PAR_TX_EXEC_RUN_PER_THREAD;
+        while (end < (int32_t)vptx.size() && end < maxRunEnd && IsSpeculative(*vptx[end]))
+            ++end;
+
+        if (end - index < 2)
+            return ExecuteSerially(context);
+
+        runBegin = index;
+        runEnd   = end;
+        Speculate(index, context);
+    }
+
+    std::unique_ptr<CTxSpeculation> &spSpec = run[index - runBegin];
+    if (!spSpec->executed || spSpec->accessSet.IsUntracked() || spSpec->accessSet.IsConflict(runWriteKeys)) {
+        // execute it again against the committed state, still in an overlay for the written keys
+        ++reexecutedCount;
+        spSpec.reset(new CTxSpeculation(cw, tx.GetHash(), nullptr));
+
+        CTxExecuteContext txContext = context;
+        txContext.pCw = spSpec->spCw.get();
+        if (!tx.ExecuteTx(txContext))
+            return false;
+    }
+
+    const auto &writeKeys = spSpec->accessSet.GetWriteKeys();
+    runWriteKeys.insert(writeKeys.begin(), writeKeys.end());
+
+    spSpec->spCw->FlushDbCaches();
+    blockUndo.vtxundo.push_back(std::move(spSpec->txUndo));
+    spSpec.reset();
+
+    return true;
+}
+
+void CParallelTxExecutor::Speculate(int32_t begin, const CTxExecuteContext &context) {
+    run.clear();
+    runWriteKeys.clear();
+    for (int32_t i = begin; i < runEnd; i++)
+        run.emplace_back(new CTxSpeculation(cw, vptx[i]->GetHash(), &baseMutex));
+
+    GetTxExecWorkerPool(threads - 1).Run(run.size(), [&](size_t i) {
+        CTxSpeculation &spec = *run[i];
+        CValidationState state;
+        CTxExecuteContext txContext(context.height, begin + i, context.fuel_rate, context.block_time,
+                                    context.prev_block_time, spec.spCw.get(), &state, context.transaction_status);
+        try {
+            spec.executed = vptx[begin + i]->ExecuteTx(txContext);
+        } catch (const std::exception &e) {
+            LogPrint(BCLog::DEBUG, "CParallelTxExecutor::Speculate, txid=%s speculation error: %s\n",
+                     vptx[begin + i]->GetHash().GetHex(), e.what());
+            spec.executed = false;
+        } catch (...) {
+            spec.executed = false;
+        }
+    });
+
+    speculatedCount += run.size();
+}
+
+bool CParallelTxExecutor::ExecuteSerially(CTxExecuteContext &context) {
+    CBaseTx &tx = *vptx[context.index];
+    CTxUndoOpLogger opLogger(cw, tx.GetHash(), blockUndo);
+    return tx.ExecuteTx(context);
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef TX_EXECUTOR_H
+#define TX_EXECUTOR_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "persistence/blockundo.h"
+#include "persistence/cachewrapper.h"
+
+class CBaseTx;
+class CTxExecuteContext;
+
+// speculative txs per thread in one run, the later txs of a long run are more likely to conflict
+static const uint32_t PAR_TX_EXEC_RUN_PER_THREAD = 8;
+
+/**
+ * Optimistic parallel execution of the txs of a block, see -partxexec.
+ *
+ * A run of consecutive speculative txs (transfers and lua contract invocations) is executed on the
+ * worker threads before it is reached, every tx in its own CCacheWrapper overlay of the block wrapper,
+ * all against the state before the run and with the keys read and written recorded. The txs are then
+ * committed in block order: a tx which read and wrote no key written by the earlier txs of the run saw
+ * exactly the state of the serial execution, its overlay is flushed into the block wrapper as it is.
+ * Any other tx is executed again on the committing thread, against the committed state. The block
+ * state, the undo logs, the run steps and the errors are the same as the serial execution's.
+ *
+ * The other txs, the wasm ones included, run serially and end the runs. The block wrapper must not be
+ * in a savepoint, the overlays are flushed into it without journal.
+ */
+class CParallelTxExecutor {
+public:
+    CParallelTxExecutor(const vector<std::shared_ptr<CBaseTx>> &vptxIn, CCacheWrapper &cwIn,
+                        CBlockUndo &blockUndoIn, uint32_t threadsIn);
+
+    // execute the tx at context.index against context.pCw, which is the block wrapper, in block order
+    bool ExecuteTx(CTxExecuteContext &context);
+
+    // whether the tx keeps all of its state in the db caches and reads it by keys only
+    static bool IsSpeculative(const CBaseTx &tx);
+
+    uint32_t GetSpeculatedCount() const { return speculatedCount; }
+    uint32_t GetReexecutedCount() const { return reexecutedCount; }
+
+private:
+    struct CTxSpeculation {
+        std::shared_ptr<CCacheWrapper> spCw;
+        CCacheAccessSet accessSet;
+        CTxUndo txUndo;
+        bool executed = false;
+
+        CTxSpeculation(CCacheWrapper &cw, const uint256 &txid, std::mutex *pBaseMutex);
+    };
+
+    void Speculate(int32_t begin, const CTxExecuteContext &context);
+    bool ExecuteSerially(CTxExecuteContext &context);
+
+    const vector<std::shared_ptr<CBaseTx>> &vptx;
+    CCacheWrapper &cw;
+    CBlockUndo &blockUndo;
+    uint32_t threads;
+
+    std::mutex baseMutex;  // the block wrapper is read by the overlays of all the workers
+    int32_t runBegin = 0;
+    int32_t runEnd   = 0;
+    std::vector<std::unique_ptr<CTxSpeculation>> run;
+    std::unordered_set<std::string> runWriteKeys;  // written by the committed txs of the run
+
+    uint32_t speculatedCount = 0;
+    uint32_t reexecutedCount = 0;
+};
+
+#endif  // TX_EXECUTOR_H
@@ -92,14 +92,14 @@ bool CTxMemPool::CheckTxInMemPool(const uint256 &txid, const CTxMemPoolEntry &me
         return state.Invalid(ERRORMSG("CheckTxInMemPool() : txid: %s has been confirmed", txid.GetHex()), REJECT_INVALID,
                              "tx-duplicate-confirmed");
 
-    auto spCW = std::make_shared<CCacheWrapper>(cw.get());
+    CCacheSavepoint savepoint(*cw);
 
     if (bExecute) {
         CBlockIndex *pTip =  chainActive.Tip();
         uint32_t fuelRate  = GetElementForBurn(pTip);
         uint32_t blockTime = pTip->GetBlockTime();
         uint32_t prevBlockTime = pTip->pprev != nullptr ? pTip->pprev->GetBlockTime() : pTip->GetBlockTime();
-        CTxExecuteContext context(chainActive.Height(), 0, fuelRate, blockTime, prevBlockTime, spCW.get(), &state, wasm::transaction_status_type::validating);
+        CTxExecuteContext context(chainActive.Height(), 0, fuelRate, blockTime, prevBlockTime, cw.get(), &state, wasm::transaction_status_type::validating);
         if (!memPoolEntry.GetTransaction()->ExecuteTx(context)) {
             pCdMan->pLogCache->SetExecuteFail(chainActive.Height(), memPoolEntry.GetTransaction()->GetHash(),
                                               state.GetRejectCode(), state.GetRejectReason());
@@ -107,7 +107,7 @@ bool CTxMemPool::CheckTxInMemPool(const uint256 &txid, const CTxMemPoolEntry &me
         }
     }
 
-    spCW->Flush();
+    savepoint.Release();
 
     return true;
 }
@@ -23,6 +23,7 @@
 #include "wasm/wasm_native_contract_abi.hpp"
 #include "wasm/wasm_native_contract.hpp"
 #include "wasm/wasm_variant_trace.hpp"
+#include "vm/vmprofiler.h"
 
 
 map <UnsignedCharArray, uint64_t> &get_signatures_cache() {
@@ -268,6 +269,7 @@ bool CWasmContractTx::ExecuteTx(CTxExecuteContext &context) {
         auto &database         = *context.pCw;
         auto execute_tx_return = context.pState;
         transaction_status     = context.transaction_status;
+        profiler               = context.pProfiler;
 
         if(transaction_status == wasm::transaction_status_type::syncing ||
            transaction_status == wasm::transaction_status_type::validating ){
@@ -286,6 +288,7 @@ bool CWasmContractTx::ExecuteTx(CTxExecuteContext &context) {
         pseudo_start    = system_clock::now();
         fuel            = GetSerializeSize(SER_DISK, CLIENT_VERSION) * store_fuel_fee_per_byte;
         recipients_size = 0;
+        if (profiler != nullptr) profiler->Sample("transaction", get_profiled_fuel()); //fuel of the tx bytes
         // if(transaction_status == wasm::transaction_status_type::validating)
         // {
         //    WASM_TRACE("bytes:%d", GetSerializeSize(SER_DISK, CLIENT_VERSION))
@@ -319,13 +322,15 @@ bool CWasmContractTx::ExecuteTx(CTxExecuteContext &context) {
         WASM_ASSERT(fee > fuel, fuel_fee_exception, "%s",
                     "CWasmContractTx.ExecuteTx, fee is not enough to afford fuel");
 
-        //save trx trace
-        std::vector<char> trace_bytes = wasm::pack<transaction_trace>(trx_trace);
-        WASM_ASSERT(database.contractCache.SetContractTraces(GetHash(),
-                                                             std::string(trace_bytes.begin(), trace_bytes.end())),
-                    wasm_exception,
-                    "CWasmContractTx::ExecuteTx, set tx trace failed! txid=%s",
-                    GetHash().ToString().c_str())
+        //save trx trace, only the nodes serving gettxtrace need it
+        if (SysCfg().GetWasmTraceLevel() != WASM_TRACE_NONE) {
+            std::vector<char> trace_bytes = wasm::pack<transaction_trace>(trx_trace);
+            WASM_ASSERT(database.contractCache.SetContractTraces(GetHash(),
+                                                                 std::string(trace_bytes.begin(), trace_bytes.end())),
+                        wasm_exception,
+                        "CWasmContractTx::ExecuteTx, set tx trace failed! txid=%s",
+                        GetHash().ToString().c_str())
+        }
 
         //save trx receipts
         trace_to_receipts(trx_trace, receipts);
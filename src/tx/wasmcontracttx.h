@@ -10,6 +10,8 @@
 using std::chrono::microseconds;
 using std::chrono::system_clock;
 
+class CVmProfiler;
+
 class CWasmContractTx : public CBaseTx {
 public:
     vector<wasm::inline_transaction> inline_transactions;
@@ -22,6 +24,10 @@ public:
     std::chrono::microseconds     billed_time              = chrono::microseconds(0);
     std::chrono::milliseconds     max_transaction_duration = std::chrono::milliseconds(wasm::max_wasm_execute_time_infinite);
     wasm::transaction_status_type transaction_status       = wasm::transaction_status_type::syncing;//block in syncing
+    CVmProfiler*                  profiler                 = nullptr;//the dry runs only
+
+    // the fuel of the notices is added to the fuel after the execution
+    uint64_t                  get_profiled_fuel() const { return fuel + recipients_size * wasm::notice_fuel_fee_per_recipient; }
 
     void                      pause_billing_timer();
     void                      resume_billing_timer();
@@ -75,7 +75,7 @@ CAppUserAccount::CAppUserAccount(const string& userId) {
 
 CAppUserAccount::~CAppUserAccount() {}
 
-bool CAppUserAccount::GetAppCFund(CAppCFund& fundOut, const vector<uint8_t>& tag, int32_t height) {
+bool CAppUserAccount::GetAppCFund(CAppCFund& fundOut, const vector<uint8_t>& tag, int32_t height) const {
     auto it = find_if(frozen_funds.begin(), frozen_funds.end(),
                       [&](const CAppCFund& fundIn) { return height == fundIn.GetHeight() && fundIn.GetTag() == tag; });
 
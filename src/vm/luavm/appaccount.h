@@ -137,7 +137,7 @@ public:
     virtual ~CAppUserAccount();
 
     bool Operate(const vector<CAppFundOperate> &operate, vector<CReceipt> &receipts);
-    bool GetAppCFund(CAppCFund &outFound, const vector<uint8_t> &tag, int32_t height);
+    bool GetAppCFund(CAppCFund &outFound, const vector<uint8_t> &tag, int32_t height) const;
     bool AutoMergeFreezeToFree(int32_t height);
 
     json_spirit::Object ToJson() const;
@@ -14,6 +14,7 @@
 #include "tx/cointransfertx.h"
 
 #define LUA_C_BUFFER_SIZE  500  //传递值，最大字节防止栈溢出
+#define LUA_MULTI_DATA_MAX_COUNT 100  // max count of keys in one ReadMultiData/WriteMultiData call
 
 ///////////////////////////////////////////////////////////////////////////////
 // local static functions
@@ -184,6 +185,23 @@ static bool GetDataString(lua_State *L, vector<std::shared_ptr<std::vector<uint8
     }
 }
 
+// get the string on the top of stack, without the intermediate buffers of the vector version
+static bool GetDataString(lua_State *L, string &ret) {
+    if (!lua_isstring(L, -1)) {
+        LogPrint(BCLog::LUAVM, "%s\n", "data is not string");
+        return false;
+    }
+    const char *pStr = lua_tostring(L, -1);
+    size_t len       = pStr ? strlen(pStr) : 0;
+    if (pStr && (len <= LUA_C_BUFFER_SIZE)) {
+        ret.assign(pStr, len);
+        return true;
+    } else {
+        LogPrint(BCLog::LUAVM, "%s\n", "lua_tostring get fail");
+        return false;
+    }
+}
+
 // get bool field value of table
 static bool GetBoolInTable(lua_State *L, const char *pKey, bool &value) {
     // the top of stack must be a table
@@ -1229,27 +1247,18 @@ int32_t ExGetCurRunEnvHeightFunc(lua_State *L) {
     return 0;
 }
 
-static bool GetDataTableWriteDataDB(lua_State *L, vector<std::shared_ptr<std::vector<uint8_t>>> &ret) {
+static bool GetDataTableWriteDataDB(lua_State *L, string &key, string &value) {
     //取写数据库的key value
     if (!lua_istable(L, -1)) {
         LogPrint(BCLog::LUAVM, "GetDataTableWriteDataDB is not table\n");
         return false;
     }
     uint16_t len = 0;
-    vector<uint8_t> vBuf;
     //取key
-    string key = "";
     if (!(getStringInTable(L, (char *)"key", key))) {
         LogPrint(BCLog::LUAVM, "key get fail\n");
         return false;
-    } else {
-        // LogPrint(BCLog::LUAVM, "key:%s\n", key);
-    }
-    vBuf.clear();
-    for (size_t i = 0; i < key.size(); i++) {
-        vBuf.insert(vBuf.end(), key.at(i));
     }
-    ret.insert(ret.end(), std::make_shared<vector<uint8_t>>(vBuf.begin(), vBuf.end()));
 
     //取value的长度
     double doubleValue = 0;
@@ -1261,12 +1270,10 @@ static bool GetDataTableWriteDataDB(lua_State *L, vector<std::shared_ptr<std::ve
         // LogPrint(BCLog::LUAVM, "len =%d\n", len);
     }
     if ((len > 0) && (len <= LUA_C_BUFFER_SIZE)) {
-        if (!getArrayInTable(L, (char *)"value", len, vBuf)) {
+        value.reserve(len);
+        if (!getArrayInTable(L, (char *)"value", len, value)) {
             LogPrint(BCLog::LUAVM, "value is not table\n");
             return false;
-        } else {
-            // LogPrint(BCLog::LUAVM, "value:%s\n", HexStr(vBuf).c_str());
-            ret.insert(ret.end(), std::make_shared<vector<uint8_t>>(vBuf.begin(), vBuf.end()));
         }
         return true;
     } else {
@@ -1275,6 +1282,29 @@ static bool GetDataTableWriteDataDB(lua_State *L, vector<std::shared_ptr<std::ve
     }
 }
 
+// read the contract data of the running contract and burn the fuel of the read
+static bool ReadContractData(lua_State *L, CLuaVMRunEnv &vmRunEnv, const string &key, string &value) {
+    if (!vmRunEnv.GetContractData(key, value)) {
+        lua_BurnStoreUnchanged(L, key.size(), 0, BURN_VER_R2);
+        return false;
+    }
+    lua_BurnStoreGet(L, key.size(), value.size(), BURN_VER_R2);
+    return true;
+}
+
+// write the contract data of the running contract and burn the fuel of the write
+static bool WriteContractData(lua_State *L, CLuaVMRunEnv &vmRunEnv, const string &key, const string &value) {
+    string oldValue;
+    vmRunEnv.GetContractData(key, oldValue);
+    if (!vmRunEnv.SetContractData(key, value)) {
+        LogPrint(BCLog::LUAVM, "WriteContractData SetContractData failed, key:%s!\n", HexStr(key));
+        lua_BurnStoreUnchanged(L, key.size(), value.size(), BURN_VER_R2);
+        return false;
+    }
+    lua_BurnStoreSet(L, key.size(), oldValue.size(), value.size(), BURN_VER_R2);
+    return true;
+}
+
 /**
  *bool WriteDataDB(const void* const key,const uint8_t keylen,const void * const value,const uint16_t valuelen,const uint32_t time)
  * 这个函数式从中间层传了三个个参数过来:
@@ -1282,33 +1312,18 @@ static bool GetDataTableWriteDataDB(lua_State *L, vector<std::shared_ptr<std::ve
  * 2.第二个是value值
  */
 int32_t ExWriteDataDBFunc(lua_State *L) {
-    vector<std::shared_ptr < vector<uint8_t> > > retdata;
-    if (!GetDataTableWriteDataDB(L, retdata) || retdata.size() != 2) {
+    string key, value;
+    if (!GetDataTableWriteDataDB(L, key, value)) {
         return RetFalse("ExWriteDataDBFunc key err1");
     }
 
-    string key((*retdata.at(0)).begin(), (*retdata.at(0)).end());
-    string value((*retdata.at(1)).begin(), (*retdata.at(1)).end());
-
     CLuaVMRunEnv* pVmRunEnv = GetVmRunEnv(L);
     if (nullptr == pVmRunEnv) {
 
         return RetFalse("pVmRunEnv is nullptr");
     }
 
-    const CRegID contractRegId = pVmRunEnv->GetContractRegID();
-    bool flag = true;
-    CContractDBCache* scriptDB = pVmRunEnv->GetScriptDB();
-    string oldValue;
-    // TODO: get old data when set data ??
-    scriptDB->GetContractData(contractRegId, key, oldValue);
-    if (!scriptDB->SetContractData(contractRegId, key, value)) {
-        LogPrint(BCLog::LUAVM, "ExWriteDataDBFunc SetContractData failed, key:%s!\n",HexStr(key));
-        lua_BurnStoreUnchanged(L, key.size(), value.size(), BURN_VER_R2);
-        flag = false;
-    } else {
-        lua_BurnStoreSet(L, key.size(), oldValue.size(), value.size(), BURN_VER_R2);
-    }
+    bool flag = WriteContractData(L, *pVmRunEnv, key, value);
     return RetRstBooleanToLua(L,flag);
 }
 
@@ -1318,29 +1333,23 @@ int32_t ExWriteDataDBFunc(lua_State *L) {
  * 1.第一个是 key值
  */
 int32_t ExDeleteDataDBFunc(lua_State *L) {
-    vector<std::shared_ptr < vector<uint8_t> > > retdata;
-
-    if (!GetDataString(L, retdata) || retdata.size() != 1) {
+    string key;
+    if (!GetDataString(L, key)) {
         LogPrint(BCLog::LUAVM, "ExDeleteDataDBFunc key err1");
         return RetFalse(string(__FUNCTION__) + "para  err !");
     }
-    string key = string((*retdata.at(0)).begin(), (*retdata.at(0)).end());
 
     CLuaVMRunEnv* pVmRunEnv = GetVmRunEnv(L);
     if (nullptr == pVmRunEnv) {
         return RetFalse("pVmRunEnv is nullptr");
     }
 
-    CRegID contractRegId       = pVmRunEnv->GetContractRegID();
-    CContractDBCache *scriptDB = pVmRunEnv->GetScriptDB();
-
     bool flag = true;
     string oldValue;
-    // TODO: get old data when set data ??
-    scriptDB->GetContractData(contractRegId, key, oldValue);
+    pVmRunEnv->GetContractData(key, oldValue);
 
-    if (!scriptDB->EraseContractData(contractRegId, key)) {
-        LogPrint(BCLog::LUAVM, "ExDeleteDataDBFunc EraseContractData railed, key:%s!\n", HexStr(*retdata.at(0)));
+    if (!pVmRunEnv->EraseContractData(key)) {
+        LogPrint(BCLog::LUAVM, "ExDeleteDataDBFunc EraseContractData railed, key:%s!\n", HexStr(key));
         lua_BurnStoreUnchanged(L, key.size(), oldValue.size(), BURN_VER_R2);
         flag = false;
     } else {
@@ -1356,30 +1365,20 @@ int32_t ExDeleteDataDBFunc(lua_State *L) {
  * 1.第一个是 key值
  */
 int32_t ExReadDataDBFunc(lua_State *L) {
-    vector<std::shared_ptr < vector<uint8_t> > > retdata;
-
-    if (!GetDataString(L,retdata) ||retdata.size() != 1) {
+    string key;
+    if (!GetDataString(L, key)) {
         return RetFalse("ExReadDataDBFunc key err1");
     }
 
-    string key((*retdata.at(0)).begin(), (*retdata.at(0)).end());
-
     CLuaVMRunEnv* pVmRunEnv = GetVmRunEnv(L);
     if (nullptr == pVmRunEnv) {
         return RetFalse("pVmRunEnv is nullptr");
     }
 
-    CRegID scriptRegId = pVmRunEnv->GetContractRegID();
-
     string value;
-    CContractDBCache* scriptDB = pVmRunEnv->GetScriptDB();
     int32_t len = 0;
-    if (!scriptDB->GetContractData(scriptRegId, key, value)) {
-        len = 0;
-        lua_BurnStoreUnchanged(L, key.size(), 0, BURN_VER_R2);
-    } else {
-        lua_BurnStoreGet(L, key.size(), value.size(), BURN_VER_R2);
-        len = RetRstToLua(L, vector<uint8_t>(value.begin(), value.end()));
+    if (ReadContractData(L, *pVmRunEnv, key, value)) {
+        len = RetRstToLua(L, value);
     }
     return len;
 }
@@ -1406,25 +1405,20 @@ int32_t ExGetCurTxHash(lua_State *L) {
  * 2.第二个是 value
  */
 int32_t ExModifyDataDBFunc(lua_State *L) {
-    vector<std::shared_ptr < vector<uint8_t> > > retdata;
-    if (!GetDataTableWriteDataDB(L,retdata) ||retdata.size() != 2) {
+    string key, newValue;
+    if (!GetDataTableWriteDataDB(L, key, newValue)) {
         return RetFalse("ExModifyDataDBFunc key err");
     }
 
-    string key((*retdata.at(0)).begin(), (*retdata.at(0)).end());
-    string newValue((*retdata.at(1)).begin(), (*retdata.at(1)).end());
-
     CLuaVMRunEnv* pVmRunEnv = GetVmRunEnv(L);
     if (nullptr == pVmRunEnv) {
         return RetFalse("pVmRunEnv is nullptr");
     }
 
-    CRegID contractRegId = pVmRunEnv->GetContractRegID();
-    CContractDBCache* scriptDB = pVmRunEnv->GetScriptDB();
     string oldValue;
     bool flag = false;
-    if (scriptDB->GetContractData(contractRegId, key, oldValue)) {
-        if (scriptDB->SetContractData(contractRegId, key, newValue)) {
+    if (pVmRunEnv->GetContractData(key, oldValue)) {
+        if (pVmRunEnv->SetContractData(key, newValue)) {
             lua_BurnStoreSet(L, key.size(),  oldValue.size(), newValue.size(), BURN_VER_R2);
             flag = true;
         } else {
@@ -1581,12 +1575,15 @@ int32_t ExGetContractDataFunc(lua_State *L) {
     string value;
 
     int32_t len = 0;
-    if (!scriptDB->GetContractData(contractRegId, key, value)) {
+    if (contractRegId == pVmRunEnv->GetContractRegID()) {
+        if (ReadContractData(L, *pVmRunEnv, key, value))
+            len = RetRstToLua(L, value);
+    } else if (!scriptDB->GetContractData(contractRegId, key, value)) {
         len = 0;
         lua_BurnStoreUnchanged(L, key.size(), 0, BURN_VER_R2);
     } else {
         lua_BurnStoreGet(L, key.size(), value.size(), BURN_VER_R2);
-        len = RetRstToLua(L, vector<uint8_t>(value.begin(), value.end()));
+        len = RetRstToLua(L, value);
     }
     /*
      * 每个函数里的Lua栈是私有的,当把返回值压入Lua栈以后，该栈会自动被清空*/
@@ -1650,7 +1647,6 @@ int32_t ExGetCurTxPayAmountFunc(lua_State *L) {
 }
 
 int32_t ExGetUserAppAccValueFunc(lua_State *L) {
-    vector<std::shared_ptr < vector<uint8_t> > > retdata;
     if (!lua_istable(L, -1)) {
         LogPrint(BCLog::LUAVM, "is not table\n");
         return 0;
@@ -1658,7 +1654,6 @@ int32_t ExGetUserAppAccValueFunc(lua_State *L) {
     double doubleValue = 0;
     uint32_t idlen = 0;
     vector<uint8_t> accountId;
-    memset(&accountId, 0, sizeof(accountId));
     if (!(getNumberInTable(L, "idLen", doubleValue))) {
         LogPrint(BCLog::LUAVM, "get idlen failed\n");
         return 0;
@@ -1679,11 +1674,11 @@ int32_t ExGetUserAppAccValueFunc(lua_State *L) {
     if(nullptr == pVmRunEnv)
         return RetFalse("pVmRunEnv is nullptr");
 
-    shared_ptr<CAppUserAccount> appAccount;
+    shared_ptr<const CAppUserAccount> appAccount;
     uint64_t valueData = 0 ;
     int32_t len = 0;
     LUA_BurnAccount(L, FUEL_ACCOUNT_GET_VALUE, BURN_VER_R2);
-    if (pVmRunEnv->GetAppUserAccount(accountId, appAccount)) {
+    if (pVmRunEnv->ReadAppUserAccount(accountId, appAccount)) {
         valueData = appAccount->GetBcoins();
 
         CDataStream tep(SER_DISK, CLIENT_VERSION);
@@ -1783,11 +1778,11 @@ int32_t ExGetUserAppAccFundWithTagFunc(lua_State *L) {
     CAppFundOperate userfund;
     ss >> userfund;
 
-    shared_ptr<CAppUserAccount> appAccount;
+    shared_ptr<const CAppUserAccount> appAccount;
     CAppCFund fund;
     int32_t len = 0;
     LUA_BurnAccount(L, FUEL_ACCOUNT_GET_FUND_TAG, BURN_VER_R2);
-    if (pVmRunEnv->GetAppUserAccount(userfund.GetAppUserV(), appAccount)) {
+    if (pVmRunEnv->ReadAppUserAccount(userfund.GetAppUserV(), appAccount)) {
         if (!appAccount->GetAppCFund(fund,userfund.GetFundTagV(), userfund.timeoutHeight))
             return RetFalse("GetUserAppAccFundWithTag GetAppCFund fail");
 
@@ -2441,6 +2436,100 @@ int32_t ExGetAccountAssetFunc(lua_State *L) {
     return 1;
 }
 
+int32_t ExReadMultiDataFunc(lua_State *L) {
+    CLuaVMRunEnv* pVmRunEnv = GetVmRunEnv(L);
+    if (nullptr == pVmRunEnv) {
+        LogPrint(BCLog::LUAVM,"[ERROR]%s(), pVmRunEnv is nullptr\n", __FUNCTION__);
+        return 0;
+    }
+    // unknown to the nodes before MAJOR_VER_R3, where calling it is an error of the script
+    if (GetFeatureForkVersion(pVmRunEnv->GetConfirmHeight()) < MAJOR_VER_R3)
+        return luaL_error(L, "ReadMultiData is unsupported before MAJOR_VER_R3");
+
+    if (!lua_istable(L, -1)) {
+        LogPrint(BCLog::LUAVM,"[ERROR]%s(), keys param must be table\n", __FUNCTION__);
+        return 0;
+    }
+    size_t sz = lua_rawlen(L, -1);
+    if (sz == 0 || sz > LUA_MULTI_DATA_MAX_COUNT) {
+        LogPrint(BCLog::LUAVM,"[ERROR]%s(), keys count=%u must be in [1, %d]\n", __FUNCTION__, sz,
+                 LUA_MULTI_DATA_MAX_COUNT);
+        return 0;
+    }
+
+    vector<string> keys(sz);
+    for (size_t i = 0; i < sz; i++) {
+        lua_geti(L, -1, i + 1);
+        bool ok = GetDataString(L, keys[i]);
+        lua_pop(L, 1); // pop the read item
+        if (!ok) {
+            LogPrint(BCLog::LUAVM,"[ERROR]%s(), parse key[%u] failed\n", __FUNCTION__, i);
+            return 0;
+        }
+    }
+
+    if (!lua_checkstack(L, 3)) {
+        LogPrint(BCLog::LUAVM,"[ERROR]%s(), lua stack overflow\n", __FUNCTION__);
+        return 0;
+    }
+    lua_createtable(L, sz, 0);
+    string value;
+    for (size_t i = 0; i < sz; i++) {
+        if (ReadContractData(L, *pVmRunEnv, keys[i], value)) {
+            // truncated like the return of ReadData
+            int32_t len = std::min<int32_t>(value.size(), LUA_C_BUFFER_SIZE);
+            lua_createtable(L, len, 0);
+            for (int32_t j = 0; j < len; j++) {
+                lua_pushinteger(L, (lua_Integer)uint8_t(value[j]));
+                lua_rawseti(L, -2, j + 1);
+            }
+        } else {
+            lua_pushboolean(L, false);
+        }
+        lua_rawseti(L, -2, i + 1);
+    }
+    return 1;
+}
+
+int32_t ExWriteMultiDataFunc(lua_State *L) {
+    CLuaVMRunEnv* pVmRunEnv = GetVmRunEnv(L);
+    if (nullptr == pVmRunEnv) {
+        LogPrint(BCLog::LUAVM,"[ERROR]%s(), pVmRunEnv is nullptr\n", __FUNCTION__);
+        return 0;
+    }
+    // unknown to the nodes before MAJOR_VER_R3, where calling it is an error of the script
+    if (GetFeatureForkVersion(pVmRunEnv->GetConfirmHeight()) < MAJOR_VER_R3)
+        return luaL_error(L, "WriteMultiData is unsupported before MAJOR_VER_R3");
+
+    if (!lua_istable(L, -1)) {
+        LogPrint(BCLog::LUAVM,"[ERROR]%s(), items param must be table\n", __FUNCTION__);
+        return 0;
+    }
+    size_t sz = lua_rawlen(L, -1);
+    if (sz == 0 || sz > LUA_MULTI_DATA_MAX_COUNT) {
+        LogPrint(BCLog::LUAVM,"[ERROR]%s(), items count=%u must be in [1, %d]\n", __FUNCTION__, sz,
+                 LUA_MULTI_DATA_MAX_COUNT);
+        return 0;
+    }
+
+    vector<pair<string, string>> items(sz);
+    for (size_t i = 0; i < sz; i++) {
+        lua_geti(L, -1, i + 1);
+        if (!GetDataTableWriteDataDB(L, items[i].first, items[i].second)) {
+            LogPrint(BCLog::LUAVM,"[ERROR]%s(), parse item[%u] failed\n", __FUNCTION__, i);
+            return 0;
+        }
+        lua_pop(L, 1); // pop the read item
+    }
+
+    bool flag = true;
+    for (const auto &item : items) {
+        if (!WriteContractData(L, *pVmRunEnv, item.first, item.second))
+            flag = false;
+    }
+    return RetRstBooleanToLua(L, flag);
+}
+
 static const luaL_Reg mylib[] = {
     {"Int64Mul",                    ExInt64MulFunc},
     {"Int64Add",                    ExInt64AddFunc},
@@ -2495,6 +2584,11 @@ static const luaL_Reg mylib[] = {
     {"GetCurTxInputAsset",          ExGetCurTxInputAssetFunc},
     {"GetAccountAsset",             ExGetAccountAssetFunc},
 
+///////////////////////////////////////////////////////////////////////////////
+// new function add in MAJOR_VER_R3
+    {"ReadMultiData",               ExReadMultiDataFunc},
+    {"WriteMultiData",              ExWriteMultiDataFunc},
+
     {nullptr, nullptr}
 
 };
@@ -281,4 +281,23 @@ int32_t ExGetCurTxInputAssetFunc(lua_State *L);
  */
 int32_t ExGetAccountAssetFunc(lua_State *L);
 
+/**
+ * ReadMultiData - lua api, since MAJOR_VER_R3
+ * table ReadMultiData(keys)
+ * read the contract data of several keys in one call, each key burns the same fuel as ReadData
+ * @param keys: array of key strings
+ * @return array of the values in the order of keys, a value is the array of its bytes,
+ *         or false if the key does not exist
+ */
+int32_t ExReadMultiDataFunc(lua_State *L);
+
+/**
+ * WriteMultiData - lua api, since MAJOR_VER_R3
+ * boolean WriteMultiData(items)
+ * write the contract data of several keys in one call, each key burns the same fuel as WriteData
+ * @param items: array of the tables of WriteData, {key = (string), length = (number), value = (array)}
+ * @return true if all items are written, nothing is written if any item is invalid
+ */
+int32_t ExWriteMultiDataFunc(lua_State *L);
+
 #endif //VM_LUA_LMYLIB_H
\ No newline at end of file
@@ -156,6 +156,21 @@ LUA_API int lua_StartBurner(lua_State *L, void* pContext, unsigned long long fue
     return 1;
 }
 
+LUA_API int lua_RestartBurner(lua_State *L, void* pContext, unsigned long long fuelLimit, int version) {
+    unsigned long long allocMemSize = L->burnerState.allocMemSize;
+    if (!IsBurnerStarted(L) || L->burnerState.version != BURN_VER_NEWEST || L->burnerState.fuel != 0) {
+        /* the burner must be started with the newest version and burn memory only */
+        return 0;
+    }
+
+    L->burnerState.isStarted = 0;
+    lua_StartBurner(L, pContext, fuelLimit, version);
+    if (BURN_VER_R2 <= version) {
+        L->burnerState.allocMemSize = allocMemSize;
+    }
+    return 1;
+}
+
 lua_burner_state *lua_GetBurnerState(lua_State *L) {
     if (IsBurnerStarted(L)) {
         return &L->burnerState;
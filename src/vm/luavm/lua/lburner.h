@@ -39,6 +39,14 @@ typedef struct lua_burner_state lua_burner_state;
  */
 int lua_StartBurner(lua_State *L, void* pContext, unsigned long long  fuelLimit, int version);
 
+/**
+ * restart the burner of a state restored from a heap snapshot, the burner must have been started
+ * with the newest version before the snapshot and burned memory only. The memory allocated since
+ * then is burned again if the version burns memory, as if the burner started in the same state.
+ * return 0 if the burner was not started so.
+ */
+int lua_RestartBurner(lua_State *L, void* pContext, unsigned long long  fuelLimit, int version);
+
 lua_burner_state* lua_GetBurnerState(lua_State *L);
 
 /**
@@ -0,0 +1,268 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "luastatepool.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "commons/clockcache.h"
+#include "lua/lua.hpp"
+
+// the heap of an arena state, the used part of the arena
+struct CLuaHeapSnapshot {
+    std::string heap;
+};
+
+/**
+ * A lua state living in a private arena. While recording, the objects are bump allocated in the
+ * arena and the freed ones are left alone, so the arena is a complete image of the heap. Once
+ * frozen, the new objects are allocated by malloc and tracked, the freed arena objects are still
+ * left alone, and restoring a snapshot frees the tracked blocks and copies the image back.
+ */
+class CLuaArenaState {
+public:
+    typedef clockcache<std::string, std::shared_ptr<const CLuaHeapSnapshot>> SnapshotCache;
+
+    lua_State *L = nullptr;
+    std::shared_ptr<const CLuaHeapSnapshot> spLibsSnapshot;  // the libs opened
+    SnapshotCache snapshots;
+
+    CLuaArenaState(size_t arenaSize, size_t maxSnapshotSize) : snapshots(maxSnapshotSize), capacity(arenaSize) {
+        base = (char *)malloc(capacity);
+        blocks.prev = blocks.next = &blocks;
+    }
+
+    ~CLuaArenaState() {
+        FreeBlocks();
+        free(base);
+    }
+
+    bool IsValid() const { return base != nullptr; }
+
+    // the objects allocated by malloc while recording are not in the image
+    bool CanSnapshot() const { return !overflowed; }
+
+    std::shared_ptr<const CLuaHeapSnapshot> TakeSnapshot() const {
+        assert(!frozen && !overflowed);
+        auto spSnapshot = std::make_shared<CLuaHeapSnapshot>();
+        spSnapshot->heap.assign(base, top);
+        return spSnapshot;
+    }
+
+    // restore the heap and record the following allocations unless frozen
+    void Restore(const CLuaHeapSnapshot &snapshot, bool freeze) {
+        FreeBlocks();
+        memcpy(base, snapshot.heap.data(), snapshot.heap.size());
+        top        = snapshot.heap.size();
+        frozen     = freeze;
+        overflowed = false;
+    }
+
+    void Freeze() { frozen = true; }
+
+    static void *Alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+        return ((CLuaArenaState *)ud)->Realloc(ptr, osize, nsize);
+    }
+
+private:
+    struct alignas(16) CBlock {
+        CBlock *prev;
+        CBlock *next;
+    };
+    static const size_t ALIGNMENT = 16;
+
+    char *base;
+    size_t capacity;
+    size_t top      = 0;
+    bool frozen     = false;
+    bool overflowed = false;
+    CBlock blocks;  // the tracked blocks allocated by malloc
+
+    bool InArena(void *ptr) const { return (char *)ptr >= base && (char *)ptr < base + capacity; }
+
+    static size_t AlignSize(size_t size) { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+    void *Realloc(void *ptr, size_t osize, size_t nsize) {
+        if (nsize == 0) {
+            if (ptr != nullptr && !InArena(ptr))
+                FreeBlock(ptr);
+            return nullptr;
+        }
+        if (ptr == nullptr)
+            return Allocate(nsize);
+
+        if (!InArena(ptr))
+            return ReallocBlock(ptr, nsize);
+
+        if (nsize <= osize)
+            return ptr;
+        // grow the last object in place
+        if (!frozen && (char *)ptr + AlignSize(osize) == base + top && (char *)ptr + AlignSize(nsize) <= base + capacity) {
+            top = (char *)ptr - base + AlignSize(nsize);
+            return ptr;
+        }
+        void *newPtr = Allocate(nsize);
+        if (newPtr != nullptr)
+            memcpy(newPtr, ptr, osize);
+        return newPtr;
+    }
+
+    void *Allocate(size_t size) {
+        if (!frozen) {
+            if (top + AlignSize(size) <= capacity) {
+                void *ptr = base + top;
+                top += AlignSize(size);
+                return ptr;
+            }
+            overflowed = true;
+        }
+        return ReallocBlock(nullptr, size);
+    }
+
+    void *ReallocBlock(void *ptr, size_t size) {
+        CBlock *pOld   = ptr == nullptr ? nullptr : (CBlock *)ptr - 1;
+        CBlock *pBlock = (CBlock *)realloc(pOld, sizeof(CBlock) + size);
+        if (pBlock == nullptr)
+            return nullptr;
+
+        if (pOld == nullptr) {
+            pBlock->prev = &blocks;
+            pBlock->next = blocks.next;
+        }
+        pBlock->prev->next = pBlock;
+        pBlock->next->prev = pBlock;
+        return pBlock + 1;
+    }
+
+    void FreeBlock(void *ptr) {
+        CBlock *pBlock     = (CBlock *)ptr - 1;
+        pBlock->prev->next = pBlock->next;
+        pBlock->next->prev = pBlock->prev;
+        free(pBlock);
+    }
+
+    void FreeBlocks() {
+        while (blocks.next != &blocks)
+            FreeBlock(blocks.next + 1);
+    }
+};
+
+static int LuaPanic(lua_State *L) {
+    lua_writestringerror("PANIC: unprotected error in call to Lua API (%s)\n", lua_tostring(L, -1));
+    return 0;  // return to Lua to abort
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class CLuaPooledState
+
+CLuaPooledState::~CLuaPooledState() { pPool->Release(pArenaState); }
+
+lua_State *CLuaPooledState::GetState() const { return pArenaState->L; }
+
+void CLuaPooledState::SaveSnapshot() {
+    if (loaded)
+        return;
+
+    if (pArenaState->CanSnapshot() && pArenaState->spLibsSnapshot != nullptr) {
+        auto spSnapshot = pArenaState->TakeSnapshot();
+        pArenaState->snapshots.insert(key, spSnapshot, spSnapshot->heap.size());
+    }
+    pArenaState->Freeze();
+    loaded = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class CLuaStatePool
+
+CLuaStatePool::CLuaStatePool(OpenLibsFunc openLibsIn, size_t maxStatesIn, size_t arenaSizeIn,
+                             size_t maxSnapshotSizeIn)
+    : openLibs(openLibsIn), maxStates(maxStatesIn), arenaSize(arenaSizeIn), maxSnapshotSize(maxSnapshotSizeIn) {}
+
+CLuaStatePool::~CLuaStatePool() {
+    for (auto pArenaState : idleStates)
+        delete pArenaState;
+}
+
+std::unique_ptr<CLuaPooledState> CLuaStatePool::Acquire(const std::string &key) {
+    CLuaArenaState *pArenaState = nullptr;
+    std::shared_ptr<const CLuaHeapSnapshot> spSnapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // prefer the state which has the snapshot of the key
+        for (auto it = idleStates.begin(); it != idleStates.end(); ++it) {
+            auto pFound = (*it)->snapshots.find(key);
+            if (pFound != nullptr) {
+                spSnapshot  = *pFound;
+                pArenaState = *it;
+                idleStates.erase(it);
+                break;
+            }
+        }
+        if (pArenaState == nullptr && !idleStates.empty()) {
+            pArenaState = idleStates.back();
+            idleStates.pop_back();
+        }
+        if (pArenaState == nullptr) {
+            if (stateCount >= maxStates)
+                return nullptr;
+            ++stateCount;
+        }
+    }
+
+    if (pArenaState == nullptr) {
+        pArenaState = NewArenaState();
+        if (pArenaState == nullptr) {
+            std::lock_guard<std::mutex> lock(mutex);
+            --stateCount;
+            return nullptr;
+        }
+    } else if (spSnapshot != nullptr) {
+        pArenaState->Restore(*spSnapshot, true);
+    } else {
+        pArenaState->Restore(*pArenaState->spLibsSnapshot, false);
+    }
+
+    return std::unique_ptr<CLuaPooledState>(new CLuaPooledState(this, pArenaState, key, spSnapshot != nullptr));
+}
+
+CLuaArenaState *CLuaStatePool::NewArenaState() {
+    std::unique_ptr<CLuaArenaState> spArenaState(new CLuaArenaState(arenaSize, maxSnapshotSize));
+    if (!spArenaState->IsValid())
+        return nullptr;
+
+    lua_State *L = lua_newstate(CLuaArenaState::Alloc, spArenaState.get());
+    if (L == nullptr)
+        return nullptr;
+
+    lua_atpanic(L, &LuaPanic);
+    spArenaState->L = L;
+    if (!lua_StartBurner(L, nullptr, ULLONG_MAX, BURN_VER_NEWEST) || !openLibs(L)) {
+        lua_close(L);
+        return nullptr;
+    }
+
+    // the state can still be used once without the libs snapshot, and is dropped when released
+    if (spArenaState->CanSnapshot())
+        spArenaState->spLibsSnapshot = spArenaState->TakeSnapshot();
+
+    return spArenaState.release();
+}
+
+void CLuaStatePool::Release(CLuaArenaState *pArenaState) {
+    lua_close(pArenaState->L);
+
+    if (pArenaState->spLibsSnapshot == nullptr) {
+        delete pArenaState;
+        std::lock_guard<std::mutex> lock(mutex);
+        --stateCount;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    idleStates.push_back(pArenaState);
+}
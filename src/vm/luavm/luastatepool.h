@@ -0,0 +1,99 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef LUA_STATE_POOL_H
+#define LUA_STATE_POOL_H
+
+#include <stddef.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct lua_State;
+class CLuaArenaState;
+class CLuaStatePool;
+
+static const size_t LUA_STATE_POOL_SIZE         = 4;
+static const size_t LUA_STATE_ARENA_SIZE        = 8 << 20;
+static const size_t LUA_STATE_SNAPSHOT_MAX_SIZE = 16 << 20;  // per pooled state
+
+/**
+ * A lua state acquired from the pool, it goes back to the pool when destroyed. The state is closed
+ * first, so the pending finalizers run at the same point as closing a brand new state.
+ */
+class CLuaPooledState {
+public:
+    ~CLuaPooledState();
+
+    lua_State *GetState() const;
+
+    // restored from the snapshot of the key, the run prefix has been replayed already
+    bool IsLoaded() const { return loaded; }
+
+    // snapshot the heap after the run prefix, and stop recording the heap
+    void SaveSnapshot();
+
+private:
+    friend class CLuaStatePool;
+
+    CLuaPooledState(CLuaStatePool *pPoolIn, CLuaArenaState *pArenaStateIn, const std::string &keyIn, bool loadedIn)
+        : pPool(pPoolIn), pArenaState(pArenaStateIn), key(keyIn), loaded(loadedIn) {}
+
+    CLuaPooledState(const CLuaPooledState &) = delete;
+    CLuaPooledState &operator=(const CLuaPooledState &) = delete;
+
+    CLuaStatePool *pPool;
+    CLuaArenaState *pArenaState;
+    std::string key;
+    bool loaded;
+};
+
+/**
+ * Pool of lua states which are reset by copying back snapshots of their own heap. Every pooled
+ * state allocates its objects in a private arena at a fixed address, so the heap captured after the
+ * libs are opened, or after the whole deterministic prefix of a contract run (passing the arguments
+ * and loading the contract), can be restored bit by bit. The run then goes on exactly as in a brand
+ * new state: the same memory burned, the same GC pace and the same interned strings, so the fuel is
+ * identical. The burner of the prefix is started with the newest version and no limit, the caller
+ * restarts it with lua_RestartBurner() before running.
+ */
+class CLuaStatePool {
+public:
+    // open the libs of a new state, after the burner started
+    typedef std::function<bool(lua_State *L)> OpenLibsFunc;
+
+    CLuaStatePool(OpenLibsFunc openLibsIn, size_t maxStatesIn = LUA_STATE_POOL_SIZE,
+                  size_t arenaSizeIn = LUA_STATE_ARENA_SIZE, size_t maxSnapshotSizeIn = LUA_STATE_SNAPSHOT_MAX_SIZE);
+    ~CLuaStatePool();
+
+    /**
+     * Acquire a state restored to the snapshot of the key if any, or else to the state just after
+     * the libs are opened. The key must identify the whole run prefix.
+     * Return nullptr if all the states are busy.
+     */
+    std::unique_ptr<CLuaPooledState> Acquire(const std::string &key);
+
+private:
+    friend class CLuaPooledState;
+
+    CLuaStatePool(const CLuaStatePool &) = delete;
+    CLuaStatePool &operator=(const CLuaStatePool &) = delete;
+
+    CLuaArenaState *NewArenaState();
+    void Release(CLuaArenaState *pArenaState);
+
+    OpenLibsFunc openLibs;
+    size_t maxStates;
+    size_t arenaSize;
+    size_t maxSnapshotSize;
+
+    std::mutex mutex;
+    std::vector<CLuaArenaState *> idleStates;
+    size_t stateCount = 0;
+};
+
+#endif  // LUA_STATE_POOL_H
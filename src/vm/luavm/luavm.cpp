@@ -17,6 +17,8 @@
 #include "main.h"
 #include "tx/tx.h"
 #include "luavmrunenv.h"
+#include "luastatepool.h"
+#include "vm/vmprofiler.h"
 
 #if 0
 typedef struct NumArray{
@@ -224,6 +226,49 @@ static void ReportBurnState(lua_State *L, CLuaVMRunEnv *pVmRunEnv) {
     );
 }
 
+// the fuel burned so far before the refunds, it only grows
+static uint64_t GetGrossBurnedFuel(lua_State *L) {
+    return lua_GetBurnerState(L)->fuel + lua_GetMemoryFuel(L);
+}
+
+// folded lua stack of the running contract, outermost first, the lua frames with their current lines
+static void GetProfileStack(lua_State *L, std::string &stack) {
+    std::vector<std::string> frames;
+    lua_Debug ar;
+    for (int level = 0; lua_getstack(L, level, &ar); level++) {
+        if (!lua_getinfo(L, "Sln", &ar))
+            break;
+
+        if (ar.what != nullptr && strcmp(ar.what, "C") == 0)
+            frames.push_back(strprintf("%s [C]", ar.name != nullptr ? ar.name : "?"));
+        else if (ar.what != nullptr && strcmp(ar.what, "main") == 0)
+            frames.push_back(strprintf("main:%d", ar.currentline));
+        else if (ar.name != nullptr)
+            frames.push_back(strprintf("%s:%d", ar.name, ar.currentline));
+        else
+            frames.push_back(strprintf("function@%d:%d", ar.linedefined, ar.currentline));
+    }
+
+    stack.clear();
+    for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+        if (!stack.empty())
+            stack += ';';
+        stack += *it;
+    }
+}
+
+// burner tracer of the profiled runs, every burn is a sample of the current stack
+static void ProfileBurnTracer(lua_State *L, const char *caption, const char *format, ...) {
+    CLuaVMRunEnv *pVmRunEnv = (CLuaVMRunEnv *)lua_GetBurnerState(L)->pContext;
+    CVmProfiler *pProfiler  = pVmRunEnv->GetContext().p_profiler;
+    if (pProfiler == nullptr)
+        return;
+
+    std::string stack;
+    GetProfileStack(L, stack);
+    pProfiler->Sample(stack, GetGrossBurnedFuel(L));
+}
+
 static std::string GetLuaError(lua_State *L, int status, std::string prefix) {
     std::string ret;
     if (status != LUA_OK) {
@@ -239,11 +284,71 @@ static std::string GetLuaError(lua_State *L, int status, std::string prefix) {
     return ret;
 }
 
+// open the libs after the burner started, the mylib module is left on the stack
+static bool OpenLuaLibs(lua_State *L) {
+    vm_openlibs(L);
+
+    if (!InitLuaLibsEx(L)) {
+        LogPrint(BCLog::LUAVM, "InitLuaLibsEx error\n");
+        return false;
+    }
+
+    luaL_requiref(L, "mylib", luaopen_mylib, 1);
+    return true;
+}
+
+static CLuaStatePool &GetLuaStatePool() {
+    static CLuaStatePool pool(OpenLuaLibs);
+    return pool;
+}
+
+// pass the contract arguments and the run env to the lua script
+static void PushContractArgs(lua_State *L, const string &arguments, CLuaVMRunEnv *pVmRunEnv) {
+    lua_newtable(L);
+    lua_pushnumber(L, -1);
+    lua_rawseti(L, -2, 0);
+
+    for (size_t i = 0; i < arguments.size(); i++) {
+        lua_pushinteger(L, (uint8_t)arguments[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+    lua_setglobal(L, "contract");
+
+    lua_pushlightuserdata(L, pVmRunEnv);
+    lua_setglobal(L, "VmScriptRun");
+}
+
+// overwrite the values passed by the snapshot run, the table slots and globals exist already so
+// nothing is allocated
+static void SetContractArgs(lua_State *L, const string &arguments, CLuaVMRunEnv *pVmRunEnv) {
+    lua_getglobal(L, "contract");
+    for (size_t i = 0; i < arguments.size(); i++) {
+        lua_pushinteger(L, (uint8_t)arguments[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+    lua_pop(L, 1);
+
+    lua_pushlightuserdata(L, pVmRunEnv);
+    lua_setglobal(L, "VmScriptRun");
+}
+
 tuple<uint64_t, string> CLuaVM::Run(uint64_t fuelLimit, CLuaVMRunEnv *pVmRunEnv) {
     if (NULL == pVmRunEnv) {
         return std::make_tuple(-1, string("pVmRunEnv == NULL"));
     }
 
+    // the run prefix is identified by the contract, its code and the size of the arguments
+    string key = strprintf("%s-%s-%u", pVmRunEnv->GetContractRegID().ToString(),
+                           Hash(code.begin(), code.end()).GetHex(), arguments.size());
+    auto spPooledState = GetLuaStatePool().Acquire(key);
+    if (spPooledState) {
+        if (LoadPooledState(*spPooledState, fuelLimit, pVmRunEnv))
+            return RunContract(spPooledState->GetState(), fuelLimit, pVmRunEnv);
+
+        LogPrint(BCLog::LUAVM, "CLuaVM::Run the run prefix failed in the pooled state, rerun in a new state\n");
+        spPooledState.reset();
+    }
+
     // 1.创建Lua运行环境
     std::unique_ptr<lua_State, decltype(&lua_close)> lua_state_ptr(luaL_newstate(), &lua_close);
     if (!lua_state_ptr) {
@@ -258,46 +363,65 @@ tuple<uint64_t, string> CLuaVM::Run(uint64_t fuelLimit, CLuaVMRunEnv *pVmRunEnv)
         return std::make_tuple(-1, string("CLuaVM::Run lua_StartBurner() failed\n"));
     }
 
-    //打开需要的库
-    vm_openlibs(lua_state);
-
-    if (!InitLuaLibsEx(lua_state)) {
-        LogPrint(BCLog::LUAVM, "InitLuaLibsEx error\n");
+    //打开需要的库，注册自定义模块
+    if (!OpenLuaLibs(lua_state)) {
         return std::make_tuple(-1, string("InitLuaLibsEx error\n"));
     }
 
-    // 3.注册自定义模块
-    luaL_requiref(lua_state, "mylib", luaopen_mylib, 1);
-
     // 4.往lua脚本传递合约内容
-    lua_newtable(lua_state);  //新建一个表,压入栈顶
-    lua_pushnumber(lua_state, -1);
-    lua_rawseti(lua_state, -2, 0);
-
-    for (size_t i = 0; i < arguments.size(); i++) {
-        lua_pushinteger(lua_state, (uint8_t)arguments[i]);  // value值放入
-        lua_rawseti(lua_state, -2, i + 1);                         // set table at key 'n + 1'
-    }
-    lua_setglobal(lua_state, "contract");
-
-    // 传递pVmScriptRun指针，以便后面代码引用，去掉了使用全局变量保存该指针
-    lua_pushlightuserdata(lua_state, pVmRunEnv);
-    lua_setglobal(lua_state, "VmScriptRun");
+    PushContractArgs(lua_state, arguments, pVmRunEnv);
     LogPrint(BCLog::LUAVM, "pVmRunEnv=%p\n", pVmRunEnv);
 
     // 5. Load the contract script
-    std::string strError;
     int luaStatus = luaL_loadbuffer(lua_state, code.c_str(), code.size(), "line");
-    if (luaStatus == LUA_OK) {
-        luaStatus = lua_pcallk(lua_state, 0, 0, 0, 0, NULL, BURN_VER_STEP_V1);
-        if (luaStatus != LUA_OK) {
-            strError = GetLuaError(lua_state, luaStatus, "lua_pcallk failed");
-        }
+    if (luaStatus != LUA_OK) {
+        std::string strError = GetLuaError(lua_state, luaStatus, "luaL_loadbuffer failed");
+        LogPrint(BCLog::LUAVM, "%s\n", strError);
+        ReportBurnState(lua_state, pVmRunEnv);
+        return std::make_tuple(-1, strError);
+    }
+
+    return RunContract(lua_state, fuelLimit, pVmRunEnv);
+}
+
+// replay the run prefix in the pooled state, return false if it fails or burns out
+bool CLuaVM::LoadPooledState(CLuaPooledState &pooledState, uint64_t fuelLimit, CLuaVMRunEnv *pVmRunEnv) {
+    lua_State *L = pooledState.GetState();
+    if (pooledState.IsLoaded()) {
+        SetContractArgs(L, arguments, pVmRunEnv);
     } else {
-        strError = GetLuaError(lua_state, luaStatus, "luaL_loadbuffer failed");
+        PushContractArgs(L, arguments, pVmRunEnv);
+        if (luaL_loadbuffer(L, code.c_str(), code.size(), "line") != LUA_OK)
+            return false;
+
+        pooledState.SaveSnapshot();
+    }
+
+    if (!lua_RestartBurner(L, pVmRunEnv, fuelLimit, pVmRunEnv->GetBurnVersion())) {
+        LogPrint(BCLog::ERROR, "CLuaVM::LoadPooledState lua_RestartBurner() failed\n");
+        return false;
+    }
+    return lua_GetBurnedFuel(L) <= fuelLimit;
+}
+
+// run the loaded contract script
+tuple<uint64_t, string> CLuaVM::RunContract(lua_State *lua_state, uint64_t fuelLimit, CLuaVMRunEnv *pVmRunEnv) {
+    // the profiler only reads the stack, the burned fuel is the same with or without it
+    CVmProfiler *pProfiler = pVmRunEnv->GetContext().p_profiler;
+    if (pProfiler != nullptr) {
+        pProfiler->Sample("load", GetGrossBurnedFuel(lua_state));
+        lua_SetBurnerTracer(lua_state, ProfileBurnTracer);
+    }
+
+    int luaStatus = lua_pcallk(lua_state, 0, 0, 0, 0, NULL, BURN_VER_STEP_V1);
+
+    if (pProfiler != nullptr) {
+        lua_SetBurnerTracer(lua_state, NULL);
+        pProfiler->Sample("", GetGrossBurnedFuel(lua_state));
     }
 
     if (luaStatus != LUA_OK) {
+        std::string strError = GetLuaError(lua_state, luaStatus, "lua_pcallk failed");
         LogPrint(BCLog::LUAVM, "%s\n", strError);
         ReportBurnState(lua_state, pVmRunEnv);
         return std::make_tuple(-1, strError);
@@ -15,7 +15,9 @@
 
 using namespace std;
 
+class CLuaPooledState;
 class CLuaVMRunEnv;
+struct lua_State;
 
 class CLuaVM {
 public:
@@ -26,6 +28,9 @@ public:
     static std::tuple<bool, string> CheckScriptSyntax(const char *filePath);
 
 private:
+    bool LoadPooledState(CLuaPooledState &pooledState, uint64_t fuelLimit, CLuaVMRunEnv *pVmRunEnv);
+    std::tuple<uint64_t, string> RunContract(lua_State *lua_state, uint64_t fuelLimit, CLuaVMRunEnv *pVmRunEnv);
+
     // to hold contract call arguments
     std::string code;
     std::string arguments;
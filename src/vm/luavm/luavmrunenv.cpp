@@ -29,6 +29,8 @@ CLuaVMRunEnv::~CLuaVMRunEnv() {}
 
 std::shared_ptr<string>  CLuaVMRunEnv::ExecuteContract(CLuaVMContext *pContextIn, uint64_t& uRunStep) {
     p_context = pContextIn;
+    contractDataCache.clear();
+    appUserAccountCache.clear();
 
     assert(p_context->p_arguments->size() <= MAX_CONTRACT_ARGUMENT_SIZE);
     assert(p_context->fuel_limit > 0);
@@ -479,6 +481,55 @@ bool CLuaVMRunEnv::GetAppUserAccount(const vector<uint8_t>& vAppUserId, shared_p
     return true;
 }
 
+bool CLuaVMRunEnv::ReadAppUserAccount(const vector<uint8_t>& vAppUserId,
+                                      shared_ptr<const CAppUserAccount>& pAppUserAccount) {
+    auto it = appUserAccountCache.find(vAppUserId);
+    if (it != appUserAccountCache.end()) {
+        pAppUserAccount = it->second;
+        return true;
+    }
+
+    shared_ptr<CAppUserAccount> tem;
+    if (!GetAppUserAccount(vAppUserId, tem))
+        return false;
+
+    appUserAccountCache.emplace(vAppUserId, tem);
+    pAppUserAccount = tem;
+    return true;
+}
+
+bool CLuaVMRunEnv::GetContractData(const string &key, string &value) {
+    auto it = contractDataCache.find(key);
+    if (it == contractDataCache.end()) {
+        string dbValue;
+        bool found = GetScriptDB()->GetContractData(GetContractRegID(), key, dbValue);
+        it = contractDataCache.emplace(key, make_pair(found, std::move(dbValue))).first;
+    }
+
+    if (!it->second.first)
+        return false;
+
+    value = it->second.second;
+    return true;
+}
+
+bool CLuaVMRunEnv::SetContractData(const string &key, const string &value) {
+    if (!GetScriptDB()->SetContractData(GetContractRegID(), key, value))
+        return false;
+
+    // the db cache treats an empty value as absent
+    contractDataCache[key] = make_pair(!value.empty(), value);
+    return true;
+}
+
+bool CLuaVMRunEnv::EraseContractData(const string &key) {
+    if (!GetScriptDB()->EraseContractData(GetContractRegID(), key))
+        return false;
+
+    contractDataCache[key] = make_pair(false, string());
+    return true;
+}
+
 bool CLuaVMRunEnv::OperateAppAccount(const map<vector<uint8_t>, vector<CAppFundOperate>> opMap) {
     newAppUserAccount.clear();
 
@@ -19,9 +19,11 @@
 #include "commons/json/json_spirit_writer_template.h"
 
 #include <memory>
+#include <unordered_map>
 
 using namespace std;
 class CVmOperate;
+class CVmProfiler;
 struct lua_State;
 
 class CLuaVMContext {
@@ -38,6 +40,7 @@ public:
     CAccount* p_app_account        = nullptr;
     CUniversalContract* p_contract = nullptr;
     string* p_arguments            = nullptr;
+    CVmProfiler* p_profiler        = nullptr;
 };
 
 struct AssetTransfer {
@@ -70,6 +73,16 @@ private:
     bool isCheckAccount;  // check account balance
 
     map<vector<uint8_t>, vector<CAppFundOperate>> mapAppFundOperate;  // vector<unsigned char > 存的是accountId
+
+    /**
+     * contract data of the running contract read or written by the host functions in this execution,
+     * the absent keys included (found flag is false), the writes go through to the contract db cache
+     */
+    std::unordered_map<string, pair<bool, string>> contractDataCache;
+    /**
+     * app accounts read by the host functions, they are only operated after the script run
+     */
+    map<vector<uint8_t>, std::shared_ptr<const CAppUserAccount>> appUserAccountCache;
 private:
     bool Init();
 
@@ -141,6 +154,17 @@ public:
     void InsertOutAPPOperte(const vector<uint8_t>& userId, const CAppFundOperate& source);
 
     bool GetAppUserAccount(const vector<uint8_t>& id, std::shared_ptr<CAppUserAccount>& pAppUserAccount);
+    /**
+     * read only app account for the host functions, cached in this execution
+     */
+    bool ReadAppUserAccount(const vector<uint8_t>& id, std::shared_ptr<const CAppUserAccount>& pAppUserAccount);
+
+    /**
+     * contract data of the running contract, cached in this execution
+     */
+    bool GetContractData(const string &key, string &value);
+    bool SetContractData(const string &key, const string &value);
+    bool EraseContractData(const string &key);
     bool CheckAppAcctOperate();
     void SetCheckAccount(bool bCheckAccount);
 
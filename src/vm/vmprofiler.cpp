@@ -0,0 +1,70 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "vmprofiler.h"
+
+#include "commons/tinyformat.h"
+
+using namespace json_spirit;
+
+CVmProfiler::CVmProfiler() : lastTime(std::chrono::steady_clock::now()) {}
+
+void CVmProfiler::Sample(const std::string &stack, uint64_t burnedFuel) {
+    auto now = std::chrono::steady_clock::now();
+    costs[lastStack].nanos += std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastTime).count();
+    lastTime = now;
+
+    // the refunds are not samples, the fuel only grows
+    if (burnedFuel > lastFuel) {
+        costs[stack].fuel += burnedFuel - lastFuel;
+        lastFuel = burnedFuel;
+    }
+
+    lastStack = stack;
+}
+
+void CVmProfiler::EnterFrame(const std::string &frame, uint64_t burnedFuel) {
+    Sample(frames, burnedFuel);
+
+    frameSizes.push_back(frames.size());
+    if (!frames.empty())
+        frames += ';';
+    frames += frame;
+}
+
+void CVmProfiler::LeaveFrame(uint64_t burnedFuel) {
+    Sample(frames, burnedFuel);
+
+    if (!frameSizes.empty()) {
+        frames.resize(frameSizes.back());
+        frameSizes.pop_back();
+    }
+}
+
+Object CVmProfiler::ToJson() const {
+    Array fuelStacks;
+    Array timeStacks;
+    int64_t totalNanos = 0;
+    for (const auto &item : costs) {
+        if (item.first.empty())
+            continue;
+
+        if (item.second.fuel > 0)
+            fuelStacks.push_back(strprintf("%s %llu", item.first, item.second.fuel));
+
+        // rounded to microseconds, the stacks shorter than that in total are left out
+        int64_t micros = item.second.nanos / 1000;
+        if (micros > 0)
+            timeStacks.push_back(strprintf("%s %lld", item.first, micros));
+
+        totalNanos += item.second.nanos;
+    }
+
+    Object obj;
+    obj.push_back(Pair("total_fuel",      lastFuel));
+    obj.push_back(Pair("total_time_us",   totalNanos / 1000));
+    obj.push_back(Pair("fuel_stacks",     fuelStacks));
+    obj.push_back(Pair("time_us_stacks",  timeStacks));
+    return obj;
+}
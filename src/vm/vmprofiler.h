@@ -0,0 +1,52 @@
+// Copyright (c) 2017-2019 The WaykiChain Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef VM_PROFILER_H
+#define VM_PROFILER_H
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "commons/json/json_spirit_value.h"
+
+/**
+ * Fuel and wall time profile of one contract execution, for the dry runs of the rpc calls.
+ *
+ * The costs are attributed to the folded call stacks of the contract, the frames separated by ';'.
+ * The vm either samples its whole stack at every burn (lua) or enters and leaves the frames (wasm).
+ * The fuel of a sample goes to the stack it is sampled in, the time since the last sample goes to
+ * the stack of the last sample. The fuel profile only depends on the contract, its arguments and
+ * the state, the time profile is measured. Both are in the folded format read by flamegraph.pl.
+ */
+class CVmProfiler {
+public:
+    CVmProfiler();
+
+    // the total fuel burned so far and the current stack
+    void Sample(const std::string &stack, uint64_t burnedFuel);
+
+    void EnterFrame(const std::string &frame, uint64_t burnedFuel);
+    void LeaveFrame(uint64_t burnedFuel);
+
+    uint64_t GetTotalFuel() const { return lastFuel; }
+
+    json_spirit::Object ToJson() const;
+
+private:
+    struct CStackCost {
+        uint64_t fuel = 0;
+        int64_t nanos = 0;
+    };
+
+    std::map<std::string, CStackCost> costs;
+    std::string frames;                 // stack of the entered frames
+    std::vector<size_t> frameSizes;     // size of the stack before each entered frame
+    std::string lastStack;
+    uint64_t lastFuel = 0;
+    std::chrono::steady_clock::time_point lastTime;
+};
+
+#endif  // VM_PROFILER_H
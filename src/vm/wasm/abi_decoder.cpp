@@ -0,0 +1,171 @@
+#include "wasm/abi_decoder.hpp"
+#include "wasm/wasm_config.hpp"
+#include "wasm/types/varint.hpp"
+
+namespace wasm {
+
+    abi_decoder::abi_decoder( const abi_serializer &abis, const type_name &type ) {
+        try {
+            _root = compile(abis, type);
+        }
+        WASM_CAPTURE_AND_RETHROW("abi_decoder compile error in type %s", type.c_str())
+    }
+
+    uint32_t abi_decoder::compile( const abi_serializer &abis, const type_name &type ) {
+        auto itr = _compiled.find(type);
+        if (itr != _compiled.end()) return itr->second;
+
+        // registered before the children, so a recursive struct refers to itself
+        uint32_t index = _ops.size();
+        _ops.emplace_back();
+        _compiled[type] = index;
+
+        op o;
+        o.type     = abis.resolve_type(type);
+        auto ftype = abis.fundamental_type(o.type);
+
+        auto btype = abis.built_in_types.find(ftype);
+        if (btype != abis.built_in_types.end()) {
+            o.is_array    = abis.is_array(o.type);
+            o.is_optional = abis.is_optional(o.type);
+
+            auto reader = abis.built_in_readers.find(ftype);
+            if (reader != abis.built_in_readers.end()) {
+                o.kind = op_built_in;
+                o.read = o.is_array ? reader->second.read_array :
+                         o.is_optional ? reader->second.read_optional : reader->second.read;
+            } else {
+                o.kind   = op_built_in_function;
+                o.unpack = btype->second.first;
+            }
+        } else if (abis.is_array(o.type)) {
+            o.kind    = op_array;
+            o.element = compile(abis, ftype);
+        } else if (abis.is_optional(o.type)) {
+            o.kind    = op_optional;
+            o.element = compile(abis, ftype);
+        } else {
+            auto s_itr = abis.structs.find(o.type);
+            if (s_itr != abis.structs.end()) {
+                const auto &st = s_itr->second;
+                o.kind = op_struct;
+                if (st.base != type_name()) {
+                    o.base      = compile(abis, abis.resolve_type(st.base));
+                    o.base_name = st.base;
+                }
+                o.fields.reserve(st.fields.size());
+                for (const auto &field : st.fields)
+                    o.fields.emplace_back(field.name, compile(abis, abi_serializer::_remove_bin_extension(field.type)));
+            }
+        }
+
+        _ops[index] = std::move(o);
+        return index;
+    }
+
+    // json_spirit values are only copied, never moved, so every value is decoded in its final place
+    void abi_decoder::run( uint32_t index, wasm::datastream<const char *> &ds, wasm::abi_traverse_context &ctx,
+                           json_spirit::Value &out ) const {
+        ctx.check_deadline();
+        ctx.recursion_depth++;
+
+        const op &o = _ops[index];
+        switch (o.kind) {
+            case op_built_in:
+                try {
+                    out = o.read(ds);
+                    return;
+                }
+                WASM_RETHROW_EXCEPTIONS(unpack_exception, "Unable to unpack type '%s' ", o.type.c_str())
+
+            case op_built_in_function:
+                try {
+                    out = o.unpack(ds, o.is_array, o.is_optional);
+                    return;
+                }
+                WASM_RETHROW_EXCEPTIONS(unpack_exception, "Unable to unpack type '%s' ", o.type.c_str())
+
+            case op_array: {
+                wasm::unsigned_int size;
+                try {
+                    ds >> size;
+                }
+                WASM_RETHROW_EXCEPTIONS(unpack_exception, "Unable to unpack size of array '%s' ", o.type.c_str())
+                WASM_ASSERT(size < max_abi_array_size, array_size_exceeds_exception,
+                            "Array size %u must be smaller than max %d", size.value, max_abi_array_size);
+
+                out = json_spirit::Array();
+                json_spirit::Array &vars = out.get_array();
+                vars.reserve(size.value);
+                for (decltype(size.value) i = 0; i < size; ++i) {
+                    vars.emplace_back();
+                    run(o.element, ds, ctx, vars.back());
+                    WASM_ASSERT(!vars.back().is_null(), unpack_exception, "Invalid packed array '%s'", o.type.c_str());
+                }
+                return;
+            }
+
+            case op_optional: {
+                char flag;
+                try {
+                    ds >> flag;
+                }
+                WASM_RETHROW_EXCEPTIONS(unpack_exception,
+                                        "Unable to unpack presence flag of optional '%s' ", o.type.c_str())
+                if (flag)
+                    run(o.element, ds, ctx, out);
+                else
+                    out = json_spirit::Value();
+                return;
+            }
+
+            case op_struct: {
+                if (o.base >= 0) {
+                    run(o.base, ds, ctx, out);
+                    if (out.type() != json_spirit::obj_type) {
+                        json_spirit::Value base = out;
+                        out = json_spirit::Object();
+                        json_spirit::Config::add(out.get_obj(), o.base_name, base);
+                    }
+                } else {
+                    out = json_spirit::Object();
+                }
+
+                json_spirit::Object &obj = out.get_obj();
+                obj.reserve(obj.size() + o.fields.size());
+                for (const auto &field : o.fields) {
+                    obj.emplace_back(field.first, json_spirit::Value());
+                    run(field.second, ds, ctx, obj.back().value_);
+                    if (obj.back().value_.is_null())
+                        obj.pop_back();
+                }
+                return;
+            }
+
+            default:
+                break;
+        }
+
+        WASM_THROW(unpack_exception, "Unable to unpack '%s' from stream", o.type.c_str());
+    }
+
+    json_spirit::Value abi_decoder::decode( const char *data, size_t size, microseconds max_serialization_time ) const {
+        json_spirit::Value value;
+        wasm::datastream<const char *> ds(data, size);
+        wasm::abi_traverse_context ctx(max_serialization_time);
+        run(_root, ds, ctx, value);
+        return value;
+    }
+
+    json_spirit::Array abi_decoder::decode_rows( const std::vector<string> &rows,
+                                                 microseconds max_serialization_time ) const {
+        json_spirit::Array values(rows.size());
+        for (size_t i = 0; i < rows.size(); i++) {
+            wasm::datastream<const char *> ds(rows[i].data(), rows[i].size());
+            wasm::abi_traverse_context ctx(max_serialization_time);
+            run(_root, ds, ctx, values[i]);
+        }
+        return values;
+    }
+
+} //wasm
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include "wasm/abi_serializer.hpp"
+
+namespace wasm {
+
+    /**
+     * binary_to_variant of one abi type, compiled ahead. The typedefs, the struct fields and the
+     * built-in types are resolved once into a flat program, a row is then decoded by walking the
+     * program and calling the built-in readers directly, no type name is looked up per value.
+     * Decodes exactly the json of abi_serializer::binary_to_variant, errors included.
+     */
+    class abi_decoder {
+    public:
+        abi_decoder( const abi_serializer &abis, const type_name &type );
+
+        json_spirit::Value decode( const char *data, size_t size, microseconds max_serialization_time ) const;
+        json_spirit::Value decode( const bytes &binary, microseconds max_serialization_time ) const {
+            return decode(binary.data(), binary.size(), max_serialization_time);
+        }
+
+        // decode the rows of a table page in one pass, each row has its own serialization deadline
+        json_spirit::Array decode_rows( const std::vector<string> &rows, microseconds max_serialization_time ) const;
+
+    private:
+        enum op_kind : uint8_t {
+            op_built_in,
+            op_built_in_function,   // specialized built-in type, only an unpack_function
+            op_array,
+            op_optional,
+            op_struct,
+            op_unknown              // thrown when reached, like binary_to_variant does
+        };
+
+        struct op {
+            op_kind   kind = op_unknown;
+            type_name type;         // resolved type, for the error messages
+
+            json_spirit::Value (*read)( wasm::datastream<const char *> & ) = nullptr;
+            abi_serializer::unpack_function unpack;
+            bool      is_array    = false;
+            bool      is_optional = false;
+
+            uint32_t  element = 0;  // op of the array element or the optional value
+            int32_t   base    = -1; // op of the struct base
+            type_name base_name;
+            std::vector<pair<field_name, uint32_t>> fields;
+        };
+
+        uint32_t compile( const abi_serializer &abis, const type_name &type );
+        void run( uint32_t index, wasm::datastream<const char *> &ds, wasm::abi_traverse_context &ctx,
+                  json_spirit::Value &out ) const;
+
+        std::vector<op>               _ops;
+        std::map<type_name, uint32_t> _compiled;
+        uint32_t                      _root;
+    };
+
+} //wasm
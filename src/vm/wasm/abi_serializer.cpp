@@ -76,50 +76,58 @@ namespace wasm {
     void abi_serializer::add_specialized_unpack_pack( const string &name,
                                                       std::pair <abi_serializer::unpack_function, abi_serializer::pack_function> unpack_pack ) {
         built_in_types[name] = std::move(unpack_pack);
+        built_in_readers.erase(name);
+    }
+
+    template<typename T>
+    void abi_serializer::add_built_in_type( const type_name &name ) {
+        built_in_types.emplace(name, pack_unpack<T>());
+        built_in_readers.emplace(name, built_in_reader{&variant_from_stream<T>, &variant_from_stream<vector<T>>,
+                                                       &variant_from_stream<optional<T>>});
     }
 
     void abi_serializer::configure_built_in_types() {
 
-        built_in_types.emplace("bool", pack_unpack<uint8_t>());
-        built_in_types.emplace("int8", pack_unpack<int8_t>());
-        built_in_types.emplace("uint8", pack_unpack<uint8_t>());
-        built_in_types.emplace("int16", pack_unpack<int16_t>());
-        built_in_types.emplace("uint16", pack_unpack<uint16_t>());
-        built_in_types.emplace("int32", pack_unpack<int32_t>());
-        built_in_types.emplace("uint32", pack_unpack<uint32_t>());
-        built_in_types.emplace("int64", pack_unpack<int64_t>());
-        built_in_types.emplace("uint64", pack_unpack<uint64_t>());
-        built_in_types.emplace("int128", pack_unpack<int128_t>());
-        built_in_types.emplace("uint128", pack_unpack<uint128_t>());
-        built_in_types.emplace("varint32", pack_unpack<wasm::signed_int>());
-        built_in_types.emplace("varuint32", pack_unpack<wasm::unsigned_int>());
+        add_built_in_type<uint8_t>("bool");
+        add_built_in_type<int8_t>("int8");
+        add_built_in_type<uint8_t>("uint8");
+        add_built_in_type<int16_t>("int16");
+        add_built_in_type<uint16_t>("uint16");
+        add_built_in_type<int32_t>("int32");
+        add_built_in_type<uint32_t>("uint32");
+        add_built_in_type<int64_t>("int64");
+        add_built_in_type<uint64_t>("uint64");
+        add_built_in_type<int128_t>("int128");
+        add_built_in_type<uint128_t>("uint128");
+        add_built_in_type<wasm::signed_int>("varint32");
+        add_built_in_type<wasm::unsigned_int>("varuint32");
 
         // TODO: Add proper support for floating point types. For now this is good enough.
-        built_in_types.emplace("float32", pack_unpack<float>());
-        built_in_types.emplace("float64", pack_unpack<double>());
+        add_built_in_type<float>("float32");
+        add_built_in_type<double>("float64");
         // built_in_types.emplace("float128",                  pack_unpack<uint128_t>());
 
-        built_in_types.emplace("time_point", pack_unpack<system_clock::time_point>());
+        add_built_in_type<system_clock::time_point>("time_point");
         //built_in_types.emplace("time_point_sec",            pack_unpack<std::time_point_sec>());
         //built_in_types.emplace("block_timestamp_type",      pack_unpack<block_timestamp_type>());
 
-        built_in_types.emplace("table_name", pack_unpack<name>());
-        built_in_types.emplace("action_name", pack_unpack<name>());
-        built_in_types.emplace("name", pack_unpack<name>());
+        add_built_in_type<name>("table_name");
+        add_built_in_type<name>("action_name");
+        add_built_in_type<name>("name");
 
-        built_in_types.emplace("bytes", pack_unpack<bytes>());
-        built_in_types.emplace("string", pack_unpack<string>());
+        add_built_in_type<bytes>("bytes");
+        add_built_in_type<string>("string");
 
-        built_in_types.emplace("checksum160", pack_unpack<checksum160_type>());
-        built_in_types.emplace("checksum256", pack_unpack<checksum256_type>());
-        built_in_types.emplace("checksum512", pack_unpack<checksum512_type>());
+        add_built_in_type<checksum160_type>("checksum160");
+        add_built_in_type<checksum256_type>("checksum256");
+        add_built_in_type<checksum512_type>("checksum512");
 
         // built_in_types.emplace("public_key",                pack_unpack<public_key_type>());
         // built_in_types.emplace("signature",                 pack_unpack<signature_type>());
 
-        built_in_types.emplace("symbol", pack_unpack<symbol>());
-        built_in_types.emplace("symbol_code", pack_unpack<symbol_code>());
-        built_in_types.emplace("asset", pack_unpack<asset>());
+        add_built_in_type<symbol>("symbol");
+        add_built_in_type<symbol_code>("symbol_code");
+        add_built_in_type<asset>("asset");
     }
 
     void abi_serializer::set_abi( const abi_def &abi, const microseconds &max_serialization_time ) {
@@ -66,6 +66,13 @@ namespace wasm {
         void add_specialized_unpack_pack( const string &name,
                                           std::pair <abi_serializer::unpack_function, abi_serializer::pack_function> unpack_pack );
 
+        // plain readers of a built-in type, called by the abi_decoder without the unpack_function
+        struct built_in_reader {
+            json_spirit::Value (*read)( wasm::datastream<const char *> & );
+            json_spirit::Value (*read_array)( wasm::datastream<const char *> & );
+            json_spirit::Value (*read_optional)( wasm::datastream<const char *> & );
+        };
+
         json_spirit::Value get_field_variant( const type_name &s, const json_spirit::Value &v, field_name field, bool is_optional ) const;
         json_spirit::Value get_field_variant( const type_name &s, const json_spirit::Value &v, uint32_t index ) const;
 
@@ -77,6 +84,20 @@ namespace wasm {
 
                 wasm::abi_def def = wasm::unpack<wasm::abi_def>(abi);
                 wasm::abi_serializer abis(def, max_serialization_time);
+                data = pack(abis, action, params, max_serialization_time);
+
+            }
+            WASM_CAPTURE_AND_RETHROW("abi_serializer pack error in params %s", params.c_str())
+
+            return data;
+
+        }
+
+        static std::vector<char>
+        pack( const abi_serializer &abis, const string &action, const string &params, microseconds max_serialization_time ) {
+
+            vector<char> data;
+            try {
 
                 json_spirit::Value data_v;
                 json_spirit::read_string(params, data_v);
@@ -102,7 +123,18 @@ namespace wasm {
             try {
                 wasm::abi_def def = wasm::unpack<wasm::abi_def>(abi);
                 wasm::abi_serializer abis(def, max_serialization_time);
+                data_v = unpack(abis, action, data, max_serialization_time);
+            }
+            WASM_CAPTURE_AND_RETHROW("abi_serializer unpack error in params %s", action.c_str())
+
+            return data_v;
+        }
+
+        static json_spirit::Value
+        unpack( const abi_serializer &abis, const string &action, const bytes &data, microseconds max_serialization_time ) {
 
+            json_spirit::Value data_v;
+            try {
                 string action_type = abis.get_action_type(action);
                 if(action_type == string()){
                     action_type = action;
@@ -120,11 +152,23 @@ namespace wasm {
         unpack( const std::vector<char> &abi, const uint64_t &table, const bytes &data, microseconds max_serialization_time ) {
 
             json_spirit::Value data_v;
-            type_name name;
             try {
 
                 wasm::abi_def def = wasm::unpack<wasm::abi_def>(abi);
                 wasm::abi_serializer abis(def, max_serialization_time);
+                data_v = unpack(abis, table, data, max_serialization_time);
+            }
+            WASM_CAPTURE_AND_RETHROW("abi_serializer unpack error in table %s", wasm::name(table).to_string().c_str())
+
+            return data_v;
+        }
+
+        static json_spirit::Value
+        unpack( const abi_serializer &abis, const uint64_t &table, const bytes &data, microseconds max_serialization_time ) {
+
+            json_spirit::Value data_v;
+            type_name name;
+            try {
 
                 string t = wasm::name(table).to_string();
                 name = abis.get_table_type(t);
@@ -146,8 +190,13 @@ namespace wasm {
         map <type_name, type_name> tables;
         map <uint64_t, string> error_messages;
         map <type_name, pair<unpack_function, pack_function>> built_in_types;
+        map <type_name, built_in_reader> built_in_readers;
+
+        friend class abi_decoder;
 
         void configure_built_in_types();
+        template<typename T>
+        void add_built_in_type( const type_name &name );
         json_spirit::Value _binary_to_variant( const type_name &type, wasm::datastream<const char *> &ds,
                                                wasm::abi_traverse_context &ctx ) const;
 
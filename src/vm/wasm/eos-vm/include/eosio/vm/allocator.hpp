@@ -370,10 +370,29 @@ namespace eosio { namespace vm {
       inline T* get_base_ptr() const { return raw; }
    };
 
+   // The pages beyond the current ones are always zero, so growing the memory does not touch them and
+   // the cost of a reset follows the pages the execution has touched, not the pages it has allocated.
+   // A reset also leaves the pages the module starts with writable, an allocator reused for modules of
+   // the same initial memory changes no protection at all.
    class wasm_allocator {
     private:
       char*   raw       = nullptr;
       int32_t page      = 0;
+      int32_t rw_pages  = 0; // the pages [0, rw_pages) are writable, more than the current ones only after a reset
+
+      // the pages are given back to the kernel and read as zero at the next touch, the cost follows
+      // the pages touched since the last reset, clearing them with memset costs all the allocated ones
+      void zero_pages(std::size_t first, std::size_t count) {
+         if (count == 0) return;
+         int err = madvise(raw + (page_size * first), page_size * count, MADV_DONTNEED);
+         EOS_VM_ASSERT(err == 0, wasm_bad_alloc, "madvise failed");
+      }
+
+      void protect_pages(int32_t first, int32_t last, int prot) {
+         if (last <= first) return;
+         int err = mprotect(raw + (page_size * first), page_size * (last - first), prot);
+         EOS_VM_ASSERT(err == 0, wasm_bad_alloc, "mprotect failed");
+      }
 
     public:
       template <typename T>
@@ -381,11 +400,11 @@ namespace eosio { namespace vm {
          if (size == 0) return;
          EOS_VM_ASSERT(page != -1, wasm_bad_alloc, "require memory to allocate");
          EOS_VM_ASSERT(size <= max_pages - page, wasm_bad_alloc, "exceeded max number of pages");
-         int err = mprotect(raw + (page_size * page), (page_size * size), PROT_READ | PROT_WRITE);
-         EOS_VM_ASSERT(err == 0, wasm_bad_alloc, "mprotect failed");
-         T* ptr    = (T*)(raw + (page_size * page));
-         memset(ptr, 0, page_size * size);
-         page += size;
+         int32_t end = page + size;
+         protect_pages(page > rw_pages ? page : rw_pages, end, PROT_READ | PROT_WRITE);
+         protect_pages(end, rw_pages, PROT_NONE);
+         page     = end;
+         rw_pages = end;
       }
       template <typename T>
       void free(std::size_t size) {
@@ -393,8 +412,9 @@ namespace eosio { namespace vm {
          EOS_VM_ASSERT(page != -1, wasm_bad_alloc, "require memory to deallocate");
          EOS_VM_ASSERT(size <= page, wasm_bad_alloc, "freed too many pages");
          page -= size;
-         int err = mprotect(raw + (page_size * page), (page_size * size), PROT_NONE);
-         EOS_VM_ASSERT(err == 0, wasm_bad_alloc, "mprotect failed");
+         zero_pages(page, size);
+         protect_pages(page, rw_pages, PROT_NONE);
+         rw_pages = page;
       }
       void free() {
          std::size_t syspagesize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
@@ -411,28 +431,28 @@ namespace eosio { namespace vm {
       }
       void reset(uint32_t new_pages) {
          if (page != -1) {
-            memset(raw, '\0', page_size * page); // zero the memory
+            zero_pages(0, page); // zero the memory
          } else {
             std::size_t syspagesize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
             int err = mprotect(raw - syspagesize, syspagesize, PROT_READ);
             EOS_VM_ASSERT(err == 0, wasm_bad_alloc, "mprotect failed");
          }
-         // no need to mprotect if the size hasn't changed
-         if (new_pages != page && page > 0) {
-            int err = mprotect(raw, page_size * page, PROT_NONE); // protect the entire region of memory
-            EOS_VM_ASSERT(err == 0, wasm_bad_alloc, "mprotect failed");
-         }
-         page = 0;
+         // no need to mprotect the pages the memory is about to grow to again
+         int32_t keep = (int32_t)new_pages < rw_pages ? (int32_t)new_pages : rw_pages;
+         protect_pages(keep, rw_pages, PROT_NONE);
+         rw_pages = keep;
+         page     = 0;
       }
       // Signal no memory defined
       void reset() {
          if (page != -1) {
             std::size_t syspagesize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
-            memset(raw, '\0', page_size * page); // zero the memory
-            int err = mprotect(raw - syspagesize, page_size * page + syspagesize, PROT_NONE);
+            zero_pages(0, page); // zero the memory
+            int err = mprotect(raw - syspagesize, page_size * rw_pages + syspagesize, PROT_NONE);
             EOS_VM_ASSERT(err == 0, wasm_bad_alloc, "mprotect failed");
          }
-         page = -1;
+         page     = -1;
+         rw_pages = 0;
       }
       template <typename T>
       inline T* get_base_ptr() const {
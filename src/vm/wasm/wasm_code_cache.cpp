@@ -0,0 +1,70 @@
+#include "wasm/wasm_code_cache.hpp"
+#include "wasm/wasm_config.hpp"
+#include "wasm/types/name.hpp"
+#include "crypto/hash.h"
+#include "entities/contract.h"
+#include "entities/id.h"
+
+namespace wasm {
+
+    wasm_code_entry::wasm_code_entry(const std::string &code_in, const std::string &abi_in)
+            : code(code_in), code_hash(Hash(code_in.begin(), code_in.end())), abi(abi_in) {}
+
+    std::shared_ptr<const abi_serializer> wasm_code_entry::get_abi_serializer() const {
+        std::lock_guard<std::mutex> lock(_abi_mutex);
+        if (!_abi_serializer) {
+            try {
+                abi_def def     = wasm::unpack<abi_def>(std::vector<char>(abi.begin(), abi.end()));
+                _abi_serializer = std::make_shared<abi_serializer>(def, max_serialization_time);
+            }
+            WASM_CAPTURE_AND_RETHROW("%s", "wasm_code_entry.get_abi_serializer, abi parse error")
+        }
+        return _abi_serializer;
+    }
+
+    std::shared_ptr<const abi_decoder> wasm_code_entry::get_table_decoder(uint64_t table) const {
+        auto abis = get_abi_serializer();
+
+        std::lock_guard<std::mutex> lock(_abi_mutex);
+        auto itr = _table_decoders.find(table);
+        if (itr != _table_decoders.end())
+            return itr->second;
+
+        string t       = wasm::name(table).to_string();
+        type_name type = abis->get_table_type(t);
+        WASM_ASSERT(type.size() > 0, abi_parse_exception, "can not get table %s's type from abi", t.data());
+
+        auto sp_decoder = std::make_shared<abi_decoder>(*abis, type);
+        _table_decoders.emplace(table, sp_decoder);
+        return sp_decoder;
+    }
+
+    wasm_code_cache &wasm_code_cache::instance() {
+        static wasm_code_cache cache;
+        return cache;
+    }
+
+    wasm_code_cache::wasm_code_cache() : _entries(max_code_cache_bytes) {}
+
+    std::shared_ptr<const wasm_code_entry> wasm_code_cache::get(const CRegID &regid, const CUniversalContract &contract) {
+        string key = regid.ToRawString();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto p_entry = _entries.find(key);
+            if (p_entry != nullptr && (*p_entry)->code == contract.code && (*p_entry)->abi == contract.abi)
+                return *p_entry;
+        }
+
+        // hash the code out of the lock
+        auto sp_entry = std::make_shared<wasm_code_entry>(contract.code, contract.abi);
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.insert(key, sp_entry, contract.code.size() + contract.abi.size());
+        return sp_entry;
+    }
+
+    void wasm_code_cache::erase(const CRegID &regid) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.erase(regid.ToRawString());
+    }
+
+} //wasm
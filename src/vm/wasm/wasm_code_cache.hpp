@@ -0,0 +1,63 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "commons/clockcache.h"
+#include "commons/uint256.h"
+#include "wasm/abi_decoder.hpp"
+#include "wasm/abi_serializer.hpp"
+
+class CRegID;
+class CUniversalContract;
+
+namespace wasm {
+
+    /**
+     * Code and abi of a contract, immutable once built and shared by the executions and the rpc calls.
+     * The abi serializer is parsed at the first use, the executions never need it.
+     */
+    class wasm_code_entry {
+    public:
+        wasm_code_entry(const std::string &code_in, const std::string &abi_in);
+
+        const std::string code;
+        const uint256     code_hash;
+        const std::string abi;
+
+        // throw if the abi can not be parsed
+        std::shared_ptr<const abi_serializer> get_abi_serializer() const;
+        // decoder of the rows of a table, compiled at the first query; throw if the abi has no such table
+        std::shared_ptr<const abi_decoder> get_table_decoder(uint64_t table) const;
+
+    private:
+        mutable std::mutex                                             _abi_mutex;
+        mutable std::shared_ptr<const abi_serializer>                  _abi_serializer;
+        mutable std::map<uint64_t, std::shared_ptr<const abi_decoder>> _table_decoders;
+    };
+
+    /**
+     * Process-wide cache of the contract code and abi by regid. An entry is reused only while the
+     * code and abi kept by the caller's db view are still the same, comparing them in place is much
+     * cheaper than copying and hashing the code and parsing the abi again. So an entry left by an uncommitted
+     * or rolled back setcode is never served, setcode just drops the stale entry early.
+     */
+    class wasm_code_cache {
+    public:
+        static wasm_code_cache &instance();
+
+        std::shared_ptr<const wasm_code_entry> get(const CRegID &regid, const CUniversalContract &contract);
+        void erase(const CRegID &regid);
+
+    private:
+        wasm_code_cache();
+        wasm_code_cache(const wasm_code_cache &) = delete;
+        wasm_code_cache &operator=(const wasm_code_cache &) = delete;
+
+        std::mutex                                                       _mutex;
+        clockcache<std::string, std::shared_ptr<const wasm_code_entry>> _entries;
+    };
+
+} //wasm
@@ -21,6 +21,8 @@ namespace wasm {
     const static uint16_t max_wasm_api_data_bytes      = 4096;
     const static uint16_t max_inline_transactions_size = 1024;
     const static uint16_t max_signatures_size          = 16;
+    const static uint64_t max_code_cache_bytes         = 64 * 1024 * 1024; // code and abi kept by wasm_code_cache
+    const static uint16_t max_wasm_memory_pool_size    = 8;                // idle linear memories kept by wasm_memory_pool
 
     const static uint64_t wasmio       = N(wasmio);
     const static uint64_t wasmio_bank  = N(wasmio.bank);
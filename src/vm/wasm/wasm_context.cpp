@@ -5,6 +5,7 @@
 #include "wasm/wasm_config.hpp"
 #include "wasm/wasm_log.hpp"
 #include "entities/account.h"
+#include "vm/vmprofiler.h"
 
 using namespace std;
 using namespace wasm;
@@ -100,16 +101,18 @@ namespace wasm {
         inline_transactions.push_back(t);
     }
 
-    std::vector <uint8_t> wasm_context::get_code(uint64_t account) {
+    std::shared_ptr<const wasm_code_entry> wasm_context::get_code(uint64_t account) {
 
-        vector <uint8_t> code;
-        CUniversalContract contract;
-        CAccount contract_account ;
-        if(database.accountCache.GetAccount(CNickID(account), contract_account)
-            && database.contractCache.GetContract(contract_account.regid, contract)) {
-            code = vector <uint8_t>(contract.code.begin(), contract.code.end());
-        }
-        return code;
+        CAccount contract_account;
+        if (!database.accountCache.GetAccount(CNickID(account), contract_account))
+            return nullptr;
+
+        // the contract is compared in place with the cached entry, it is only copied on a miss
+        const CUniversalContract *p_contract = database.contractCache.GetContractPtr(contract_account.regid);
+        if (p_contract == nullptr)
+            return nullptr;
+
+        return wasm_code_cache::instance().get(contract_account.regid, *p_contract);
     }
 
     // std::string wasm_context::get_abi(uint64_t account) {
@@ -135,6 +138,10 @@ namespace wasm {
 
         initialize();
 
+        // the notified receivers and the inline transactions are in the frame of the action
+        string frame = is_profiling() ? name(trx.contract).to_string() + "::" + name(trx.action).to_string() : string();
+        wasm_profile_scope profile_scope(this, frame.c_str());
+
         notified.push_back(_receiver);
         execute_one(trace);
 
@@ -161,6 +168,9 @@ namespace wasm {
     void wasm_context::execute_one(inline_transaction_trace &trace) {
 
         //auto start = system_clock::now();
+        string frame = is_profiling() ? "@" + name(_receiver).to_string() : string();
+        wasm_profile_scope profile_scope(this, frame.c_str());
+
         control_trx.recipients_size ++;
 
         trace.trx      = trx;
@@ -173,9 +183,9 @@ namespace wasm {
                 (*native)(*this);
             } else {
 
-                vector <uint8_t> code = get_code(_receiver);
-                if (code.size() > 0) {
-                    wasmif.execute(code, this);
+                auto code = get_code(_receiver);
+                if (code && code->code.size() > 0) {
+                    wasmif.execute(code->code_hash, code->code, this);
                 }
             }
         } catch (wasm::exception &e) {
@@ -197,12 +207,14 @@ namespace wasm {
         }
 
         trace.trx_id  = control_trx.GetHash();
-        trace.console = _pending_console_output.str();
         //trace.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(system_clock::now() - start);
 
-        reset_console();
+        if (_capture_console && _pending_console_output.tellp() > 0) {
+            trace.console = _pending_console_output.str();
+            reset_console();
+        }
 
-        if (contracts_console()) {
+        if (_print_console) {
             print_debug(_receiver, trace);
         }
 
@@ -256,6 +268,14 @@ namespace wasm {
         return std::vector<uint64_t>();
     }
 
+    void wasm_context::profile_enter(const char *frame) {
+        control_trx.profiler->EnterFrame(frame, control_trx.get_profiled_fuel());
+    }
+
+    void wasm_context::profile_leave() {
+        control_trx.profiler->LeaveFrame(control_trx.get_profiled_fuel());
+    }
+
     void wasm_context::update_storage_usage(uint64_t account, int64_t size_in_bytes){
 
         //int64_t disk_usage    = control_trx.nRunStep;
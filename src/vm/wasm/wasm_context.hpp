@@ -10,6 +10,8 @@
 #include "tx/wasmcontracttx.h"
 #include "wasm/types/inline_transaction.hpp"
 #include "wasm/wasm_interface.hpp"
+#include "wasm/wasm_code_cache.hpp"
+#include "wasm/wasm_memory_pool.hpp"
 #include "wasm/datastream.hpp"
 #include "wasm/wasm_trace.hpp"
 #include "eosio/vm/allocator.hpp"
@@ -29,19 +31,21 @@ namespace wasm {
         wasm_context(CWasmContractTx &ctrl, inline_transaction &t, CCacheWrapper &cw,
                      vector <CReceipt> &receipts_in, bool mining, uint32_t depth = 0)
                 : trx(t), control_trx(ctrl), database(cw), receipts(receipts_in), recurse_depth(depth) {
-            reset_console();
+            // the console output only goes to the printing and the full traces of the validated blocks
+            bool validating = control_trx.transaction_status == wasm::transaction_status_type::validating;
+            _print_console   = validating && SysCfg().GetBoolArg("-contracts_console", false);
+            _capture_console = _print_console || (validating && SysCfg().GetWasmTraceLevel() == WASM_TRACE_FULL);
+            _profiling       = control_trx.profiler != nullptr;
         };
 
-        ~wasm_context() {
-            wasm_alloc.free();
-        };
+        ~wasm_context() {};
 
     public:
         void                  initialize();
         void                  execute(inline_transaction_trace &trace);
         void                  execute_one(inline_transaction_trace &trace);
         bool                  has_permission_from_inline_transaction(const permission &p);
-        std::vector <uint8_t> get_code(uint64_t account);
+        std::shared_ptr<const wasm_code_entry> get_code(uint64_t account);
 // Console methods:
     public:
         void                      reset_console();
@@ -101,22 +105,24 @@ namespace wasm {
             return database.contractCache.EraseContractData(contract_account.regid, k);
         }
 
-        bool contracts_console() {
-            return SysCfg().GetBoolArg("-contracts_console", false) && control_trx.transaction_status == wasm::transaction_status_type::validating;
-        }
+        // whether the host methods capture the console output
+        bool contracts_console() { return _capture_console; }
 
         void console_append(string val) {
             _pending_console_output << val;
         }
 
-        vm::wasm_allocator*       get_wasm_allocator() { return &wasm_alloc; }
-        bool                      is_memory_in_wasm_allocator( const char* p ) { return wasm_alloc.is_in_range(p); }
+        vm::wasm_allocator*       get_wasm_allocator() { return wasm_memory.get(); }
+        bool                      is_memory_in_wasm_allocator( const char* p ) { return wasm_memory.is_in_range(p); }
 
         std::chrono::milliseconds get_max_transaction_duration() { return control_trx.get_max_transaction_duration(); }
         void                      update_storage_usage(uint64_t account, int64_t size_in_bytes);
         void                      pause_billing_timer ()  { control_trx.pause_billing_timer();  };
         void                      resume_billing_timer()  { control_trx.resume_billing_timer(); };
 
+        void                      profile_enter( const char *frame );
+        void                      profile_leave();
+
     public:
         inline_transaction&        trx;
         CWasmContractTx&           control_trx;
@@ -127,10 +133,12 @@ namespace wasm {
         vector<inline_transaction> inline_transactions;
 
         wasm::wasm_interface       wasmif;
-        vm::wasm_allocator         wasm_alloc;
+        wasm::wasm_memory          wasm_memory;
         uint64_t                   _receiver;
 
     private:
         std::ostringstream         _pending_console_output;
+        bool                       _print_console;
+        bool                       _capture_console;
     };
 }
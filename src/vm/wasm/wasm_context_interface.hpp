@@ -55,6 +55,30 @@ namespace wasm {
         virtual void pause_billing_timer (){};
         virtual void resume_billing_timer(){};
 
+        // frames of the fuel and time profile, only the dry runs are profiled. The flag is set once by
+        // the context, a host call of the validated txs only reads it
+        bool         is_profiling () const { return _profiling; }
+        virtual void profile_enter( const char *frame ) {}
+        virtual void profile_leave() {}
+
+    protected:
+        bool _profiling = false;
+
+    };
+
+    // the scope is a frame of the profile, if the context is profiled
+    class wasm_profile_scope {
+    public:
+        wasm_profile_scope( wasm_context_interface *ctx, const char *frame )
+            : _ctx(ctx->is_profiling() ? ctx : nullptr) {
+            if (_ctx) _ctx->profile_enter(frame);
+        }
+        ~wasm_profile_scope() {
+            if (_ctx) _ctx->profile_leave();
+        }
+
+    private:
+        wasm_context_interface *_ctx;
     };
 
 }
\ No newline at end of file
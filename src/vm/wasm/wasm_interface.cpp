@@ -15,6 +15,8 @@
 
 #include "crypto/hash.h"
 
+#include <mutex>
+
 using namespace eosio;
 using namespace eosio::vm;
 
@@ -24,6 +26,8 @@ namespace wasm {
     using rhf_t              = eosio::vm::registered_host_functions<wasm_context_interface>;
     std::map <code_version, std::shared_ptr<wasm_instantiated_module_interface>> wasm_instantiation_cache;
     std::shared_ptr <wasm_runtime_interface> runtime_interface;
+    // guards the runtime creation and the instantiation cache, shared with the precompiling thread
+    std::mutex wasm_instantiation_mutex;
 
     wasm_interface::wasm_interface() {}
     wasm_interface::~wasm_interface() {}
@@ -32,25 +36,28 @@ namespace wasm {
         runtime_interface->immediately_exit_currently_running_module();
     }
 
-    std::shared_ptr <wasm_instantiated_module_interface> get_instantiated_backend(const vector <uint8_t> &code) {
+    std::shared_ptr <wasm_instantiated_module_interface> get_instantiated_backend(const code_version &code_id,
+                                                                                   const char *code_bytes,
+                                                                                   size_t code_size) {
 
-        try {
-            auto code_id = Hash(code.begin(), code.end());
+        {
+            std::lock_guard<std::mutex> lock(wasm_instantiation_mutex);
             auto it = wasm_instantiation_cache.find(code_id);
-            if (it == wasm_instantiation_cache.end()) {
-                wasm_instantiation_cache[code_id] = runtime_interface->instantiate_module((const char*)code.data(), code.size());
-                return wasm_instantiation_cache[code_id];
-            }
-            return it->second;
-        } catch (...) {
-            throw;
+            if (it != wasm_instantiation_cache.end())
+                return it->second;
         }
 
+        // compile out of the lock, the executions never wait for the modules being precompiled
+        auto pInstantiated_module = runtime_interface->instantiate_module(code_bytes, code_size);
+
+        std::lock_guard<std::mutex> lock(wasm_instantiation_mutex);
+        return wasm_instantiation_cache.emplace(code_id, pInstantiated_module).first->second;
     }
 
     void wasm_interface::execute(const vector <uint8_t> &code, wasm_context_interface *pWasmContext) {
         pWasmContext->pause_billing_timer();
-        std::shared_ptr <wasm_instantiated_module_interface> pInstantiated_module = get_instantiated_backend(code);
+        std::shared_ptr <wasm_instantiated_module_interface> pInstantiated_module =
+                get_instantiated_backend(Hash(code.begin(), code.end()), (const char*)code.data(), code.size());
         pWasmContext->resume_billing_timer();
 
         //system_clock::time_point start = system_clock::now();
@@ -61,6 +68,26 @@ namespace wasm {
 
     }
 
+    void wasm_interface::execute(const uint256 &code_hash, const string &code, wasm_context_interface *pWasmContext) {
+        pWasmContext->pause_billing_timer();
+        std::shared_ptr <wasm_instantiated_module_interface> pInstantiated_module =
+                get_instantiated_backend(code_hash, code.data(), code.size());
+        pWasmContext->resume_billing_timer();
+
+        pInstantiated_module->apply(pWasmContext);
+    }
+
+    bool wasm_interface::precompile(const uint256 &code_hash, const string &code) {
+
+        try {
+            get_instantiated_backend(code_hash, code.data(), code.size());
+            return true;
+        } catch (...) {
+            return false;
+        }
+
+    }
+
     void wasm_interface::validate(const vector <uint8_t> &code) {
 
         try {
@@ -78,6 +105,11 @@ namespace wasm {
 
     void wasm_interface::initialize(vm_type vm) {
 
+        // the cached modules keep pointing to the runtime, it is never replaced
+        std::lock_guard<std::mutex> lock(wasm_instantiation_mutex);
+        if (runtime_interface)
+            return;
+
         if (vm == wasm::vm_type::eos_vm)
             runtime_interface = std::make_shared<wasm::wasm_vm_runtime<vm::interpreter>>();
         else if (vm == wasm::vm_type::eos_vm_jit)
@@ -87,6 +119,9 @@ namespace wasm {
 
     }
 
+    // the host call is a frame of the profile of the dry runs
+    #define WASM_PROFILE_HOST_CALL wasm_profile_scope profile_scope(pWasmContext, __func__);
+
     class wasm_host_methods {
         
     public:
@@ -145,6 +180,7 @@ namespace wasm {
 
         //action
         uint32_t read_action_data( void* memory, uint32_t buf_len ) {
+            WASM_PROFILE_HOST_CALL
             uint32_t s = pWasmContext->get_action_data_size();
             if (buf_len == 0) return s;
 
@@ -174,6 +210,7 @@ namespace wasm {
 
         //database
         int32_t db_store( const uint64_t payer, const void *key, uint32_t key_len, const void *val, uint32_t val_len ) {
+            WASM_PROFILE_HOST_CALL
             WASM_ASSERT( pWasmContext->is_memory_in_wasm_allocator(reinterpret_cast<const char*>(key) + key_len), 
                          wasm_memory_exception, "%s", "access violation")
             WASM_ASSERT( pWasmContext->is_memory_in_wasm_allocator(reinterpret_cast<const char*>(val) + val_len), 
@@ -196,6 +233,7 @@ namespace wasm {
         }
 
         int32_t db_remove( const uint64_t payer, const void *key, uint32_t key_len ) {
+            WASM_PROFILE_HOST_CALL
             WASM_ASSERT( pWasmContext->is_memory_in_wasm_allocator(reinterpret_cast<const char*>(key) + key_len), 
                          wasm_memory_exception, "%s", "access violation")
 
@@ -219,6 +257,7 @@ namespace wasm {
         }
 
         int32_t db_get( const void *key, uint32_t key_len, void *val, uint32_t val_len ) {
+            WASM_PROFILE_HOST_CALL
             WASM_ASSERT( pWasmContext->is_memory_in_wasm_allocator(reinterpret_cast<const char*>(key) + key_len), 
                          wasm_memory_exception, "%s", "access violation")
             WASM_ASSERT( pWasmContext->is_memory_in_wasm_allocator(reinterpret_cast<const char*>(val) + val_len), 
@@ -246,6 +285,7 @@ namespace wasm {
         }
 
         int32_t db_update( const uint64_t payer, const void *key, uint32_t key_len, const void *val, uint32_t val_len ) {
+            WASM_PROFILE_HOST_CALL
             WASM_ASSERT( pWasmContext->is_memory_in_wasm_allocator(reinterpret_cast<const char*>(key) + key_len), 
                          wasm_memory_exception, "%s", "access violation")
             WASM_ASSERT( pWasmContext->is_memory_in_wasm_allocator(reinterpret_cast<const char*>(val) + val_len), 
@@ -277,6 +317,7 @@ namespace wasm {
 
         //memory
         void *memcpy( void *dest, const void *src, int len ) {
+            WASM_PROFILE_HOST_CALL
             WASM_ASSERT((size_t)(std::abs((ptrdiff_t)dest - (ptrdiff_t)src)) >= len,
                   overlapping_memory_error, "%s", "memcpy can only accept non-aliasing pointers");
 
@@ -284,10 +325,12 @@ namespace wasm {
         }
 
         void *memmove( void *dest, const void *src, int len ) {
+            WASM_PROFILE_HOST_CALL
             return (char *) std::memmove(dest, src, len);
         }
 
         int memcmp( const void *dest, const void *src, int len ) {
+            WASM_PROFILE_HOST_CALL
             int ret = std::memcmp(dest, src, len);
             if (ret < 0)
                 return -1;
@@ -297,16 +340,19 @@ namespace wasm {
         }
 
         void *memset( void *dest, int val, int len ) {
+            WASM_PROFILE_HOST_CALL
             return (char *) std::memset(dest, val, len);
         }
 
         void printn( uint64_t val ) {//should be name
+            WASM_PROFILE_HOST_CALL
             if (!print_ignore) {
                 pWasmContext->console_append(wasm::name(val).to_string());
             }
         }
 
         void printui( uint64_t val ) {
+            WASM_PROFILE_HOST_CALL
             if (!print_ignore) {
                 std::ostringstream o;
                 o << val;
@@ -315,6 +361,7 @@ namespace wasm {
         }
 
         void printi( int64_t val ) {
+            WASM_PROFILE_HOST_CALL
             if (!print_ignore) {
                 std::ostringstream o;
                 o << val;
@@ -323,6 +370,7 @@ namespace wasm {
         }
 
         void prints( const void *str ) {
+            WASM_PROFILE_HOST_CALL
             WASM_ASSERT(strlen((const char*)str) < max_wasm_api_data_bytes, 
                         wasm_api_data_too_big, "%s", "string size too big");
 
@@ -334,6 +382,7 @@ namespace wasm {
         }
 
         void prints_l( const void *str, uint32_t str_len ) {
+            WASM_PROFILE_HOST_CALL
             WASM_ASSERT( pWasmContext->is_memory_in_wasm_allocator(reinterpret_cast<const char*>(str) + str_len), 
                 wasm_memory_exception, "%s", "access violation")
 
@@ -344,6 +393,7 @@ namespace wasm {
         }
 
         void printi128( const __int128 &val ) {
+            WASM_PROFILE_HOST_CALL
             if (!print_ignore) {
                 bool is_negative = (val < 0);
                 unsigned __int128 val_magnitude;
@@ -364,6 +414,7 @@ namespace wasm {
         }
 
         void printui128( const unsigned __int128 &val ) {
+            WASM_PROFILE_HOST_CALL
             if (!print_ignore) {
                 wasm::uint128 v(val >> 64, static_cast<uint64_t>(val));
                 pWasmContext->console_append(string(v));
@@ -371,6 +422,7 @@ namespace wasm {
         }
 
         void printsf( float val ) {
+            WASM_PROFILE_HOST_CALL
             if (!print_ignore) {
                 // Assumes float representation on native side is the same as on the WASM side
                 std::ostringstream o;
@@ -383,6 +435,7 @@ namespace wasm {
         }
 
         void printdf( double val ) {
+            WASM_PROFILE_HOST_CALL
             if (!print_ignore) {
                 // Assumes double representation on native side is the same as on the WASM side
                 std::ostringstream o;
@@ -394,6 +447,7 @@ namespace wasm {
         }
 
         void printqf( const float128_t& val ) {
+            WASM_PROFILE_HOST_CALL
             /*
              * Native-side long double uses an 80-bit extended-precision floating-point number.
              * The easiest solution for now was to use the Berkeley softfloat library to round the 128-bit
@@ -428,6 +482,7 @@ namespace wasm {
         }
 
         void printhex( const char *data, uint32_t data_len ) {
+            WASM_PROFILE_HOST_CALL
             if (!print_ignore) {
 
                 WASM_ASSERT(data_len < max_wasm_api_data_bytes, wasm_api_data_too_big, "%s",
@@ -440,18 +495,22 @@ namespace wasm {
         
         //authorization
         void require_auth( uint64_t account ) {
+            WASM_PROFILE_HOST_CALL
             pWasmContext->require_auth(account);
         }
 
         void require_auth2( uint64_t account, uint64_t permission ) {
+            WASM_PROFILE_HOST_CALL
             pWasmContext->require_auth(account);
         }
 
         bool has_authorization( uint64_t account ) const {
+            WASM_PROFILE_HOST_CALL
             return pWasmContext->has_authorization(account);
         }
 
         void require_recipient( uint64_t recipient ) {
+            WASM_PROFILE_HOST_CALL
 
             WASM_ASSERT( is_account(recipient), account_operation_exception, 
                          "can not send a receipt to a non-exist account '%s'",
@@ -462,11 +521,13 @@ namespace wasm {
         }
 
         bool is_account( uint64_t account ) {
+            WASM_PROFILE_HOST_CALL
             return pWasmContext->is_account(account);
         }
 
         //transaction
         void send_inline( void *data, uint32_t data_len ) {
+            WASM_PROFILE_HOST_CALL
             WASM_ASSERT(data_len < max_inline_transaction_bytes, inline_transaction_too_big, "%s",
                         "inline transaction too big");
             inline_transaction trx = wasm::unpack<inline_transaction>((const char *) data, data_len);
@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <map>
+#include <string>
+#include "commons/uint256.h"
 #include "wasm/wasm_context_interface.hpp"
 #include "wasm/wasm_runtime.hpp"
 
@@ -22,6 +24,10 @@ namespace wasm {
     public:
         void initialize(vm_type vm);
         void execute(const vector <uint8_t>& code, wasm_context_interface *pWasmContext);
+        // the code hash is computed by the caller, e.g. kept by wasm_code_cache
+        void execute(const uint256& code_hash, const string& code, wasm_context_interface *pWasmContext);
+        // compile the code ahead of its first execution, return false if the code can not be compiled
+        bool precompile(const uint256& code_hash, const string& code);
         void validate(const vector <uint8_t>& code);
         void exit();
 
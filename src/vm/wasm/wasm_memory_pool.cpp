@@ -0,0 +1,58 @@
+#include "wasm/wasm_memory_pool.hpp"
+#include "wasm/wasm_config.hpp"
+
+#include <algorithm>
+
+namespace wasm {
+
+    wasm_memory_pool &wasm_memory_pool::instance() {
+        static wasm_memory_pool pool;
+        return pool;
+    }
+
+    wasm_memory_pool::~wasm_memory_pool() {
+        for (auto p_alloc : _idle) {
+            p_alloc->free();
+            delete p_alloc;
+        }
+    }
+
+    eosio::vm::wasm_allocator *wasm_memory_pool::acquire() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_idle.empty()) {
+                auto p_alloc = _idle.back();
+                _idle.pop_back();
+                return p_alloc;
+            }
+        }
+        return new eosio::vm::wasm_allocator();
+    }
+
+    void wasm_memory_pool::release(eosio::vm::wasm_allocator *p_alloc) {
+        try {
+            // cleared, the pages stay writable for the next module, which resets the memory to its own size
+            p_alloc->reset(std::max(p_alloc->get_current_page(), 0));
+        } catch (...) {
+            p_alloc->free();
+            delete p_alloc;
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_idle.size() < max_wasm_memory_pool_size) {
+                _idle.push_back(p_alloc);
+                return;
+            }
+        }
+        p_alloc->free();
+        delete p_alloc;
+    }
+
+    size_t wasm_memory_pool::idle_size() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _idle.size();
+    }
+
+} //wasm
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "eosio/vm/allocator.hpp"
+
+namespace wasm {
+
+    /**
+     * Process-wide pool of the linear memories of the wasm executions. Each memory reserves the whole
+     * address range of a module with guard pages, mapping it for every action and unmapping it after
+     * costs the syscalls, the tlb flush and the faults of the fresh pages. A memory comes back reset,
+     * its pages given back to the kernel, so an idle memory keeps no page resident.
+     */
+    class wasm_memory_pool {
+    public:
+        static wasm_memory_pool &instance();
+
+        ~wasm_memory_pool();
+
+        eosio::vm::wasm_allocator *acquire();
+        void release(eosio::vm::wasm_allocator *p_alloc);
+
+        size_t idle_size();
+
+    private:
+        wasm_memory_pool() {}
+        wasm_memory_pool(const wasm_memory_pool &) = delete;
+        wasm_memory_pool &operator=(const wasm_memory_pool &) = delete;
+
+        std::mutex                               _mutex;
+        std::vector<eosio::vm::wasm_allocator *> _idle;
+    };
+
+    // the linear memory of a wasm context, taken from the pool at the first use
+    class wasm_memory {
+    public:
+        wasm_memory() {}
+        ~wasm_memory() {
+            if (_p_alloc) wasm_memory_pool::instance().release(_p_alloc);
+        }
+
+        eosio::vm::wasm_allocator *get() {
+            if (!_p_alloc) _p_alloc = wasm_memory_pool::instance().acquire();
+            return _p_alloc;
+        }
+
+        bool is_in_range(const char *p) const { return _p_alloc && _p_alloc->is_in_range(p); }
+
+    private:
+        wasm_memory(const wasm_memory &) = delete;
+        wasm_memory &operator=(const wasm_memory &) = delete;
+
+        eosio::vm::wasm_allocator *_p_alloc = nullptr;
+    };
+
+} //wasm
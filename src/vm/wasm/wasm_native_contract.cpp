@@ -54,6 +54,8 @@ namespace wasm {
         WASM_ASSERT(database_contract.SaveContract(contract.regid, contract_store), 
                     account_operation_exception,
                     "%s","wasmio_native_setcode.setcode, Save account error")
+
+        wasm_code_cache::instance().erase(contract.regid);
     }
     
     void wasmio_bank_native_transfer(wasm_context &context) {
@@ -21,14 +21,18 @@ namespace wasm { namespace rpc{
     )=====";
 
     const char *submit_wasm_contract_call_tx_rpc_help_message = R"=====(
-        submitwasmcontractcalltx "sender" "contract" "action" "data" "fee"
+        submitwasmcontractcalltx "sender" "contract" "action" "data" "fee" profile
         1."sender ":         (string, required) sender name
         2."contract":        (string, required) contract name
         3."action":          (string, required) action name
         4."data":            (json string, required) action data
         5."symbol:fee:unit": (numeric, optional) pay to miner
+        6."profile":         (bool, optional) execute the tx against the tip without submitting it, and
+                             return the fuel and time of its actions, receivers and host calls, default false
         Result:
         "txid":       (string)
+        "run_steps":  (numeric, profile only) fuel of the tx
+        "profile":    (object, profile only) folded stacks of the fuel and the time in us
         Examples: 
         > ./coind submitwasmcontractcalltx "xiaoyu111111" "walker222222" "transfer" '["xiaoyu111111", "walker222222", "100000000 WICC","transfer to walker222222"]'
         As json rpc call 
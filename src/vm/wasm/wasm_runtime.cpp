@@ -1,7 +1,7 @@
 #pragma GCC diagnostic ignored "-Wunused-variable"
 
 #include"wasm/wasm_runtime.hpp"
-#include"eosio/vm/watchdog.hpp"
+#include"wasm/wasm_watchdog.hpp"
 #include"wasm/wasm_log.hpp"
 //#include"wasm_context.hpp"
 
@@ -49,7 +49,7 @@ namespace wasm {
                         pContext->action());
             };
             try {
-                watchdog wd(pContext->get_max_transaction_duration());
+                wasm_watchdog wd(pContext->get_max_transaction_duration());
                 _runtime->_bkend->timed_run(wd, fn);
             } catch (vm::timeout_exception &) {
                 //pContext->trx_pContext->checktime();
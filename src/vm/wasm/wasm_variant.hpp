@@ -65,13 +65,17 @@ namespace wasm {
 
     template<typename T>
     static inline string ToHex( const T &t, string separator = " " ) {
-        const std::string hex = "0123456789abcdef";
-        std::ostringstream o;
-
-        for (std::string::size_type i = 0; i < t.size(); ++i)
-            o << hex[(unsigned char) t[i] >> 4] << hex[(unsigned char) t[i] & 0xf] << separator;
+        static const char hex[] = "0123456789abcdef";
+        string o;
+        o.reserve(t.size() * (2 + separator.size()));
+
+        for (std::string::size_type i = 0; i < t.size(); ++i) {
+            o.push_back(hex[(unsigned char) t[i] >> 4]);
+            o.push_back(hex[(unsigned char) t[i] & 0xf]);
+            o.append(separator);
+        }
 
-        return o.str();
+        return o;
 
     }
 
@@ -193,13 +197,14 @@ namespace wasm {
     static inline void to_variant( const std::vector <T> &ts, wasm::variant &v ) {
 
         wasm::array var;
+        var.reserve(ts.size());
         for (const T &t: ts) {
             wasm::variant tmp;
             to_variant(t, tmp);
-            var.push_back(tmp);
+            var.push_back(std::move(tmp));
         }
 
-        v = var;
+        v = std::move(var);
     }
 
     template<typename T>
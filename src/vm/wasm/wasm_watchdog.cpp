@@ -0,0 +1,73 @@
+#include "wasm/wasm_watchdog.hpp"
+
+namespace wasm {
+
+    wasm_timer_scheduler &wasm_timer_scheduler::instance() {
+        static wasm_timer_scheduler scheduler;
+        return scheduler;
+    }
+
+    wasm_timer_scheduler::~wasm_timer_scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _cond.notify_one();
+        if (_thread.joinable())
+            _thread.join();
+    }
+
+    wasm_timer_scheduler::timer_id wasm_timer_scheduler::schedule(clock_type::time_point deadline,
+                                                                  std::function<void()> callback) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        // started by the first execution, nodes which never run wasm pay nothing
+        if (!_thread.joinable())
+            _thread = std::thread(&wasm_timer_scheduler::run, this);
+
+        timer_id id(deadline, _next_seq++);
+        bool earliest = _timers.empty() || id < _timers.begin()->first;
+        _timers.emplace(id, std::move(callback));
+        lock.unlock();
+
+        if (earliest)
+            _cond.notify_one();
+        return id;
+    }
+
+    void wasm_timer_scheduler::cancel(const timer_id &id) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_timers.erase(id) > 0)
+            return;
+
+        // fired already, the callback must not outlive the execution it interrupts
+        _fired_cond.wait(lock, [&]() { return _running_seq != id.second; });
+    }
+
+    void wasm_timer_scheduler::run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!_stopping) {
+            if (_timers.empty()) {
+                _cond.wait(lock);
+                continue;
+            }
+
+            auto it = _timers.begin();
+            if (clock_type::now() < it->first.first) {
+                _cond.wait_until(lock, it->first.first);
+                continue;
+            }
+
+            auto callback = std::move(it->second);
+            _running_seq  = it->first.second;
+            _timers.erase(it);
+
+            lock.unlock();
+            callback();
+            lock.lock();
+
+            _running_seq = 0;
+            _fired_cond.notify_all();
+        }
+    }
+
+} //wasm
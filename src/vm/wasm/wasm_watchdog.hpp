@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace wasm {
+
+    /**
+     * One long-lived thread which fires the deadlines of all the running wasm executions, instead of
+     * a thread spawned and joined for each action. The deadlines are kept ordered, there are only as
+     * many as the executions running at the same time.
+     */
+    class wasm_timer_scheduler {
+    public:
+        using clock_type = std::chrono::steady_clock;
+        using timer_id   = std::pair<clock_type::time_point, uint64_t>;
+
+        static wasm_timer_scheduler &instance();
+
+        ~wasm_timer_scheduler();
+
+        // the callback is run on the scheduler thread once the deadline passes, unless canceled
+        timer_id schedule(clock_type::time_point deadline, std::function<void()> callback);
+
+        // when the callback is running, wait until it returns
+        void cancel(const timer_id &id);
+
+    private:
+        wasm_timer_scheduler() {}
+        wasm_timer_scheduler(const wasm_timer_scheduler &) = delete;
+        wasm_timer_scheduler &operator=(const wasm_timer_scheduler &) = delete;
+
+        void run();
+
+        std::mutex                                 _mutex;
+        std::condition_variable                    _cond;
+        std::condition_variable                    _fired_cond;
+        std::map<timer_id, std::function<void()>> _timers;
+        uint64_t                                   _next_seq    = 1;
+        uint64_t                                   _running_seq = 0;
+        bool                                       _stopping    = false;
+        std::thread                                _thread;
+    };
+
+    /// \brief Drop-in replacement of eosio::vm::watchdog served by the shared scheduler thread.
+    class wasm_watchdog {
+        class guard;
+    public:
+        template <typename TimeUnits>
+        explicit wasm_watchdog(const TimeUnits &duration) : _duration(duration) {}
+
+        template <typename F>
+        [[nodiscard]] guard scoped_run(F &&callback) {
+            return guard(wasm_timer_scheduler::clock_type::now() + _duration, static_cast<F &&>(callback));
+        }
+
+    private:
+        class guard {
+        public:
+            guard(const guard &) = delete;
+            guard &operator=(const guard &) = delete;
+
+            template <typename F>
+            guard(wasm_timer_scheduler::clock_type::time_point deadline, F &&callback)
+                : _id(wasm_timer_scheduler::instance().schedule(deadline, static_cast<F &&>(callback))) {}
+
+            ~guard() { wasm_timer_scheduler::instance().cancel(_id); }
+
+        private:
+            wasm_timer_scheduler::timer_id _id;
+        };
+
+        wasm_timer_scheduler::clock_type::duration _duration;
+    };
+
+} //wasm